@@ -30,5 +30,11 @@ private:
 	__type const& __class::__name() const & { return                     (__class::__name ## _) ; }                    \
 	__type &&     __class::__name() &&      { return std::forward<__type>(__class::__name ## _); }
 
+/* Distributes iterations of the following for loop among OpenMP threads if OpenMP has been enabled during build */
+#ifdef _OPENMP
+	#define HBRS_THETA_UTILS_OMP_PARALLEL_FOR _Pragma("omp parallel for")
+#else
+	#define HBRS_THETA_UTILS_OMP_PARALLEL_FOR
+#endif
 
 #endif // !HBRS_THETA_UTILS_CORE_PREPROCESSOR_FWD_HPP
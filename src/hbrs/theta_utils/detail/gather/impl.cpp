@@ -27,13 +27,13 @@
 #include <hbrs/mpl/fn/less_equal.hpp>
 #include <hbrs/mpl/fn/greater_equal.hpp>
 
-#include <hbrs/theta_utils/detail/iff.hpp>
 #include <hbrs/mpl/detail/mpi.hpp>
 #include <hbrs/mpl/detail/log.hpp>
 
 #include <boost/numeric/conversion/cast.hpp>
 #include <boost/assert.hpp>
 #include <algorithm>
+#include <numeric>
 
 HBRS_THETA_UTILS_NAMESPACE_BEGIN
 namespace mpi = hbrs::mpl::detail::mpi;
@@ -89,130 +89,60 @@ gather(
 	size_t gbl_m = lcl_ms_sums.back();
 	HBRS_MPL_LOG_TRIVIAL(trace) << "gbl_m:" << gbl_m << "@mpi_rank:" << mpi_rank;
 	
-	size_t balanced_chunk_size = gbl_m / mpi_sz; // integer division
-	size_t nr_of_bigger_chunks = gbl_m % mpi_sz; // number of processes that get chunks of size=chunk_size+1
-	size_t nr_of_normal_chunks = mpi_sz - nr_of_bigger_chunks;
-	BOOST_ASSERT((nr_of_bigger_chunks+nr_of_normal_chunks) == mpi_sz);
+	El::DistMatrix<double, El::VC, El::STAR, El::ELEMENT> const& gbl_from = from.data();
+	El::Matrix<double> const& lcl_from = gbl_from.LockedMatrix();
+	// round robin distribution, i.e. local row k of process p is global row k*mpi_sz+p
+	BOOST_ASSERT(gbl_from.ColShift() == (El::Int)mpi_rank);
+	BOOST_ASSERT(gbl_from.ColStride() == (El::Int)mpi_sz);
 	
-	std::vector<size_t> bal_lcl_ms(mpi_sz, 0u);
-	for(size_t i = 0; i < nr_of_bigger_chunks; ++i) {
-		bal_lcl_ms.at(i) = balanced_chunk_size+1;
-	}
-	for(size_t i = nr_of_bigger_chunks; i < mpi_sz; ++i) {
-		bal_lcl_ms.at(i) = balanced_chunk_size;
+	/* Reverse of scatter(theta_field_matrix, theta_field_distribution_1): process p receives all rows within
+	 * [lcl_ms_sums[p]-lcl_ms[p], lcl_ms_sums[p]). Owners of local rows increase with local rows, so local rows in their
+	 * original order are already grouped by destination.
+	 */
+	size_t const first_row = lcl_ms_sums.at(mpi_rank) - lcl_m;
+	std::vector<size_t> send_counts(mpi_sz, 0u), recv_counts(mpi_sz, 0u);
+	for(size_t p = 0; p < mpi_sz; ++p) {
+		send_counts[p] = round_robin_count(lcl_ms_sums[p] - lcl_ms[p], lcl_ms_sums[p], mpi_rank, mpi_sz);
+		recv_counts[p] = round_robin_count(first_row, first_row + lcl_m, p, mpi_sz);
 	}
-	std::vector<size_t> bal_lcl_ms_sums(mpi_sz, 0u);
-	std::partial_sum(bal_lcl_ms.begin(), bal_lcl_ms.end(), bal_lcl_ms_sums.begin());
-	
-	HBRS_MPL_LOG_TRIVIAL(trace) << "bal_lcl_ms:" << loggable{bal_lcl_ms} << "@mpi_rank:" << mpi_rank;
-	HBRS_MPL_LOG_TRIVIAL(trace) << "bal_lcl_ms_sums:" << loggable{bal_lcl_ms_sums} << "@mpi_rank:" << mpi_rank;
-	
-	size_t bal_lcl_m = bal_lcl_ms.at(mpi_rank);
-	mpl::rtsam<double, mpl::storage_order::row_major> bal_lcl_from =
-		{ mpl::make_matrix_size(bal_lcl_m, lcl_n) };
+	HBRS_MPL_LOG_TRIVIAL(trace) << "send_counts:" << loggable{send_counts} << "@mpi_rank:" << mpi_rank;
+	HBRS_MPL_LOG_TRIVIAL(trace) << "recv_counts:" << loggable{recv_counts} << "@mpi_rank:" << mpi_rank;
 	
-	El::DistMatrix<double, El::VC, El::STAR, El::ELEMENT> const& gbl_from = from.data();
+	size_t const lcl_from_m = boost::numeric_cast<size_t>(lcl_from.Height());
+	std::vector<double> send(lcl_from_m * lcl_n);
+	for(size_t j = 0; j < lcl_n; ++j) {
+		double const* col = lcl_from.LockedBuffer(0, (El::Int)j);
+		for(size_t k = 0; k < lcl_from_m; ++k) {
+			send[k * lcl_n + j] = col[k];
+		}
+	}
 	
-	BOOST_ASSERT(gbl_from.LockedMatrix().Height() == bal_lcl_from.size().m());
-	BOOST_ASSERT(gbl_from.LockedMatrix().Width() == bal_lcl_from.size().n());
+	std::vector<double> recv = alltoallv_rows(send, send_counts, recv_counts, lcl_n, MPI_COMM_WORLD);
+	BOOST_ASSERT(recv.size() == lcl_m * lcl_n);
 	
-	for(size_t gbl_row = 0; gbl_row<gbl_m; ++gbl_row) {
-		size_t lcl_row = gbl_row / mpi_sz;
-		bool is_lcl_row = ((gbl_row % mpi_sz) == mpi_rank);
-		BOOST_ASSERT(iff(is_lcl_row, gbl_from.IsLocalRow(gbl_row)));
-		
-		if (is_lcl_row) {
-			HBRS_MPL_LOG_TRIVIAL(trace) << "lcl_row:" << lcl_row << "@mpi_rank:" << mpi_rank;
-			
-			for(size_t col = 0; col < lcl_n; ++col) {
-				BOOST_ASSERT(gbl_from.IsLocal(gbl_row, col));
-				
-				bal_lcl_from.at(mpl::make_matrix_index(lcl_row, col)) = 
-					gbl_from.GetLocal(
-						gbl_from.LocalRow((El::Int)gbl_row),
-						gbl_from.LocalCol((El::Int)col)
-					);
-			}
+	// local row for each row of the receive buffer, rows from process p are global rows with gbl_row % mpi_sz == p
+	std::vector<size_t> lcl_rows;
+	lcl_rows.reserve(lcl_m);
+	for(size_t p = 0; p < mpi_sz; ++p) {
+		size_t const first_of_p = first_row + (p + mpi_sz - first_row % mpi_sz) % mpi_sz;
+		for(size_t k = 0; k < recv_counts[p]; ++k) {
+			lcl_rows.push_back(first_of_p + k * mpi_sz - first_row);
 		}
 	}
+	BOOST_ASSERT(lcl_rows.size() == lcl_m);
 	
-
-	{
-		mpl::rtsam<double, mpl::storage_order::row_major> lcl_to {lcl_sz};
-		
-		std::vector<MPI_Request> reqs;
-		for(size_t gbl_row = 0; gbl_row<gbl_m; ++gbl_row) {
-			size_t recv_proc = std::distance(
-				lcl_ms_sums.begin(),
-				std::lower_bound(lcl_ms_sums.begin(), lcl_ms_sums.end(), gbl_row+1)
-			);
-			
-			// block distribution
-// 			size_t recv_proc = std::distance(
-// 				bal_lcl_ms_sums.begin(),
-// 				std::lower_bound(bal_lcl_ms_sums.begin(), bal_lcl_ms_sums.end(), gbl_row)
-// 			);
-			// round robin distribution
-			size_t send_proc = gbl_row % mpi_sz;
-			
-			
-			size_t lcl_recv_row = (recv_proc == 0) ? gbl_row : (gbl_row - lcl_ms_sums.at(recv_proc-1));
-			// block distribution
-// 			size_t lcl_send_row = (send_proc == 0) ? gbl_row : (gbl_row - bal_lcl_ms_sums.at(send_proc-1));
-			// round robin distribution
-			size_t lcl_send_row = gbl_row / mpi_sz;
-			
-			HBRS_MPL_LOG_TRIVIAL(trace) << "gbl_row:" << gbl_row << ",send_proc:" << send_proc << ",recv_proc:" << recv_proc << "@mpi_rank:" << mpi_rank;
-			HBRS_MPL_LOG_TRIVIAL(trace) << "gbl_row:" << gbl_row << ",lcl_send_row:" << lcl_send_row << ",lcl_recv_row:" << lcl_recv_row << "@mpi_rank:" << mpi_rank;
-			
-			if ((send_proc == recv_proc) && (send_proc == mpi_rank)) {
-				HBRS_MPL_LOG_TRIVIAL(trace) << "gbl_row:" << gbl_row << ", COPY" << "@mpi_rank:" << mpi_rank;
-				
-				double       & lcl_recv_ref = lcl_to.at(mpl::make_matrix_index(lcl_recv_row, 0));
-				double const & lcl_send_ref = bal_lcl_from.at(mpl::make_matrix_index(lcl_send_row, 0));
-				std::copy_n(&lcl_send_ref, lcl_n, &lcl_recv_ref);
-				
-			} else if (send_proc == mpi_rank) {
-				HBRS_MPL_LOG_TRIVIAL(trace) << "gbl_row:" << gbl_row << ", SEND_ROW" << "@mpi_rank:" << mpi_rank;
-				
-				double const& lcl_send_ref = bal_lcl_from.at(mpl::make_matrix_index(lcl_send_row, 0));
-				reqs.push_back(
-					mpi::isend(
-						&lcl_send_ref,
-						lcl_n,
-						recv_proc /*dest*/,
-						send_proc /*tag*/,
-						MPI_COMM_WORLD
-					)
-				);
-			} else if (recv_proc == mpi_rank) {
-				HBRS_MPL_LOG_TRIVIAL(trace) << "gbl_row:" << gbl_row << ", RECV_ROW" << "@mpi_rank:" << mpi_rank;
-				
-				double & lcl_recv_ref = lcl_to.at(mpl::make_matrix_index(lcl_recv_row, 0));
-				
-				reqs.push_back(
-					mpi::irecv(
-						&lcl_recv_ref,
-						lcl_n,
-						send_proc /*source*/,
-						send_proc /*tag*/,
-						MPI_COMM_WORLD
-					)
-				);
-			} else {
-				HBRS_MPL_LOG_TRIVIAL(trace) << "gbl_row:" << gbl_row << ", SKIP" << "@mpi_rank:" << mpi_rank;
-			}
+	size_t const no_of_points = lcl_m/3;
+	for(size_t r = 0; r < lcl_m; ++r) {
+		size_t const i = lcl_rows[r];
+		std::size_t const point = i % no_of_points;
+		for(size_t j = 0; j < lcl_n; ++j) {
+			theta_field & field = to.data().at(j);
+			std::vector<double> & velocity =
+				(i < no_of_points)
+					? field.x_velocity()
+					: (i < 2*no_of_points) ? field.y_velocity() : field.z_velocity();
+			velocity[point] = recv[r * lcl_n + j];
 		}
-		
-		for(size_t i = 0; i < reqs.size(); ++i) {
-			HBRS_MPL_LOG_TRIVIAL(trace) << "reqs[" << i << "], WAIT_BEGIN" << "@mpi_rank:" << mpi_rank;
-			
-			[[maybe_unused]] auto stat = mpi::wait(reqs[i]);
-			//TODO: Do anything with stat?
-			HBRS_MPL_LOG_TRIVIAL(trace) << "reqs[" << i << "], WAIT_END" << "@mpi_rank:" << mpi_rank;
-		}
-		
-		to = copy_matrix(lcl_to, to);
 	}
 	
 	HBRS_MPL_LOG_TRIVIAL(trace) << "DONE@mpi_rank:" << mpi_rank;
@@ -257,6 +187,90 @@ gather(
 	
 	return to;
 }
+
+HBRS_THETA_UTILS_API
+theta_field_matrix
+gather(
+	mpl::el_dist_matrix<
+		double, El::VC, El::STAR, El::ELEMENT
+	> const& from,
+	gather_control<
+		theta_field_distribution_3,
+		mpl::matrix_size<std::size_t, std::size_t>
+	> const& ctrl
+) {
+	theta_field_distribution_3 const& dist = ctrl.algorithm;
+	
+	theta_field_matrix to{ctrl.local_size};
+	{
+		auto mpi_sz = mpi::comm_size();
+		for(theta_field & field : to.data()) {
+			field.ndomains() = mpi_sz;
+		}
+	}
+	
+	mpl::matrix_size<size_t, size_t> lcl_sz = to.size();
+	size_t mpi_rank = boost::numeric_cast<size_t>(mpi::comm_rank());
+	El::Matrix<double> const& from_lcl = from.data().LockedMatrix();
+	
+	BOOST_ASSERT(from.size().n() == lcl_sz.n());
+	BOOST_ASSERT((size_t)from.data().Height() == distributed_size(lcl_sz, dist).m());
+	BOOST_ASSERT(lcl_sz.m() == dist.domain_ms.at(mpi_rank));
+	BOOST_ASSERT(dist.local_ms.at(mpi_rank) == (size_t)from_lcl.Height());
+	
+	// reverse of scatter(..., scatter_control<theta_field_distribution_3>), i.e. surplus rows are sent back home
+	size_t const kept = std::min(lcl_sz.m(), (size_t)from_lcl.Height());
+	std::vector<double> send(((size_t)from_lcl.Height() - kept) * lcl_sz.n());
+	for(size_t j = 0; j < lcl_sz.n(); ++j) {
+		double const* col = from_lcl.LockedBuffer(0, (El::Int)j);
+		for(size_t i = kept; i < (size_t)from_lcl.Height(); ++i) {
+			send[(i - kept) * lcl_sz.n() + j] = col[i];
+		}
+	}
+	
+	std::vector<double> recv = alltoallv_rows(send, dist.recv_counts, dist.send_counts, lcl_sz.n(), MPI_COMM_WORLD);
+	BOOST_ASSERT(recv.size() == (lcl_sz.m() - kept) * lcl_sz.n());
+	
+	mpl::el_matrix<double> to_lcl{ (El::Int)lcl_sz.m(), (El::Int)lcl_sz.n() };
+	decltype(auto) to_lcl_kept = to_lcl.data()(El::IR(0, kept), El::ALL);
+	El::Copy(from_lcl(El::IR(0, kept), El::ALL), to_lcl_kept);
+	for(size_t j = 0; j < lcl_sz.n(); ++j) {
+		double * col = to_lcl.data().Buffer(0, (El::Int)j);
+		for(size_t i = kept; i < lcl_sz.m(); ++i) {
+			col[i] = recv[(i - kept) * lcl_sz.n() + j];
+		}
+	}
+	
+	copy_matrix(to_lcl, to);
+	
+	return to;
+}
+
+HBRS_THETA_UTILS_API
+theta_field_matrix
+gather(
+	mpl::el_dist_matrix<
+		double, El::MC, El::MR, El::ELEMENT
+	> const& from,
+	gather_control<
+		theta_field_distribution_4,
+		mpl::matrix_size<std::size_t, std::size_t>
+	> const& ctrl
+) {
+	// rows are ordered like with theta_field_distribution_1, so after Elemental has redistributed the columns the rows
+	// are returned to their domains with gather() for theta_field_distribution_1
+	mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT> from_vc_star{
+		El::DistMatrix<double, El::VC, El::STAR, El::ELEMENT>{from.data()}
+	};
+	
+	return gather(
+		from_vc_star,
+		gather_control<
+			theta_field_distribution_1,
+			mpl::matrix_size<std::size_t, std::size_t>
+		>{{}, ctrl.local_size}
+	);
+}
 #endif // !HBRS_MPL_ENABLE_ELEMENTAL
 
 /* namespace detail */ }
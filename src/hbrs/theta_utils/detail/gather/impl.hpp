@@ -64,6 +64,30 @@ gather(
 		mpl::matrix_size<std::size_t, std::size_t>
 	> const& ctrl
 );
+
+HBRS_THETA_UTILS_API
+theta_field_matrix
+gather(
+	mpl::el_dist_matrix<
+		double, El::VC, El::STAR, El::ELEMENT
+	> const& from,
+	gather_control<
+		theta_field_distribution_3,
+		mpl::matrix_size<std::size_t, std::size_t>
+	> const& ctrl
+);
+
+HBRS_THETA_UTILS_API
+theta_field_matrix
+gather(
+	mpl::el_dist_matrix<
+		double, El::MC, El::MR, El::ELEMENT
+	> const& from,
+	gather_control<
+		theta_field_distribution_4,
+		mpl::matrix_size<std::size_t, std::size_t>
+	> const& ctrl
+);
 #endif // !HBRS_MPL_ENABLE_ELEMENTAL
 
 /* namespace detail */ }
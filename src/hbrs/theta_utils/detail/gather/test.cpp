@@ -44,6 +44,8 @@
 #include <hbrs/theta_utils/detail/test.hpp>
 
 #include <hbrs/theta_utils/dt/theta_field_matrix.hpp>
+#include <hbrs/theta_utils/dt/theta_field.hpp>
+#include <hbrs/mpl/dt/rtsam.hpp>
 
 
 #include <boost/hana/filter.hpp>
@@ -274,4 +276,158 @@ BOOST_AUTO_TEST_CASE(gather_,
 	});
 }
 
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+BOOST_AUTO_TEST_CASE(scatter_paths,
+	* utf::precondition(hbrs::theta_utils::detail::mpi_world_size_condition{{0,5}})
+	* utf::tolerance(_TOL)
+) {
+	using namespace hbrs::mpl;
+	namespace detail = hbrs::theta_utils::detail;
+	namespace mpi = hbrs::mpl::detail::mpi;
+	using namespace hbrs::theta_utils;
+	
+	detail::io_fixture fx{"scatter_paths"};
+	BOOST_TEST_MESSAGE("Working directory: " << fx.wd().path().string());
+	
+	// differently-sized domains, so that distribution 2 has to pad some local matrices with zeros
+	std::size_t const rank = boost::numeric_cast<std::size_t>(mpi::comm_rank());
+	std::size_t const m = 3 * (rank + 1);
+	std::size_t const n = 4;
+	rtsam<double, storage_order::row_major> local{make_matrix_size(m, n)};
+	for(std::size_t i = 0; i < m; ++i) {
+		for(std::size_t j = 0; j < n; ++j) {
+			local.at(make_matrix_index(i, j)) = 100. * rank + 10. * i + j;
+		}
+	}
+	
+	theta_field_matrix series = make_theta_field_matrix(local);
+	auto paths = detail::make_theta_field_paths(
+		fx.wd().path(), fx.prefix(), series, theta_field_path::naming_scheme::theta
+	);
+	
+	std::vector< std::tuple<theta_field, theta_field_path> > fields;
+	for(std::size_t j = 0; j < paths.size(); ++j) {
+		fields.push_back({series.data().at(j), paths.at(j)});
+	}
+	write_theta_fields(fields, false);
+	
+	auto ref = detail::scatter(series, detail::scatter_control<detail::theta_field_distribution_2>{{}});
+	auto got = detail::scatter(paths, detail::scatter_control<detail::theta_field_distribution_2>{{}});
+	HBRS_MPL_TEST_MMEQ(ref, got, false);
+}
+
+BOOST_AUTO_TEST_CASE(distribution_3,
+	* utf::precondition(hbrs::theta_utils::detail::mpi_world_size_condition{{0,5}})
+	* utf::tolerance(_TOL)
+) {
+	using namespace hbrs::mpl;
+	namespace detail = hbrs::theta_utils::detail;
+	namespace mpi = hbrs::mpl::detail::mpi;
+	using namespace hbrs::theta_utils;
+	
+	detail::io_fixture fx{"distribution_3"};
+	BOOST_TEST_MESSAGE("Working directory: " << fx.wd().path().string());
+	
+	// differently-sized domains, so that rows have to be moved from larger to smaller domains
+	std::size_t const rank = boost::numeric_cast<std::size_t>(mpi::comm_rank());
+	std::size_t const m = 3 * (rank + 1);
+	std::size_t const n = 4;
+	rtsam<double, storage_order::row_major> local{make_matrix_size(m, n)};
+	for(std::size_t i = 0; i < m; ++i) {
+		for(std::size_t j = 0; j < n; ++j) {
+			local.at(make_matrix_index(i, j)) = 100. * rank + 10. * i + j;
+		}
+	}
+	
+	theta_field_matrix series = make_theta_field_matrix(local);
+	auto dist = detail::make_theta_field_distribution_3(series.size());
+	
+	std::size_t gbl_m = 0;
+	for(std::size_t p = 0; p < boost::numeric_cast<std::size_t>(mpi::comm_size()); ++p) {
+		gbl_m += 3 * (p + 1);
+	}
+	
+	auto dist_vc_star = detail::scatter(series, detail::scatter_control<detail::theta_field_distribution_3>{dist});
+	BOOST_TEST(boost::numeric_cast<std::size_t>(dist_vc_star.data().Height()) == gbl_m);
+	
+	auto paths = detail::make_theta_field_paths(
+		fx.wd().path(), fx.prefix(), series, theta_field_path::naming_scheme::theta
+	);
+	
+	std::vector< std::tuple<theta_field, theta_field_path> > fields;
+	for(std::size_t j = 0; j < paths.size(); ++j) {
+		fields.push_back({series.data().at(j), paths.at(j)});
+	}
+	write_theta_fields(fields, false);
+	
+	auto got = detail::scatter(paths, detail::scatter_control<detail::theta_field_distribution_3>{dist});
+	HBRS_MPL_TEST_MMEQ(dist_vc_star, got, false);
+	
+	theta_field_matrix gathered = detail::gather(
+		dist_vc_star,
+		detail::gather_control<
+			detail::theta_field_distribution_3,
+			matrix_size<std::size_t, std::size_t>
+		>{dist, series.size()}
+	);
+	el_matrix<double> ref = detail::copy_matrix(
+		series, make_el_matrix(hana::type_c<double>, matrix_size<El::Int, El::Int>{ series.size() }));
+	el_matrix<double> rev = detail::copy_matrix(
+		gathered, make_el_matrix(hana::type_c<double>, matrix_size<El::Int, El::Int>{ gathered.size() }));
+	HBRS_MPL_TEST_MMEQ(ref, rev, false);
+}
+
+BOOST_AUTO_TEST_CASE(distribution_4,
+	* utf::precondition(hbrs::theta_utils::detail::mpi_world_size_condition{{0,5}})
+	* utf::tolerance(_TOL)
+) {
+	using namespace hbrs::mpl;
+	namespace detail = hbrs::theta_utils::detail;
+	namespace mpi = hbrs::mpl::detail::mpi;
+	using namespace hbrs::theta_utils;
+	
+	std::size_t const rank = boost::numeric_cast<std::size_t>(mpi::comm_rank());
+	std::size_t const m = 3 * (rank + 1);
+	std::size_t const n = 5;
+	rtsam<double, storage_order::row_major> local{make_matrix_size(m, n)};
+	for(std::size_t i = 0; i < m; ++i) {
+		for(std::size_t j = 0; j < n; ++j) {
+			local.at(make_matrix_index(i, j)) = 100. * rank + 10. * i + j;
+		}
+	}
+	theta_field_matrix series = make_theta_field_matrix(local);
+	
+	// all grid shapes, e.g. 1x4, 2x2 and 4x1 for 4 processes
+	std::size_t const mpi_sz = boost::numeric_cast<std::size_t>(mpi::comm_size());
+	for(std::size_t height = 1; height <= mpi_sz; ++height) {
+		if (mpi_sz % height != 0) {
+			continue;
+		}
+		BOOST_TEST_MESSAGE("grid_height=" << height);
+		
+		auto grid = detail::make_process_grid(height);
+		auto dist_mc_mr = detail::scatter(series, detail::scatter_control<detail::theta_field_distribution_4>{{grid}});
+		
+		// same global matrix as with distribution 1
+		auto dist_vc_star = detail::scatter(series, detail::scatter_control<detail::theta_field_distribution_1>{{}});
+		el_dist_matrix<double, El::MC, El::MR> ref{El::DistMatrix<double>{*grid}};
+		El::Copy(dist_vc_star.data(), ref.data());
+		HBRS_MPL_TEST_MMEQ(ref, dist_mc_mr, false);
+		
+		theta_field_matrix gathered = detail::gather(
+			dist_mc_mr,
+			detail::gather_control<
+				detail::theta_field_distribution_4,
+				matrix_size<std::size_t, std::size_t>
+			>{{grid}, series.size()}
+		);
+		el_matrix<double> expected = detail::copy_matrix(
+			series, make_el_matrix(hana::type_c<double>, matrix_size<El::Int, El::Int>{ series.size() }));
+		el_matrix<double> got = detail::copy_matrix(
+			gathered, make_el_matrix(hana::type_c<double>, matrix_size<El::Int, El::Int>{ gathered.size() }));
+		HBRS_MPL_TEST_MMEQ(expected, got, false);
+	}
+}
+#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+
 BOOST_AUTO_TEST_SUITE_END()
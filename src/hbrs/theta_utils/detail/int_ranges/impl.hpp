@@ -20,6 +20,10 @@
 #include "fwd.hpp"
 
 #include <hbrs/theta_utils/config.hpp>
+#include <hbrs/theta_utils/dt/exception.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
 #include <boost/spirit/include/qi.hpp>
 #include <boost/fusion/include/std_pair.hpp>
 #include <boost/spirit/include/qi.hpp>
@@ -31,6 +35,8 @@
 #include <boost/range/algorithm.hpp>
 #include <boost/range/irange.hpp>
 #include <vector>
+#include <string>
+#include <limits>
 #include <algorithm>
 
 HBRS_THETA_UTILS_NAMESPACE_BEGIN
@@ -140,6 +146,53 @@ in_int_ranges(int_ranges<Integer> const& s, Integer const& val) {
 	return false;
 }
 
+/* Parses a sequence of selections such as {"0-2,6-8", "first", "1-last", "none"}. Keywords first and last denote the
+ * smallest and largest number respectively, none denotes an empty selection and an empty sequence selects all numbers.
+ */
+template <typename Integer>
+std::vector<int_ranges<Integer>>
+parse_int_ranges_sequence(std::vector<std::string> const& rngs_seq) {
+	static constexpr Integer min = 0;
+	/* number ranges are half-open ranges and thus max-1 is the maximum value of numbers */
+	static constexpr Integer max = std::numeric_limits<Integer>::max()-1;
+	
+	if (rngs_seq.empty()) {
+		return { int_ranges<Integer>{ int_range<Integer>{min, max} } };
+	}
+	
+	std::vector<int_ranges<Integer>> nr_rngs_seq;
+	nr_rngs_seq.reserve(rngs_seq.size());
+	
+	for(auto rngs : rngs_seq) {
+		if (boost::equals(rngs, "none")) {
+			nr_rngs_seq.push_back(int_ranges<Integer>{ int_range<Integer>{0, 0} });
+			continue;
+		}
+		
+		boost::replace_all(rngs, "first", boost::lexical_cast<std::string>(min));
+		boost::replace_all(rngs, "last", boost::lexical_cast<std::string>(max));
+		int_ranges<Integer> nr_rngs;
+		bool valid = parse_int_ranges(rngs.begin(), rngs.end(), nr_rngs);
+		
+		if (valid) {
+			for(auto & nr_rng : nr_rngs) {
+				if (nr_rng.empty() || (nr_rng.front() < min)) {
+					valid = false;
+					break;
+				}
+			}
+		}
+		
+		if (!valid) {
+			BOOST_THROW_EXCEPTION(invalid_number_range_spec_exception{} << errinfo_number_range_spec{rngs});
+		}
+		
+		nr_rngs_seq.push_back(nr_rngs);
+	}
+	
+	return nr_rngs_seq;
+}
+
 /* namespace detail */ }
 HBRS_THETA_UTILS_NAMESPACE_END
 
@@ -91,4 +91,39 @@ BOOST_AUTO_TEST_CASE(read) {
 	}
 }
 
+BOOST_AUTO_TEST_CASE(read_sequence) {
+	using namespace hbrs::theta_utils;
+	using namespace hbrs::theta_utils::detail;
+	
+	auto all = parse_int_ranges_sequence<std::size_t>({});
+	BOOST_TEST_REQUIRE(all.size() == 1u);
+	BOOST_TEST(in_int_ranges(all[0], 0ul));
+	BOOST_TEST(in_int_ranges(all[0], std::numeric_limits<std::size_t>::max()-2));
+	
+	auto seqs = parse_int_ranges_sequence<std::size_t>({"first", "1-3,7", "5-last", "none"});
+	BOOST_TEST_REQUIRE(seqs.size() == 4u);
+	
+	std::vector<std::vector<std::size_t>> ref_seqs {
+		{0},
+		{1,2,3,7},
+		{5,6,7,8,9,10},
+		{}
+	};
+	
+	std::vector<std::vector<std::size_t>> got_seqs;
+	for(auto const& seq : seqs) {
+		std::vector<std::size_t> got_seq;
+		for(std::size_t i = 0; i < 11; ++i) {
+			if (in_int_ranges(seq, i)) {
+				got_seq.push_back(i);
+			}
+		}
+		got_seqs.push_back(got_seq);
+	}
+	
+	BOOST_TEST(ref_seqs == got_seqs);
+	
+	BOOST_CHECK_THROW(parse_int_ranges_sequence<std::size_t>({"a"}), invalid_number_range_spec_exception);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
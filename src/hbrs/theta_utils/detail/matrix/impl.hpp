@@ -20,6 +20,7 @@
 #include "fwd.hpp"
 
 #include <hbrs/theta_utils/config.hpp>
+#include <hbrs/theta_utils/core/preprocessor.hpp>
 #include <hbrs/mpl/core/preprocessor.hpp>
 
 #include <hbrs/mpl/config.hpp>
@@ -165,21 +166,47 @@ copy_matrix(From const& from, To && to) {
 	BOOST_ASSERT((*mpl::less_equal)(from_m, to_m));
 	BOOST_ASSERT((*mpl::equal)(from_n, to_n));
 	
+	std::size_t const no_of_points = from_m/3;
+	
+	#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+	if constexpr (std::is_same_v< hana::tag_of_t<To>, mpl::el_matrix_tag >) {
+		// columns of El::Matrix are contiguous, so each velocity is copied as a whole
+		auto & to_lcl = to.data();
+		
+		HBRS_THETA_UTILS_OMP_PARALLEL_FOR
+		for (El::Int j = 0; j < (El::Int)from_n; ++j) {
+			auto const& field = from.data()[j];
+			BOOST_ASSERT(field.density().empty());
+			BOOST_ASSERT(field.pressure().empty());
+			BOOST_ASSERT(field.residual().empty());
+			BOOST_ASSERT(field.x_velocity().size() == no_of_points);
+			
+			auto * col = to_lcl.Buffer(0, j);
+			std::copy_n(field.x_velocity().data(), no_of_points, col);
+			std::copy_n(field.y_velocity().data(), no_of_points, col + no_of_points);
+			std::copy_n(field.z_velocity().data(), no_of_points, col + 2*no_of_points);
+		}
+		
+		return HBRS_MPL_FWD(to);
+	}
+	#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+	
 	for (std::size_t j = 0; j < from_n; ++j) {
-		BOOST_ASSERT(from.data().at(j).density().empty());
-		BOOST_ASSERT(from.data().at(j).pressure().empty());
-		BOOST_ASSERT(from.data().at(j).residual().empty());
+		auto const& field = from.data()[j];
+		BOOST_ASSERT(field.density().empty());
+		BOOST_ASSERT(field.pressure().empty());
+		BOOST_ASSERT(field.residual().empty());
 	
-		for(std::size_t i = 0; i < from_m/3; ++i) {
-			(*mpl::at)(to, mpl::make_matrix_index(i, j)) = from.data().at(j).x_velocity().at(i);
+		for(std::size_t i = 0; i < no_of_points; ++i) {
+			(*mpl::at)(to, mpl::make_matrix_index(i, j)) = field.x_velocity()[i];
 		}
 		
-		for(std::size_t i = 0; i < from_m/3; ++i) {
-			(*mpl::at)(to, mpl::make_matrix_index(i+from_m/3, j)) = from.data().at(j).y_velocity().at(i);
+		for(std::size_t i = 0; i < no_of_points; ++i) {
+			(*mpl::at)(to, mpl::make_matrix_index(i+no_of_points, j)) = field.y_velocity()[i];
 		}
 		
-		for(std::size_t i = 0; i < from_m/3; ++i) {
-			(*mpl::at)(to, mpl::make_matrix_index(i+from_m/3*2, j)) = from.data().at(j).z_velocity().at(i);
+		for(std::size_t i = 0; i < no_of_points; ++i) {
+			(*mpl::at)(to, mpl::make_matrix_index(i+no_of_points*2, j)) = field.z_velocity()[i];
 		}
 	}
 	
@@ -217,24 +244,52 @@ copy_matrix(From const& from, To & to) {
 	BOOST_ASSERT((*mpl::greater_equal)(from_m, to_m));
 	BOOST_ASSERT((*mpl::equal)(from_n, to_n));
 	
+	std::size_t const no_of_points = to_m/3;
+	
+	#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+	if constexpr (std::is_same_v< hana::tag_of_t<From>, mpl::el_matrix_tag >) {
+		// columns of El::Matrix are contiguous, so each velocity is copied as a whole
+		auto const& from_lcl = from.data();
+		
+		HBRS_THETA_UTILS_OMP_PARALLEL_FOR
+		for (El::Int j = 0; j < (El::Int)to_n; ++j) {
+			auto & field = to.data()[j];
+			field.density().clear();
+			field.pressure().clear();
+			field.residual().clear();
+			BOOST_ASSERT(field.x_velocity().size() == no_of_points);
+			BOOST_ASSERT(field.y_velocity().size() == no_of_points);
+			BOOST_ASSERT(field.z_velocity().size() == no_of_points);
+			
+			auto const* col = from_lcl.LockedBuffer(0, j);
+			std::copy_n(col, no_of_points, field.x_velocity().data());
+			std::copy_n(col + no_of_points, no_of_points, field.y_velocity().data());
+			std::copy_n(col + 2*no_of_points, no_of_points, field.z_velocity().data());
+		}
+		
+		return to;
+	}
+	#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+	
 	for (std::size_t j = 0; j < to_n; ++j) {
-		to.data().at(j).density().clear();
-		to.data().at(j).pressure().clear();
-		to.data().at(j).residual().clear();
-		BOOST_ASSERT(to.data().at(j).x_velocity().size() * 3 == to_m);
-		BOOST_ASSERT(to.data().at(j).y_velocity().size() * 3 == to_m);
-		BOOST_ASSERT(to.data().at(j).z_velocity().size() * 3 == to_m);
+		auto & field = to.data()[j];
+		field.density().clear();
+		field.pressure().clear();
+		field.residual().clear();
+		BOOST_ASSERT(field.x_velocity().size() * 3 == to_m);
+		BOOST_ASSERT(field.y_velocity().size() * 3 == to_m);
+		BOOST_ASSERT(field.z_velocity().size() * 3 == to_m);
 	
-		for(std::size_t i = 0; i < to_m/3; ++i) {
-			to.data().at(j).x_velocity().at(i) = (*mpl::at)(from, mpl::make_matrix_index(i, j));
+		for(std::size_t i = 0; i < no_of_points; ++i) {
+			field.x_velocity()[i] = (*mpl::at)(from, mpl::make_matrix_index(i, j));
 		}
 		
-		for(std::size_t i = 0; i < to_m/3; ++i) {
-			to.data().at(j).y_velocity().at(i) = (*mpl::at)(from, mpl::make_matrix_index(i+to_m/3, j));
+		for(std::size_t i = 0; i < no_of_points; ++i) {
+			field.y_velocity()[i] = (*mpl::at)(from, mpl::make_matrix_index(i+no_of_points, j));
 		}
 		
-		for(std::size_t i = 0; i < to_m/3; ++i) {
-			to.data().at(j).z_velocity().at(i) = (*mpl::at)(from, mpl::make_matrix_index(i+to_m/3*2, j));
+		for(std::size_t i = 0; i < no_of_points; ++i) {
+			field.z_velocity()[i] = (*mpl::at)(from, mpl::make_matrix_index(i+no_of_points*2, j));
 		}
 	}
 	
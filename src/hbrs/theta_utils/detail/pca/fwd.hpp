@@ -0,0 +1,37 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HBRS_THETA_UTILS_DETAIL_PCA_FWD_HPP
+#define HBRS_THETA_UTILS_DETAIL_PCA_FWD_HPP
+
+#include <hbrs/theta_utils/config.hpp>
+#include <hbrs/mpl/config.hpp>
+
+HBRS_THETA_UTILS_NAMESPACE_BEGIN
+namespace detail {
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+struct HBRS_THETA_UTILS_API pca_decomposition;
+struct HBRS_THETA_UTILS_API pca_gram_decomposition;
+struct HBRS_THETA_UTILS_API incremental_svd;
+struct HBRS_THETA_UTILS_API row_moments;
+struct HBRS_THETA_UTILS_API randomized_svd_control;
+#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+
+/* namespace detail */ }
+HBRS_THETA_UTILS_NAMESPACE_END
+
+#endif // !HBRS_THETA_UTILS_DETAIL_PCA_FWD_HPP
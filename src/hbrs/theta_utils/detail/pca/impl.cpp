@@ -0,0 +1,947 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "impl.hpp"
+
+#include <hbrs/mpl/detail/log.hpp>
+#include <hbrs/mpl/detail/mpi.hpp>
+
+#include <boost/numeric/conversion/cast.hpp>
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+HBRS_THETA_UTILS_NAMESPACE_BEGIN
+namespace mpi = hbrs::mpl::detail::mpi;
+namespace detail {
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+
+pca_decomposition::pca_decomposition(
+	column_matrix coeff,
+	replicated_matrix score,
+	std::vector<double> latent,
+	column_matrix mean,
+	column_matrix scale
+) : coeff_{std::move(coeff)}, score_{std::move(score)}, latent_{std::move(latent)},
+	mean_{std::move(mean)}, scale_{std::move(scale)} {}
+
+HBRS_THETA_UTILS_DEFINE_ATTR(coeff, pca_decomposition::column_matrix, pca_decomposition)
+HBRS_THETA_UTILS_DEFINE_ATTR(score, pca_decomposition::replicated_matrix, pca_decomposition)
+HBRS_THETA_UTILS_DEFINE_ATTR(latent, std::vector<double>, pca_decomposition)
+HBRS_THETA_UTILS_DEFINE_ATTR(mean, pca_decomposition::column_matrix, pca_decomposition)
+HBRS_THETA_UTILS_DEFINE_ATTR(scale, pca_decomposition::column_matrix, pca_decomposition)
+
+pca_gram_decomposition::pca_gram_decomposition(
+	El::Matrix<double> vectors,
+	std::vector<double> latent
+) : vectors_{std::move(vectors)}, latent_{std::move(latent)} {}
+
+HBRS_THETA_UTILS_DEFINE_ATTR(vectors, El::Matrix<double>, pca_gram_decomposition)
+HBRS_THETA_UTILS_DEFINE_ATTR(latent, std::vector<double>, pca_gram_decomposition)
+
+incremental_svd::incremental_svd(
+	El::Matrix<double> left,
+	El::Matrix<double> singular_values,
+	El::Matrix<double> right
+) : left_{std::move(left)}, singular_values_{std::move(singular_values)}, right_{std::move(right)} {}
+
+HBRS_THETA_UTILS_DEFINE_ATTR(left, El::Matrix<double>, incremental_svd)
+HBRS_THETA_UTILS_DEFINE_ATTR(singular_values, El::Matrix<double>, incremental_svd)
+HBRS_THETA_UTILS_DEFINE_ATTR(right, El::Matrix<double>, incremental_svd)
+
+row_moments::row_moments(
+	std::size_t count,
+	El::Matrix<double> sums,
+	El::Matrix<double> squares
+) : count_{count}, sums_{std::move(sums)}, squares_{std::move(squares)} {}
+
+HBRS_THETA_UTILS_DEFINE_ATTR(count, std::size_t, row_moments)
+HBRS_THETA_UTILS_DEFINE_ATTR(sums, El::Matrix<double>, row_moments)
+HBRS_THETA_UTILS_DEFINE_ATTR(squares, El::Matrix<double>, row_moments)
+
+randomized_svd_control::randomized_svd_control(
+	std::size_t rank,
+	std::size_t oversampling,
+	std::size_t power_iterations
+) : rank_{rank}, oversampling_{oversampling}, power_iterations_{power_iterations} {}
+
+HBRS_THETA_UTILS_DEFINE_ATTR(rank, std::size_t, randomized_svd_control)
+HBRS_THETA_UTILS_DEFINE_ATTR(oversampling, std::size_t, randomized_svd_control)
+HBRS_THETA_UTILS_DEFINE_ATTR(power_iterations, std::size_t, randomized_svd_control)
+
+namespace {
+
+/* A^T*B for matrices whose rows are distributed across all MPI processes */
+El::Matrix<double>
+inner_product(El::Matrix<double> const& A, El::Matrix<double> const& B) {
+	El::Matrix<double> lcl{A.Width(), B.Width()}, gbl{A.Width(), B.Width()};
+	El::Gemm(El::TRANSPOSE, El::NORMAL, 1., A, B, 0., lcl);
+	mpi::allreduce(lcl.LockedBuffer(), gbl.Buffer(), lcl.Height() * lcl.Width(), MPI_SUM, MPI_COMM_WORLD);
+	return gbl;
+}
+
+/* Sums f(x) over each row of A into sums, traversing the column-major matrix column by column */
+template<typename F>
+void
+accumulate_rows(El::Matrix<double> const& A, std::vector<double> & sums, F && f) {
+	sums.assign(A.Height(), 0.);
+	for(El::Int j = 0; j < A.Width(); ++j) {
+		double const* col = A.LockedBuffer(0, j);
+		for(El::Int i = 0; i < A.Height(); ++i) {
+			sums[i] += f(col[i]);
+		}
+	}
+}
+
+/* Adds alpha*v to each column of A */
+void
+add_to_columns(El::Matrix<double> & A, double alpha, double const* v) {
+	for(El::Int j = 0; j < A.Width(); ++j) {
+		double * col = A.Buffer(0, j);
+		for(El::Int i = 0; i < A.Height(); ++i) {
+			col[i] += alpha * v[i];
+		}
+	}
+}
+
+/* Divides rows of A by their standard deviations sd, rows with sd == 0 are left untouched and their sd set to 1 */
+void
+scale_rows(El::Matrix<double> & A, double * sd) {
+	El::Matrix<double> inv_sd{A.Height(), 1};
+	for(El::Int i = 0; i < A.Height(); ++i) {
+		if (!(sd[i] > 0.)) {
+			sd[i] = 1.;
+		}
+		inv_sd.Set(i, 0, 1. / sd[i]);
+	}
+	El::DiagonalScale(El::LEFT, El::NORMAL, inv_sd, A);
+}
+
+/* standardize_rows() for the local rows of a [VC,STAR] distributed matrix, mean and scale are aligned with data */
+void
+standardize_distributed_rows(
+	pca_decomposition::column_matrix & data,
+	mpl::pca_control<bool,bool,bool> const& ctrl,
+	pca_decomposition::column_matrix & mean,
+	pca_decomposition::column_matrix & scale
+) {
+	mean.AlignWith(data);
+	mean.Resize(data.Height(), 1);
+	
+	scale.AlignWith(data);
+	scale.Resize(data.Height(), 1);
+	
+	BOOST_ASSERT(mean.LocalHeight() == data.LocalHeight());
+	standardize_rows(data.Matrix(), ctrl, mean.Matrix(), scale.Matrix());
+}
+
+/* standardize_rows() for a [MC,MR] distributed matrix, row sums are reduced among processes of the same process row */
+void
+standardize_distributed_rows(
+	El::DistMatrix<double> & data,
+	mpl::pca_control<bool,bool,bool> const& ctrl,
+	pca_decomposition::column_matrix & mean,
+	pca_decomposition::column_matrix & scale
+) {
+	El::Grid const& grid = data.Grid();
+	El::Matrix<double> & lcl = data.Matrix();
+	El::Int const n = data.Width();
+	
+	El::DistMatrix<double, El::MC, El::STAR> mean_mc{grid}, scale_mc{grid};
+	mean_mc.AlignWith(data);
+	mean_mc.Resize(data.Height(), 1);
+	El::Zero(mean_mc);
+	scale_mc.AlignWith(data);
+	scale_mc.Resize(data.Height(), 1);
+	El::Fill(scale_mc, 1.);
+	BOOST_ASSERT(mean_mc.LocalHeight() == data.LocalHeight());
+	
+	std::vector<double> lcl_sums, sums(lcl.Height());
+	auto row_sums = [&](auto && f) {
+		accumulate_rows(lcl, lcl_sums, f);
+		mpi::allreduce(lcl_sums.data(), sums.data(), lcl_sums.size(), MPI_SUM, grid.RowComm().comm);
+	};
+	
+	if (ctrl.center()) {
+		row_sums([](double x) { return x; });
+		double * mu = mean_mc.Matrix().Buffer();
+		for(El::Int i = 0; i < lcl.Height(); ++i) {
+			mu[i] = sums[i] / n;
+		}
+		add_to_columns(lcl, -1., mu);
+	}
+	
+	if (ctrl.normalize() && n > 1) {
+		row_sums([](double x) { return x*x; });
+		double * sd = scale_mc.Matrix().Buffer();
+		for(El::Int i = 0; i < lcl.Height(); ++i) {
+			sd[i] = std::sqrt(sums[i] / (n-1));
+		}
+		// constant rows are left untouched, see standardize_rows()
+		scale_rows(lcl, sd);
+	}
+	
+	El::Copy(mean_mc, mean);
+	El::Copy(scale_mc, scale);
+}
+
+/* Variances of the first k principal components, i.e. squared singular values divided by degrees of freedom */
+std::vector<double>
+latent_of(El::Matrix<double> const& s, El::Int k, El::Int DOF) {
+	std::vector<double> latent(boost::numeric_cast<std::size_t>(k));
+	for(El::Int i = 0; i < k; ++i) {
+		double const sv = s.Get(i, 0);
+		latent[i] = DOF > 0 ? sv*sv / DOF : 0.;
+	}
+	return latent;
+}
+
+/* Thin svd of standardized data in [MC,MR] distribution, rows of principal components are [VC,STAR] distributed */
+pca_decomposition
+decompose_standardized(
+	El::DistMatrix<double> & A,
+	mpl::pca_control<bool,bool,bool> const& ctrl,
+	pca_decomposition::column_matrix mean,
+	pca_decomposition::column_matrix scale
+) {
+	typedef pca_decomposition::column_matrix column_matrix;
+	typedef pca_decomposition::replicated_matrix replicated_matrix;
+	
+	El::Grid const& grid = A.Grid();
+	El::Int const m = A.Height();
+	El::Int const n = A.Width();
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose:svd";
+	El::DistMatrix<double> U{grid}, V{grid};
+	El::DistMatrix<double, El::STAR, El::STAR> s{grid};
+	
+	El::SVDCtrl<double> svd_ctrl;
+	svd_ctrl.bidiagSVDCtrl.approach = El::THIN_SVD;
+	El::SVD(A, U, s, V, svd_ctrl);
+	
+	El::Int const DOF = n - (ctrl.center() ? 1 : 0);
+	El::Int const k = ctrl.economy()
+		? std::min({m, n, DOF})
+		: std::min(m, n);
+	BOOST_ASSERT(k >= 0 && k <= s.Height());
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose:coeff";
+	column_matrix coeff{grid};
+	coeff.AlignWith(mean);
+	El::Copy(U(El::ALL, El::IR(0, k)), coeff);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose:score";
+	replicated_matrix score{grid};
+	El::Copy(V(El::ALL, El::IR(0, k)), score);
+	El::DiagonalScale(El::RIGHT, El::NORMAL, s.LockedMatrix()(El::IR(0, k), El::ALL), score.Matrix());
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose:latent";
+	std::vector<double> latent = latent_of(s.LockedMatrix(), k, DOF);
+	
+	return { std::move(coeff), std::move(score), std::move(latent), std::move(mean), std::move(scale) };
+}
+
+/* Like decompose_standardized() above but for a data matrix which is held by a single process, hence the svd is
+ * computed with sequential (but possibly multi-threaded) routines and without any redistribution.
+ */
+pca_decomposition
+decompose_standardized(
+	El::Matrix<double> & A,
+	El::Grid const& grid,
+	mpl::pca_control<bool,bool,bool> const& ctrl,
+	pca_decomposition::column_matrix mean,
+	pca_decomposition::column_matrix scale
+) {
+	typedef pca_decomposition::column_matrix column_matrix;
+	typedef pca_decomposition::replicated_matrix replicated_matrix;
+	
+	BOOST_ASSERT(grid.Size() == 1);
+	El::Int const m = A.Height();
+	El::Int const n = A.Width();
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose:svd";
+	El::Matrix<double> U, s, V;
+	
+	El::SVDCtrl<double> svd_ctrl;
+	svd_ctrl.bidiagSVDCtrl.approach = El::THIN_SVD;
+	El::SVD(A, U, s, V, svd_ctrl);
+	
+	El::Int const DOF = n - (ctrl.center() ? 1 : 0);
+	El::Int const k = ctrl.economy()
+		? std::min({m, n, DOF})
+		: std::min(m, n);
+	BOOST_ASSERT(k >= 0 && k <= s.Height());
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose:coeff";
+	column_matrix coeff{grid};
+	coeff.AlignWith(mean);
+	coeff.Resize(m, k);
+	El::Copy(U(El::ALL, El::IR(0, k)), coeff.Matrix());
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose:score";
+	replicated_matrix score{grid};
+	score.Resize(n, k);
+	El::Copy(V(El::ALL, El::IR(0, k)), score.Matrix());
+	El::DiagonalScale(El::RIGHT, El::NORMAL, s(El::IR(0, k), El::ALL), score.Matrix());
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose:latent";
+	std::vector<double> latent = latent_of(s, k, DOF);
+	
+	return { std::move(coeff), std::move(score), std::move(latent), std::move(mean), std::move(scale) };
+}
+
+/* Replaces the columns of a [VC,STAR] distributed matrix with an orthonormal basis of their span */
+void
+orthonormalize(pca_decomposition::column_matrix & A) {
+	El::DistMatrix<double> A_mc_mr{A};
+	El::qr::ExplicitUnitary(A_mc_mr);
+	El::Copy(A_mc_mr, A);
+}
+
+/* unnamed namespace */ }
+
+HBRS_THETA_UTILS_API
+void
+standardize_rows(
+	El::Matrix<double> & data,
+	mpl::pca_control<bool,bool,bool> const& ctrl,
+	El::Matrix<double> & mean,
+	El::Matrix<double> & scale
+) {
+	El::Int const m = data.Height();
+	El::Int const n = data.Width();
+	
+	mean.Resize(m, 1);
+	El::Zero(mean);
+	scale.Resize(m, 1);
+	El::Fill(scale, 1.);
+	
+	// data is column-major, so rows are never traversed directly but summed up column by column
+	std::vector<double> sums;
+	
+	if (ctrl.center()) {
+		accumulate_rows(data, sums, [](double x) { return x; });
+		double * mu = mean.Buffer();
+		for(El::Int i = 0; i < m; ++i) {
+			mu[i] = sums[i] / n;
+		}
+		add_to_columns(data, -1., mu);
+	}
+	
+	if (ctrl.normalize() && n > 1) {
+		accumulate_rows(data, sums, [](double x) { return x*x; });
+		double * sd = scale.Buffer();
+		for(El::Int i = 0; i < m; ++i) {
+			sd[i] = std::sqrt(sums[i] / (n-1));
+		}
+		// constant rows, e.g. zero rows padded by scatter(), are left untouched
+		scale_rows(data, sd);
+	}
+}
+
+HBRS_THETA_UTILS_API
+void
+destandardize_rows(
+	El::Matrix<double> & data,
+	El::Matrix<double> const& mean,
+	El::Matrix<double> const& scale,
+	bool add_mean
+) {
+	BOOST_ASSERT(mean.Height() == data.Height());
+	BOOST_ASSERT(scale.Height() == data.Height());
+	
+	El::DiagonalScale(El::LEFT, El::NORMAL, scale, data);
+	if (add_mean) {
+		add_to_columns(data, 1., mean.LockedBuffer());
+	}
+}
+
+HBRS_THETA_UTILS_API
+pca_decomposition
+pca_decompose(
+	mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT> data,
+	mpl::pca_control<bool,bool,bool> const& ctrl
+) {
+	/* NOTE: Rows correspond to variables and columns correspond to observations, so in contrast to mpl::pca the data
+	 *       matrix is not transposed. Each process owns complete rows in [VC,STAR] distribution, hence centering and
+	 *       normalizing are purely local operations. Principal components are left singular vectors of the data.
+	 */
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose:begin";
+	
+	typedef pca_decomposition::column_matrix column_matrix;
+	
+	column_matrix & X = data.data();
+	El::Grid const& grid = X.Grid();
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose:center_and_normalize";
+	column_matrix mean{grid}, scale{grid};
+	standardize_distributed_rows(X, ctrl, mean, scale);
+	
+	if (grid.Size() == 1) {
+		// a single process holds the whole data matrix, so the svd is computed on its local matrix in-place
+		pca_decomposition dec = decompose_standardized(X.Matrix(), grid, ctrl, std::move(mean), std::move(scale));
+		
+		HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose:end";
+		return dec;
+	}
+	
+	El::DistMatrix<double> A{X};
+	pca_decomposition dec = decompose_standardized(A, ctrl, std::move(mean), std::move(scale));
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose:end";
+	return dec;
+}
+
+HBRS_THETA_UTILS_API
+pca_decomposition
+pca_decompose(
+	mpl::el_dist_matrix<double, El::MC, El::MR, El::ELEMENT> data,
+	mpl::pca_control<bool,bool,bool> const& ctrl
+) {
+	/* NOTE: Same as pca_decompose() for [VC,STAR] but data is already distributed on a 2d process grid as required
+	 *       by the svd, so the data matrix is not redistributed at all. Row means and standard deviations have to be
+	 *       reduced among all processes of a process row instead.
+	 */
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose:begin";
+	
+	typedef pca_decomposition::column_matrix column_matrix;
+	
+	El::DistMatrix<double> & A = data.data();
+	El::Grid const& grid = A.Grid();
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose:center_and_normalize";
+	column_matrix mean{grid}, scale{grid};
+	standardize_distributed_rows(A, ctrl, mean, scale);
+	
+	pca_decomposition dec = decompose_standardized(A, ctrl, std::move(mean), std::move(scale));
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose:end";
+	return dec;
+}
+
+HBRS_THETA_UTILS_API
+pca_decomposition
+pca_decompose_randomized(
+	mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT> data,
+	mpl::pca_control<bool,bool,bool> const& ctrl,
+	randomized_svd_control const& rnd_ctrl
+) {
+	/* Ref.: Halko, N., Martinsson, P. G. and Tropp, J. A. (2011). Finding structure with randomness: Probabilistic
+	 *       algorithms for constructing approximate matrix decompositions. SIAM Review, 53(2), 217-288.
+	 */
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose_randomized:begin";
+	
+	typedef pca_decomposition::column_matrix column_matrix;
+	typedef pca_decomposition::replicated_matrix replicated_matrix;
+	
+	column_matrix & X = data.data();
+	El::Grid const& grid = X.Grid();
+	El::Int const m = X.Height();
+	El::Int const n = X.Width();
+	El::Matrix<double> const& X_lcl = X.LockedMatrix();
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose_randomized:center_and_normalize";
+	column_matrix mean{grid}, scale{grid};
+	standardize_distributed_rows(X, ctrl, mean, scale);
+	
+	El::Int const DOF = n - (ctrl.center() ? 1 : 0);
+	El::Int const k = std::min(
+		boost::numeric_cast<El::Int>(rnd_ctrl.rank()),
+		ctrl.economy() ? std::min({m, n, DOF}) : std::min(m, n)
+	);
+	El::Int const l = std::min(k + boost::numeric_cast<El::Int>(rnd_ctrl.oversampling()), std::min(m, n));
+	BOOST_ASSERT(k >= 0 && k <= l);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose_randomized:sketch";
+	// test matrix is generated by a single process and broadcasted, so all processes share the same sketch
+	replicated_matrix Omega{grid};
+	El::Gaussian(Omega, n, l);
+	
+	column_matrix Q{grid};
+	Q.AlignWith(X);
+	Q.Resize(m, l);
+	// rows of X and Q are owned by the same processes, so X*Omega is a local product
+	El::Gemm(El::NORMAL, El::NORMAL, 1., X_lcl, Omega.LockedMatrix(), 0., Q.Matrix());
+	orthonormalize(Q);
+	
+	for(std::size_t i = 0; i < rnd_ctrl.power_iterations(); ++i) {
+		HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose_randomized:power_iteration";
+		// Q = orth(X*orth(X^T*Q)), orthonormalized after each product to prevent loss of small singular values
+		El::Matrix<double> Z = inner_product(X_lcl, Q.LockedMatrix());
+		El::qr::ExplicitUnitary(Z);
+		El::Gemm(El::NORMAL, El::NORMAL, 1., X_lcl, Z, 0., Q.Matrix());
+		orthonormalize(Q);
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose_randomized:svd";
+	El::Matrix<double> B = inner_product(Q.LockedMatrix(), X_lcl);
+	El::Matrix<double> U_B, s, V;
+	El::SVDCtrl<double> svd_ctrl;
+	svd_ctrl.bidiagSVDCtrl.approach = El::THIN_SVD;
+	El::SVD(B, U_B, s, V, svd_ctrl);
+	BOOST_ASSERT(k <= s.Height());
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose_randomized:coeff";
+	// deep copies because U_B(...) and V(...) are just views
+	El::Matrix<double> U_B_k, V_k;
+	El::Copy(U_B(El::ALL, El::IR(0, k)), U_B_k);
+	El::Copy(V(El::ALL, El::IR(0, k)), V_k);
+	
+	column_matrix coeff{grid};
+	coeff.AlignWith(X);
+	coeff.Resize(m, k);
+	El::Gemm(El::NORMAL, El::NORMAL, 1., Q.LockedMatrix(), U_B_k, 0., coeff.Matrix());
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose_randomized:score";
+	El::DiagonalScale(El::RIGHT, El::NORMAL, s(El::IR(0, k), El::ALL), V_k);
+	replicated_matrix score{grid};
+	score.Resize(n, k);
+	score.Matrix() = V_k;
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose_randomized:latent";
+	std::vector<double> latent = latent_of(s, k, DOF);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose_randomized:end";
+	return { std::move(coeff), std::move(score), std::move(latent), std::move(mean), std::move(scale) };
+}
+
+HBRS_THETA_UTILS_API
+mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT>
+pca_reconstruct(
+	pca_decomposition const& dec,
+	std::function<bool(std::size_t)> const& keep,
+	bool keep_centered
+) {
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_reconstruct:begin";
+	
+	El::Matrix<double> const& coeff_lcl = dec.coeff().LockedMatrix();
+	El::Matrix<double> const& score_lcl = dec.score().LockedMatrix();
+	El::Matrix<double> const& mean_lcl = dec.mean().LockedMatrix();
+	El::Matrix<double> const& scale_lcl = dec.scale().LockedMatrix();
+	
+	El::Int const m = dec.coeff().Height();
+	El::Int const n = dec.score().Height();
+	El::Int const lcl_m = coeff_lcl.Height();
+	
+	std::vector<El::Int> kept;
+	for(El::Int j = 0; j < dec.coeff().Width(); ++j) {
+		if (keep(boost::numeric_cast<std::size_t>(j))) {
+			kept.push_back(j);
+		}
+	}
+	El::Int const k = boost::numeric_cast<El::Int>(kept.size());
+	
+	mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT> to{dec.coeff().Grid(), m, n};
+	El::Matrix<double> & to_lcl = to.data().Matrix();
+	BOOST_ASSERT(to.data().ColAlign() == dec.coeff().ColAlign());
+	BOOST_ASSERT(to_lcl.Height() == lcl_m);
+	
+	if (k == 0) {
+		El::Zero(to_lcl);
+	} else {
+		HBRS_MPL_LOG_TRIVIAL(debug) << "pca_reconstruct:select";
+		El::Matrix<double> coeff_k{lcl_m, k}, score_k{n, k};
+		for(El::Int c = 0; c < k; ++c) {
+			std::copy_n(coeff_lcl.LockedBuffer(0, kept[c]), lcl_m, coeff_k.Buffer(0, c));
+			std::copy_n(score_lcl.LockedBuffer(0, kept[c]), n, score_k.Buffer(0, c));
+		}
+		
+		HBRS_MPL_LOG_TRIVIAL(debug) << "pca_reconstruct:gemm";
+		// each process multiplies its own rows of coeff with all rows of score, so no communication is required
+		El::Gemm(El::NORMAL, El::TRANSPOSE, 1., coeff_k, score_k, 0., to_lcl);
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_reconstruct:denormalize";
+	destandardize_rows(to_lcl, mean_lcl, scale_lcl, !keep_centered);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_reconstruct:end";
+	return to;
+}
+
+HBRS_THETA_UTILS_API
+pca_gram_decomposition
+pca_decompose_gram(
+	El::Matrix<double> gram,
+	std::size_t m,
+	mpl::pca_control<bool,bool,bool> const& ctrl
+) {
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose_gram:begin";
+	BOOST_ASSERT(gram.Height() == gram.Width());
+	
+	El::Int const n = gram.Height();
+	El::Int const DOF = n - (ctrl.center() ? 1 : 0);
+	El::Int const m_ = boost::numeric_cast<El::Int>(m);
+	El::Int const k = ctrl.economy()
+		? std::min({m_, n, DOF})
+		: std::min(m_, n);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose_gram:eig";
+	El::Matrix<double> w, Z;
+	El::HermitianEigCtrl<double> eig_ctrl;
+	eig_ctrl.tridiagEigCtrl.sort = El::DESCENDING;
+	El::HermitianEig(El::LOWER, gram, w, Z, eig_ctrl);
+	BOOST_ASSERT(k >= 0 && k <= w.Height());
+	
+	std::vector<double> latent(boost::numeric_cast<std::size_t>(k));
+	for(El::Int i = 0; i < k; ++i) {
+		// eigenvalues are squared singular values, rounding errors might make them slightly negative
+		latent[i] = DOF > 0 ? std::max(w.Get(i, 0), 0.) / DOF : 0.;
+	}
+	
+	// deep copy because Z(...) is just a view
+	El::Matrix<double> vectors;
+	El::Copy(Z(El::ALL, El::IR(0, k)), vectors);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "pca_decompose_gram:end";
+	return { std::move(vectors), std::move(latent) };
+}
+
+HBRS_THETA_UTILS_API
+El::Matrix<double>
+pca_gram_projector(
+	pca_gram_decomposition const& dec,
+	std::function<bool(std::size_t)> const& keep
+) {
+	El::Matrix<double> const& V = dec.vectors();
+	El::Int const n = V.Height();
+	
+	std::vector<El::Int> kept;
+	for(El::Int j = 0; j < V.Width(); ++j) {
+		if (keep(boost::numeric_cast<std::size_t>(j))) {
+			kept.push_back(j);
+		}
+	}
+	El::Int const k = boost::numeric_cast<El::Int>(kept.size());
+	
+	El::Matrix<double> projector{n, n};
+	if (k == 0) {
+		El::Zero(projector);
+		return projector;
+	}
+	
+	El::Matrix<double> V_k{n, k};
+	for(El::Int c = 0; c < k; ++c) {
+		std::copy_n(V.LockedBuffer(0, kept[c]), n, V_k.Buffer(0, c));
+	}
+	
+	El::Gemm(El::NORMAL, El::TRANSPOSE, 1., V_k, V_k, 0., projector);
+	return projector;
+}
+
+HBRS_THETA_UTILS_API
+incremental_svd
+update_incremental_svd(
+	incremental_svd svd,
+	El::Matrix<double> const& columns,
+	std::size_t rank
+) {
+	/* Ref.: Brand, M. (2006). Fast low-rank modifications of the thin singular value decomposition. */
+	HBRS_MPL_LOG_TRIVIAL(debug) << "update_incremental_svd:begin";
+	
+	El::Matrix<double> & U = svd.left();
+	El::Matrix<double> const& s = svd.singular_values();
+	El::Matrix<double> const& V = svd.right();
+	
+	El::Int const m = columns.Height();
+	El::Int const c = columns.Width();
+	El::Int const n = V.Height();
+	El::Int const k = s.Height();
+	
+	if (c == 0) {
+		return svd;
+	}
+	
+	if (k == 0) {
+		U.Resize(m, 0);
+	}
+	BOOST_ASSERT(U.Height() == m);
+	BOOST_ASSERT(U.Width() == k && V.Width() == k);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "update_incremental_svd:project";
+	// columns = U*L + H with H orthogonal to U, projected twice because a single pass loses orthogonality
+	El::Matrix<double> L{k, c};
+	El::Zero(L);
+	El::Matrix<double> H{columns};
+	for(int pass = 0; pass < 2 && k > 0; ++pass) {
+		El::Matrix<double> L_ = inner_product(U, H);
+		El::Gemm(El::NORMAL, El::NORMAL, -1., U, L_, 1., H);
+		El::Axpy(1., L_, L);
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "update_incremental_svd:orthogonalize";
+	// H = J*K with orthonormal J, derived from the eigen decomposition of H^T*H because rows of H are distributed
+	El::Matrix<double> w, R;
+	El::HermitianEigCtrl<double> eig_ctrl;
+	eig_ctrl.tridiagEigCtrl.sort = El::DESCENDING;
+	El::Matrix<double> G = inner_product(H, H);
+	El::HermitianEig(El::LOWER, G, w, R, eig_ctrl);
+	
+	double const s_max = k > 0 ? s.Get(0, 0) : 0.;
+	double const h_max = std::sqrt(std::max(w.Get(0, 0), 0.));
+	// eigenvalues are squared singular values, hence residuals below sqrt(eps) relative to the data are noise
+	double const h_tol = std::sqrt(std::numeric_limits<double>::epsilon() * c) * std::max(s_max, h_max);
+	
+	El::Int r = 0;
+	while (r < c && std::sqrt(std::max(w.Get(r, 0), 0.)) > h_tol) {
+		++r;
+	}
+	
+	El::Matrix<double> J{m, r}, K{r, c};
+	if (r > 0) {
+		El::Matrix<double> R_r;
+		El::Copy(R(El::ALL, El::IR(0, r)), R_r);
+		El::Gemm(El::NORMAL, El::NORMAL, 1., H, R_r, 0., J);
+		El::Transpose(R_r, K);
+		for(El::Int i = 0; i < r; ++i) {
+			double const sv = std::sqrt(w.Get(i, 0));
+			for(El::Int j = 0; j < m; ++j) {
+				J.Set(j, i, J.Get(j, i) / sv);
+			}
+			for(El::Int j = 0; j < c; ++j) {
+				K.Set(i, j, K.Get(i, j) * sv);
+			}
+		}
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "update_incremental_svd:svd";
+	// [U*diag(s)*V^T, columns] = [U, J] * [diag(s), L; 0, K] * [V, 0; 0, I]^T
+	El::Matrix<double> M{k+r, k+c};
+	El::Zero(M);
+	for(El::Int i = 0; i < k; ++i) {
+		M.Set(i, i, s.Get(i, 0));
+	}
+	for(El::Int j = 0; j < c; ++j) {
+		for(El::Int i = 0; i < k; ++i) {
+			M.Set(i, k+j, L.Get(i, j));
+		}
+		for(El::Int i = 0; i < r; ++i) {
+			M.Set(k+i, k+j, K.Get(i, j));
+		}
+	}
+	
+	El::Matrix<double> U_M, s_M, V_M;
+	El::SVDCtrl<double> svd_ctrl;
+	svd_ctrl.bidiagSVDCtrl.approach = El::THIN_SVD;
+	El::SVD(M, U_M, s_M, V_M, svd_ctrl);
+	
+	double const s_tol = s_M.Height() > 0
+		? std::numeric_limits<double>::epsilon() * std::max(k+r, k+c) * s_M.Get(0, 0)
+		: 0.;
+	El::Int q = 0;
+	while (q < s_M.Height() && s_M.Get(q, 0) > s_tol) {
+		++q;
+	}
+	if (rank > 0) {
+		q = std::min(q, boost::numeric_cast<El::Int>(rank));
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "update_incremental_svd:rotate";
+	El::Matrix<double> U_new{m, q}, s_new, V_new{n+c, q};
+	El::Copy(s_M(El::IR(0, q), El::ALL), s_new);
+	El::Zero(U_new);
+	El::Zero(V_new);
+	
+	if (q > 0) {
+		// deep copies because U_M(...) and V_M(...) are just views
+		El::Matrix<double> U_M_top, U_M_bottom, V_M_top, V_M_bottom;
+		El::Copy(U_M(El::IR(0, k), El::IR(0, q)), U_M_top);
+		El::Copy(U_M(El::IR(k, k+r), El::IR(0, q)), U_M_bottom);
+		El::Copy(V_M(El::IR(0, k), El::IR(0, q)), V_M_top);
+		El::Copy(V_M(El::IR(k, k+c), El::IR(0, q)), V_M_bottom);
+		
+		El::Matrix<double> V_top{n, q};
+		El::Zero(V_top);
+		if (k > 0) {
+			El::Gemm(El::NORMAL, El::NORMAL, 1., U, U_M_top, 0., U_new);
+			El::Gemm(El::NORMAL, El::NORMAL, 1., V, V_M_top, 0., V_top);
+		}
+		if (r > 0) {
+			El::Gemm(El::NORMAL, El::NORMAL, 1., J, U_M_bottom, 1., U_new);
+		}
+		
+		for(El::Int j = 0; j < q; ++j) {
+			std::copy_n(V_top.LockedBuffer(0, j), n, V_new.Buffer(0, j));
+			std::copy_n(V_M_bottom.LockedBuffer(0, j), c, V_new.Buffer(n, j));
+		}
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "update_incremental_svd:end";
+	return { std::move(U_new), std::move(s_new), std::move(V_new) };
+}
+
+HBRS_THETA_UTILS_API
+void
+standardization_of(
+	row_moments const& moments,
+	mpl::pca_control<bool,bool,bool> const& ctrl,
+	El::Matrix<double> & mean,
+	El::Matrix<double> & scale
+) {
+	El::Int const m = moments.sums().Height();
+	double const n = boost::numeric_cast<double>(moments.count());
+	
+	mean.Resize(m, 1);
+	El::Zero(mean);
+	scale.Resize(m, 1);
+	El::Fill(scale, 1.);
+	
+	if (ctrl.center() && moments.count() > 0) {
+		for(El::Int i = 0; i < m; ++i) {
+			mean.Set(i, 0, moments.sums().Get(i, 0) / n);
+		}
+	}
+	
+	if (ctrl.normalize() && moments.count() > 1) {
+		for(El::Int i = 0; i < m; ++i) {
+			// sum of squares of the (centered) row, i.e. sum((x-mu)^2) = sum(x^2) - 2*mu*sum(x) + n*mu^2
+			double const mu = mean.Get(i, 0);
+			double const sum_sq = moments.squares().Get(i, 0) - 2.*mu*moments.sums().Get(i, 0) + n*mu*mu;
+			double const sd = std::sqrt(std::max(sum_sq, 0.) / (n-1));
+			// constant rows are left untouched, see standardize_rows()
+			if (sd > 0.) {
+				scale.Set(i, 0, sd);
+			}
+		}
+	}
+}
+
+HBRS_THETA_UTILS_API
+void
+update_incremental_pca(
+	El::Matrix<double> & columns,
+	mpl::pca_control<bool,bool,bool> const& ctrl,
+	std::size_t rank,
+	incremental_svd & svd,
+	row_moments & moments
+) {
+	/* Ref.: Ross, D. A., Lim, J., Lin, R.-S. and Yang, M.-H. (2008). Incremental learning for robust visual tracking.
+	 *       International Journal of Computer Vision, 77(1-3), 125-141.
+	 */
+	HBRS_MPL_LOG_TRIVIAL(debug) << "update_incremental_pca:begin";
+	
+	El::Int const m = columns.Height();
+	El::Int const c = columns.Width();
+	El::Int const k = svd.singular_values().Height();
+	std::size_t const n_old = moments.count();
+	
+	if (n_old == 0) {
+		moments.sums().Resize(m, 1);
+		El::Zero(moments.sums());
+		moments.squares().Resize(m, 1);
+		El::Zero(moments.squares());
+	}
+	BOOST_ASSERT(moments.sums().Height() == m && moments.squares().Height() == m);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "update_incremental_pca:moments";
+	El::Matrix<double> old_mean, old_scale;
+	standardization_of(moments, ctrl, old_mean, old_scale);
+	
+	std::vector<double> sums;
+	accumulate_rows(columns, sums, [](double x) { return x; });
+	add_to_columns(moments.sums(), 1., sums.data());
+	accumulate_rows(columns, sums, [](double x) { return x*x; });
+	add_to_columns(moments.squares(), 1., sums.data());
+	moments.count() += boost::numeric_cast<std::size_t>(c);
+	
+	El::Matrix<double> mean, scale;
+	standardization_of(moments, ctrl, mean, scale);
+	
+	add_to_columns(columns, -1., mean.LockedBuffer());
+	scale_rows(columns, scale.Buffer());
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "update_incremental_pca:correct";
+	// previous observations centered with the new mean contribute their own scatter plus n_old times the outer product
+	// of the shift of the mean, hence the latter is appended as an additional column which has the same effect
+	bool const shifted = ctrl.center() && n_old > 0;
+	// previous observations have been standardized with other standard deviations, hence U*diag(s) is rescaled and
+	// decomposed again together with the new columns
+	bool const rescaled = ctrl.normalize() && n_old > 0 && k > 0;
+	
+	El::Int const k_ = rescaled ? k : 0;
+	El::Int const d = shifted ? 1 : 0;
+	El::Matrix<double> added{m, k_ + c + d};
+	
+	if (rescaled) {
+		El::Matrix<double> rescaled_left{svd.left()}, ratio{m, 1};
+		El::DiagonalScale(El::RIGHT, El::NORMAL, svd.singular_values(), rescaled_left);
+		for(El::Int i = 0; i < m; ++i) {
+			ratio.Set(i, 0, old_scale.Get(i, 0) / scale.Get(i, 0));
+		}
+		El::DiagonalScale(El::LEFT, El::NORMAL, ratio, rescaled_left);
+		for(El::Int j = 0; j < k; ++j) {
+			std::copy_n(rescaled_left.LockedBuffer(0, j), m, added.Buffer(0, j));
+		}
+	}
+	
+	for(El::Int j = 0; j < c; ++j) {
+		std::copy_n(columns.LockedBuffer(0, j), m, added.Buffer(0, k_ + j));
+	}
+	
+	if (shifted) {
+		double const weight = std::sqrt(boost::numeric_cast<double>(n_old));
+		double * shift = added.Buffer(0, k_ + c);
+		for(El::Int i = 0; i < m; ++i) {
+			shift[i] = weight * (old_mean.Get(i, 0) - mean.Get(i, 0)) / scale.Get(i, 0);
+		}
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "update_incremental_pca:update_incremental_svd";
+	// right singular vectors of previous observations are not tracked, so V starts without rows
+	incremental_svd prior = rescaled
+		? incremental_svd{ {}, {}, {} }
+		: incremental_svd{ std::move(svd.left()), std::move(svd.singular_values()), El::Matrix<double>{0, k} };
+	svd = update_incremental_svd(std::move(prior), added, rank);
+	svd.right() = El::Matrix<double>{0, svd.singular_values().Height()};
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "update_incremental_pca:end";
+}
+
+HBRS_THETA_UTILS_API
+El::Matrix<double>
+incremental_svd_filter(
+	incremental_svd const& svd,
+	El::Matrix<double> const& columns,
+	std::function<bool(std::size_t)> const& keep
+) {
+	El::Matrix<double> const& U = svd.left();
+	El::Int const k = svd.singular_values().Height();
+	
+	El::Matrix<double> filtered{columns.Height(), columns.Width()};
+	El::Zero(filtered);
+	if (k == 0) {
+		return filtered;
+	}
+	
+	// coefficients of unselected principal components are zeroed, so U*coeff projects onto the selected ones only
+	El::Matrix<double> coeff = inner_product(U, columns);
+	for(El::Int i = 0; i < k; ++i) {
+		if (!keep(boost::numeric_cast<std::size_t>(i))) {
+			for(El::Int j = 0; j < columns.Width(); ++j) {
+				coeff.Set(i, j, 0.);
+			}
+		}
+	}
+	
+	El::Gemm(El::NORMAL, El::NORMAL, 1., U, coeff, 0., filtered);
+	return filtered;
+}
+
+#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+
+/* namespace detail */ }
+HBRS_THETA_UTILS_NAMESPACE_END
@@ -0,0 +1,300 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HBRS_THETA_UTILS_DETAIL_PCA_IMPL_HPP
+#define HBRS_THETA_UTILS_DETAIL_PCA_IMPL_HPP
+
+#include "fwd.hpp"
+
+#include <hbrs/theta_utils/config.hpp>
+#include <hbrs/theta_utils/core/preprocessor.hpp>
+
+#include <hbrs/mpl/config.hpp>
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+    #include <hbrs/mpl/dt/el_dist_matrix.hpp>
+#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+#include <hbrs/mpl/dt/pca_control.hpp>
+
+#include <functional>
+#include <vector>
+
+HBRS_THETA_UTILS_NAMESPACE_BEGIN
+namespace mpl = hbrs::mpl;
+namespace detail {
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+/* Principal components of a [VC,STAR] distributed data matrix whose rows correspond to variables and whose columns
+ * correspond to observations, i.e. the layout produced by scatter(). Keeping the factors allows to reconstruct the
+ * data for an arbitrary selection of principal components without decomposing the data matrix again.
+ */
+struct HBRS_THETA_UTILS_API pca_decomposition {
+public:
+	typedef El::DistMatrix<double, El::VC, El::STAR, El::ELEMENT> column_matrix;
+	typedef El::DistMatrix<double, El::STAR, El::STAR, El::ELEMENT> replicated_matrix;
+	
+	pca_decomposition(
+		column_matrix coeff,
+		replicated_matrix score,
+		std::vector<double> latent,
+		column_matrix mean,
+		column_matrix scale
+	);
+	
+	pca_decomposition(pca_decomposition const&) = default;
+	pca_decomposition(pca_decomposition &&) = default;
+	
+	pca_decomposition&
+	operator=(pca_decomposition const&) = default;
+	pca_decomposition&
+	operator=(pca_decomposition &&) = default;
+	
+	/* left singular vectors of the centered and normalized data, one column per principal component */
+	HBRS_THETA_UTILS_DECLARE_ATTR(coeff, column_matrix)
+	/* right singular vectors scaled by the singular values, one column per principal component */
+	HBRS_THETA_UTILS_DECLARE_ATTR(score, replicated_matrix)
+	/* variances of the principal components in descending order */
+	HBRS_THETA_UTILS_DECLARE_ATTR(latent, std::vector<double>)
+	/* row means which have been subtracted, zero if data has not been centered */
+	HBRS_THETA_UTILS_DECLARE_ATTR(mean, column_matrix)
+	/* row standard deviations which data has been divided by, one if data has not been normalized */
+	HBRS_THETA_UTILS_DECLARE_ATTR(scale, column_matrix)
+};
+
+/* Method of snapshots: Principal components of a m x n data matrix X derived from its n x n gram matrix X^T*X, e.g.
+ * accumulated block by block from standardized rows of X. Only n x n values have to be kept in memory, but small
+ * singular values lose accuracy because they are squared.
+ */
+struct HBRS_THETA_UTILS_API pca_gram_decomposition {
+public:
+	pca_gram_decomposition(El::Matrix<double> vectors, std::vector<double> latent);
+	
+	pca_gram_decomposition(pca_gram_decomposition const&) = default;
+	pca_gram_decomposition(pca_gram_decomposition &&) = default;
+	
+	pca_gram_decomposition&
+	operator=(pca_gram_decomposition const&) = default;
+	pca_gram_decomposition&
+	operator=(pca_gram_decomposition &&) = default;
+	
+	/* eigenvectors of the gram matrix, i.e. right singular vectors of the data, one column per principal component */
+	HBRS_THETA_UTILS_DECLARE_ATTR(vectors, El::Matrix<double>)
+	/* variances of the principal components in descending order */
+	HBRS_THETA_UTILS_DECLARE_ATTR(latent, std::vector<double>)
+};
+
+/* Thin svd U*diag(s)*V^T of a m x n data matrix whose rows are distributed across all MPI processes, i.e. each process
+ * holds its own rows of U while s and V are replicated. update_incremental_svd() decomposes the data as is while
+ * update_incremental_pca() decomposes standardized data and does not keep V.
+ */
+struct HBRS_THETA_UTILS_API incremental_svd {
+public:
+	incremental_svd(
+		El::Matrix<double> left,
+		El::Matrix<double> singular_values,
+		El::Matrix<double> right
+	);
+	
+	incremental_svd(incremental_svd const&) = default;
+	incremental_svd(incremental_svd &&) = default;
+	
+	incremental_svd&
+	operator=(incremental_svd const&) = default;
+	incremental_svd&
+	operator=(incremental_svd &&) = default;
+	
+	/* local rows of the left singular vectors */
+	HBRS_THETA_UTILS_DECLARE_ATTR(left, El::Matrix<double>)
+	/* singular values in descending order as column vector */
+	HBRS_THETA_UTILS_DECLARE_ATTR(singular_values, El::Matrix<double>)
+	/* right singular vectors, one row per observation */
+	HBRS_THETA_UTILS_DECLARE_ATTR(right, El::Matrix<double>)
+};
+
+/* Row sums and sums of squares of all observations folded into an incremental pca so far, from which row means and
+ * standard deviations follow without revisiting previous observations. Rows are distributed like those of the svd.
+ */
+struct HBRS_THETA_UTILS_API row_moments {
+public:
+	row_moments(
+		std::size_t count,
+		El::Matrix<double> sums,
+		El::Matrix<double> squares
+	);
+	
+	row_moments(row_moments const&) = default;
+	row_moments(row_moments &&) = default;
+	
+	row_moments&
+	operator=(row_moments const&) = default;
+	row_moments&
+	operator=(row_moments &&) = default;
+	
+	/* number of observations */
+	HBRS_THETA_UTILS_DECLARE_ATTR(count, std::size_t)
+	/* local row sums as column vector */
+	HBRS_THETA_UTILS_DECLARE_ATTR(sums, El::Matrix<double>)
+	/* local row sums of squares as column vector */
+	HBRS_THETA_UTILS_DECLARE_ATTR(squares, El::Matrix<double>)
+};
+
+/* Parameters of a randomized truncated svd, see pca_decompose_randomized() */
+struct HBRS_THETA_UTILS_API randomized_svd_control {
+public:
+	randomized_svd_control(std::size_t rank, std::size_t oversampling, std::size_t power_iterations);
+	
+	randomized_svd_control(randomized_svd_control const&) = default;
+	randomized_svd_control(randomized_svd_control &&) = default;
+	
+	randomized_svd_control&
+	operator=(randomized_svd_control const&) = default;
+	randomized_svd_control&
+	operator=(randomized_svd_control &&) = default;
+	
+	/* number of leading principal components to compute */
+	HBRS_THETA_UTILS_DECLARE_ATTR(rank, std::size_t)
+	/* number of additional random samples which improve accuracy of the leading components */
+	HBRS_THETA_UTILS_DECLARE_ATTR(oversampling, std::size_t)
+	/* number of subspace iterations, each one costs two more passes over the data matrix */
+	HBRS_THETA_UTILS_DECLARE_ATTR(power_iterations, std::size_t)
+};
+
+/* Centers and/or normalizes each row of data in-place. Row means and standard deviations are stored in mean and scale,
+ * both will be resized to a column vector and contain zeros and ones respectively if not applicable.
+ */
+HBRS_THETA_UTILS_API
+void
+standardize_rows(
+	El::Matrix<double> & data,
+	mpl::pca_control<bool,bool,bool> const& ctrl,
+	El::Matrix<double> & mean,
+	El::Matrix<double> & scale
+);
+
+/* Reverts standardize_rows(), row means are re-added only if add_mean is true */
+HBRS_THETA_UTILS_API
+void
+destandardize_rows(
+	El::Matrix<double> & data,
+	El::Matrix<double> const& mean,
+	El::Matrix<double> const& scale,
+	bool add_mean
+);
+
+HBRS_THETA_UTILS_API
+pca_decomposition
+pca_decompose(
+	mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT> data,
+	mpl::pca_control<bool,bool,bool> const& ctrl
+);
+
+/* Like pca_decompose() above but for a data matrix which has been scattered to a 2d process grid directly */
+HBRS_THETA_UTILS_API
+pca_decomposition
+pca_decompose(
+	mpl::el_dist_matrix<double, El::MC, El::MR, El::ELEMENT> data,
+	mpl::pca_control<bool,bool,bool> const& ctrl
+);
+
+/* Like pca_decompose() but computes only the leading principal components from a randomized sketch of the data matrix,
+ * i.e. with a few matrix products whose cost is linear in the requested rank instead of a full svd.
+ */
+HBRS_THETA_UTILS_API
+pca_decomposition
+pca_decompose_randomized(
+	mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT> data,
+	mpl::pca_control<bool,bool,bool> const& ctrl,
+	randomized_svd_control const& rnd_ctrl
+);
+
+HBRS_THETA_UTILS_API
+mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT>
+pca_reconstruct(
+	pca_decomposition const& dec,
+	std::function<bool(std::size_t)> const& keep,
+	bool keep_centered
+);
+
+HBRS_THETA_UTILS_API
+pca_gram_decomposition
+pca_decompose_gram(
+	El::Matrix<double> gram,
+	std::size_t m,
+	mpl::pca_control<bool,bool,bool> const& ctrl
+);
+
+/* Returns the n x n projection onto the selected principal components, right-multiplying standardized data with it
+ * yields the pca-filtered data.
+ */
+HBRS_THETA_UTILS_API
+El::Matrix<double>
+pca_gram_projector(
+	pca_gram_decomposition const& dec,
+	std::function<bool(std::size_t)> const& keep
+);
+
+/* Brand's update: Appends columns, i.e. the local rows of new observations, to the decomposed data matrix without
+ * revisiting previous observations. Singular values which are numerically zero are dropped, so the rank is bound by the
+ * rank of the data matrix. If rank is greater than zero, then only that many leading singular triplets are kept. An
+ * empty svd, e.g. with no singular values, serves as start for the first update.
+ */
+HBRS_THETA_UTILS_API
+incremental_svd
+update_incremental_svd(
+	incremental_svd svd,
+	El::Matrix<double> const& columns,
+	std::size_t rank = 0
+);
+
+/* Row means and standard deviations of the observations summarized by moments, like standardize_rows() computes them */
+HBRS_THETA_UTILS_API
+void
+standardization_of(
+	row_moments const& moments,
+	mpl::pca_control<bool,bool,bool> const& ctrl,
+	El::Matrix<double> & mean,
+	El::Matrix<double> & scale
+);
+
+/* Incremental pca: Folds columns, i.e. the local rows of new observations, into the svd of the standardized data
+ * matrix and into its row moments. Previous observations are not needed because changes of row means and standard
+ * deviations are applied to the left singular vectors and singular values, hence right singular vectors are dropped.
+ * On return columns are standardized with the updated row means and standard deviations. See
+ * update_incremental_svd() for rank.
+ */
+HBRS_THETA_UTILS_API
+void
+update_incremental_pca(
+	El::Matrix<double> & columns,
+	mpl::pca_control<bool,bool,bool> const& ctrl,
+	std::size_t rank,
+	incremental_svd & svd,
+	row_moments & moments
+);
+
+/* Projects standardized columns onto the selected left singular vectors U_k, i.e. returns U_k*U_k^T*columns */
+HBRS_THETA_UTILS_API
+El::Matrix<double>
+incremental_svd_filter(
+	incremental_svd const& svd,
+	El::Matrix<double> const& columns,
+	std::function<bool(std::size_t)> const& keep
+);
+#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+
+/* namespace detail */ }
+HBRS_THETA_UTILS_NAMESPACE_END
+
+#endif // !HBRS_THETA_UTILS_DETAIL_PCA_IMPL_HPP
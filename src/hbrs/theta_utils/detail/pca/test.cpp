@@ -0,0 +1,515 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE detail_pca_test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <hbrs/mpl/config.hpp>
+
+#include <hbrs/mpl/dt/sm.hpp>
+#include <hbrs/mpl/dt/ctsav.hpp>
+#include <hbrs/mpl/dt/storage_order.hpp>
+#include <hbrs/mpl/dt/pca_control.hpp>
+#include <hbrs/mpl/dt/pca_filter_control.hpp>
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+    #include <hbrs/mpl/dt/el_matrix.hpp>
+    #include <hbrs/mpl/dt/el_dist_matrix.hpp>
+#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+
+#include <hbrs/mpl/detail/test.hpp>
+#include <hbrs/mpl/detail/log.hpp>
+#include <hbrs/mpl/detail/mpi.hpp>
+
+#include <hbrs/mpl/fn/pca_filter.hpp>
+#include <hbrs/mpl/fn/transpose.hpp>
+#include <hbrs/mpl/fn/size.hpp>
+#include <hbrs/mpl/fn/m.hpp>
+#include <hbrs/mpl/fn/n.hpp>
+
+#include <hbrs/theta_utils/detail/pca.hpp>
+#include <hbrs/theta_utils/detail/gather.hpp>
+#include <hbrs/theta_utils/detail/scatter.hpp>
+#include <hbrs/theta_utils/detail/matrix.hpp>
+#include <hbrs/theta_utils/detail/test.hpp>
+
+#include <hbrs/theta_utils/dt/theta_field_matrix.hpp>
+
+#include <boost/hana/tuple.hpp>
+#include <boost/hana/for_each.hpp>
+#include <functional>
+#include <vector>
+#include <array>
+#include <algorithm>
+#include <cmath>
+
+namespace utf = boost::unit_test;
+namespace tt = boost::test_tools;
+
+#define _TOL 0.000000001
+
+BOOST_AUTO_TEST_SUITE(detail_pca_test)
+
+using hbrs::mpl::detail::environment_fixture;
+BOOST_TEST_GLOBAL_FIXTURE(environment_fixture);
+
+BOOST_AUTO_TEST_CASE(decompose_reconstruct,
+	* utf::precondition(hbrs::theta_utils::detail::mpi_world_size_condition{{0,5}})
+	* utf::tolerance(_TOL)
+) {
+	using namespace hbrs::mpl;
+	namespace detail = hbrs::theta_utils::detail;
+	namespace hana = boost::hana;
+	using namespace hbrs::theta_utils;
+	using hbrs::mpl::detail::loggable;
+	
+	static constexpr auto datasets = hana::make_tuple(
+		make_sm(
+			make_ctsav(mpl::detail::mat_a), 
+			make_matrix_size(hana::size_c<mpl::detail::mat_a_m>, hana::size_c<mpl::detail::mat_a_n>),
+			row_major_c
+		),
+		make_sm(
+			make_ctsav(mpl::detail::mat_c),
+			make_matrix_size(hana::size_c<mpl::detail::mat_c_m>, hana::size_c<mpl::detail::mat_c_n>),
+			row_major_c
+		),
+		make_sm(
+			make_ctsav(mpl::detail::mat_e),
+			make_matrix_size(hana::size_c<mpl::detail::mat_e_m>, hana::size_c<mpl::detail::mat_e_n>),
+			row_major_c
+		),
+		make_sm(
+			make_ctsav(mpl::detail::mat_l),
+			make_matrix_size(hana::size_c<mpl::detail::mat_l_m>, hana::size_c<mpl::detail::mat_l_n>),
+			row_major_c
+		)
+	);
+	
+	#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+	typedef detail::theta_field_distribution_2 dist_t;
+	
+	std::size_t dataset_nr = 0;
+	hana::for_each(datasets, [&dataset_nr](auto const& dataset) {
+		BOOST_TEST_MESSAGE("dataset_nr=" << dataset_nr);
+		
+		theta_field_matrix series = make_theta_field_matrix(
+			rtsam<double, storage_order::row_major>{(*size)(dataset)}
+		);
+		detail::copy_matrix(make_el_matrix(dataset), series);
+		auto series_sz = series.size();
+		
+		auto distributed = detail::scatter(series, detail::scatter_control<dist_t>{{}});
+		
+		auto to_local = [&series_sz](auto && dist) {
+			theta_field_matrix gathered = detail::gather(
+				HBRS_MPL_FWD(dist),
+				detail::gather_control<
+					dist_t,
+					matrix_size<std::size_t, std::size_t>
+				>{{}, series_sz}
+			);
+			return detail::copy_matrix(
+				gathered,
+				make_el_matrix(
+					hana::type_c<double>,
+					matrix_size<El::Int, El::Int>{ gathered.size() }
+				)
+			);
+		};
+		
+		std::array<std::function<bool(std::size_t)>, 3> const keeps = {
+			[](std::size_t) { return true; },
+			[](std::size_t i) { return i == 0; },
+			[](std::size_t) { return false; }
+		};
+		
+		for(bool center : { true, false }) {
+			for(bool normalize : { true, false }) {
+				for(bool keep_centered : { true, false }) {
+					BOOST_TEST_MESSAGE(
+						"center=" << center << " normalize=" << normalize << " keep_centered=" << keep_centered);
+					
+					pca_filter_control<pca_control<bool,bool,bool>,bool> ctrl {
+						{ true /* economy */, center, normalize },
+						keep_centered
+					};
+					
+					detail::pca_decomposition dec = detail::pca_decompose(distributed, ctrl.pca_control());
+					
+					/* one decomposition serves arbitrary many selections */
+					for(auto const& keep : keeps) {
+						auto reconstructed = to_local(detail::pca_reconstruct(dec, keep, keep_centered));
+						HBRS_MPL_LOG_TRIVIAL(trace) << "reconstructed:" << loggable{reconstructed};
+						
+						if (!normalize) {
+							// NOTE: in our data matrix, rows correspond to variables and columns correspond to
+							//       observations, but in pca it is vice versa.
+							auto filtered = pca_filter(transpose(distributed), keep, ctrl);
+							auto expected = to_local(transpose(filtered.data()));
+							HBRS_MPL_TEST_MMEQ(expected, reconstructed, false);
+							
+							std::vector<double> latent = hana::to<hana::ext::std::vector_tag>(filtered.latent());
+							BOOST_TEST(latent == dec.latent(), tt::per_element());
+						}
+						
+						if (keep(0) && keep(1) && !(center && keep_centered)) {
+							/* all principal components kept, hence original data must be restored */
+							HBRS_MPL_TEST_MMEQ(dataset, reconstructed, false);
+						}
+					}
+				}
+			}
+		}
+		++dataset_nr;
+	});
+	#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+}
+
+BOOST_AUTO_TEST_CASE(decompose_gram,
+	* utf::precondition(hbrs::theta_utils::detail::mpi_world_size_condition{{0,5}})
+	* utf::tolerance(_TOL)
+) {
+	using namespace hbrs::mpl;
+	namespace detail = hbrs::theta_utils::detail;
+	namespace mpi = hbrs::mpl::detail::mpi;
+	namespace hana = boost::hana;
+	using namespace hbrs::theta_utils;
+	
+	static constexpr auto datasets = hana::make_tuple(
+		make_sm(
+			make_ctsav(mpl::detail::mat_a), 
+			make_matrix_size(hana::size_c<mpl::detail::mat_a_m>, hana::size_c<mpl::detail::mat_a_n>),
+			row_major_c
+		),
+		make_sm(
+			make_ctsav(mpl::detail::mat_l),
+			make_matrix_size(hana::size_c<mpl::detail::mat_l_m>, hana::size_c<mpl::detail::mat_l_n>),
+			row_major_c
+		)
+	);
+	
+	#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+	typedef detail::theta_field_distribution_2 dist_t;
+	
+	std::size_t dataset_nr = 0;
+	hana::for_each(datasets, [&dataset_nr](auto const& dataset) {
+		BOOST_TEST_MESSAGE("dataset_nr=" << dataset_nr);
+		
+		theta_field_matrix series = make_theta_field_matrix(
+			rtsam<double, storage_order::row_major>{(*size)(dataset)}
+		);
+		detail::copy_matrix(make_el_matrix(dataset), series);
+		auto series_sz = series.size();
+		
+		for(bool center : { true, false }) {
+			for(bool normalize : { true, false }) {
+				BOOST_TEST_MESSAGE("center=" << center << " normalize=" << normalize);
+				pca_control<bool,bool,bool> ctrl{ true /* economy */, center, normalize };
+				
+				/* reference: svd of distributed data matrix */
+				detail::pca_decomposition dec = detail::pca_decompose(
+					detail::scatter(series, detail::scatter_control<dist_t>{{}}), ctrl);
+				
+				/* method of snapshots: gram matrix of local data summed over all processes */
+				El::Matrix<double> local = hana::to<el_matrix_tag>(series).data();
+				El::Matrix<double> mean, scale;
+				detail::standardize_rows(local, ctrl, mean, scale);
+				
+				El::Int n = local.Width();
+				El::Matrix<double> gram{n, n}, gbl_gram{n, n};
+				El::Gemm(El::TRANSPOSE, El::NORMAL, 1., local, local, 0., gram);
+				mpi::allreduce(gram.LockedBuffer(), gbl_gram.Buffer(), n*n, MPI_SUM, MPI_COMM_WORLD);
+				
+				std::size_t lcl_m = series_sz.m(), gbl_m;
+				mpi::allreduce(&lcl_m, &gbl_m, 1, MPI_SUM, MPI_COMM_WORLD);
+				
+				detail::pca_gram_decomposition gram_dec = detail::pca_decompose_gram(gbl_gram, gbl_m, ctrl);
+				
+				BOOST_TEST(gram_dec.latent() == dec.latent(), tt::per_element());
+				
+				std::function<bool(std::size_t)> first = [](std::size_t i) { return i == 0; };
+				El::Matrix<double> filtered{local.Height(), n};
+				El::Gemm(El::NORMAL, El::NORMAL, 1., local, detail::pca_gram_projector(gram_dec, first), 0., filtered);
+				detail::destandardize_rows(filtered, mean, scale, true);
+				
+				theta_field_matrix expected = detail::gather(
+					detail::pca_reconstruct(dec, first, false),
+					detail::gather_control<
+						dist_t,
+						matrix_size<std::size_t, std::size_t>
+					>{{}, series_sz}
+				);
+				
+				HBRS_MPL_TEST_MMEQ(hana::to<el_matrix_tag>(expected), el_matrix<double>{filtered}, false);
+			}
+		}
+		++dataset_nr;
+	});
+	#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+}
+
+BOOST_AUTO_TEST_CASE(incremental_svd,
+	* utf::precondition(hbrs::theta_utils::detail::mpi_world_size_condition{{0,5}})
+	* utf::tolerance(_TOL)
+) {
+	using namespace hbrs::mpl;
+	namespace detail = hbrs::theta_utils::detail;
+	namespace hana = boost::hana;
+	using namespace hbrs::theta_utils;
+	
+	static constexpr auto datasets = hana::make_tuple(
+		make_sm(
+			make_ctsav(mpl::detail::mat_a), 
+			make_matrix_size(hana::size_c<mpl::detail::mat_a_m>, hana::size_c<mpl::detail::mat_a_n>),
+			row_major_c
+		),
+		make_sm(
+			make_ctsav(mpl::detail::mat_e),
+			make_matrix_size(hana::size_c<mpl::detail::mat_e_m>, hana::size_c<mpl::detail::mat_e_n>),
+			row_major_c
+		),
+		make_sm(
+			make_ctsav(mpl::detail::mat_l),
+			make_matrix_size(hana::size_c<mpl::detail::mat_l_m>, hana::size_c<mpl::detail::mat_l_n>),
+			row_major_c
+		)
+	);
+	
+	#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+	std::size_t dataset_nr = 0;
+	hana::for_each(datasets, [&dataset_nr](auto const& dataset) {
+		BOOST_TEST_MESSAGE("dataset_nr=" << dataset_nr);
+		
+		El::Matrix<double> data = make_el_matrix(dataset).data();
+		El::Int const n = data.Width();
+		
+		for(El::Int chunk : { El::Int{1}, El::Int{2}, n }) {
+			BOOST_TEST_MESSAGE("chunk=" << chunk);
+			
+			/* every process appends its copy of the data matrix, hence rows are distributed */
+			detail::incremental_svd svd{ {}, {}, {} };
+			for(El::Int j = 0; j < n; j += chunk) {
+				El::Matrix<double> columns;
+				El::Copy(data(El::ALL, El::IR(j, std::min(j+chunk, n))), columns);
+				svd = detail::update_incremental_svd(std::move(svd), columns);
+			}
+			
+			El::Int const k = svd.singular_values().Height();
+			BOOST_TEST(svd.right().Height() == n);
+			BOOST_TEST(k <= std::min(data.Height(), n));
+			
+			for(El::Int i = 1; i < k; ++i) {
+				BOOST_TEST(svd.singular_values().Get(i-1, 0) >= svd.singular_values().Get(i, 0));
+			}
+			
+			El::Matrix<double> left{svd.left()}, reconstructed{data.Height(), n};
+			El::DiagonalScale(El::RIGHT, El::NORMAL, svd.singular_values(), left);
+			El::Gemm(El::NORMAL, El::TRANSPOSE, 1., left, svd.right(), 0., reconstructed);
+			HBRS_MPL_TEST_MMEQ(make_el_matrix(data), make_el_matrix(reconstructed), false);
+			
+			/* right singular vectors are orthonormal */
+			El::Matrix<double> VtV{k, k};
+			El::Gemm(El::TRANSPOSE, El::NORMAL, 1., svd.right(), svd.right(), 0., VtV);
+			for(El::Int i = 0; i < k; ++i) {
+				for(El::Int j = 0; j < k; ++j) {
+					BOOST_TEST(std::abs(VtV.Get(i, j) - (i == j ? 1. : 0.)) < _TOL);
+				}
+			}
+		}
+		++dataset_nr;
+	});
+	#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+}
+
+BOOST_AUTO_TEST_CASE(decompose_randomized,
+	* utf::precondition(hbrs::theta_utils::detail::mpi_world_size_condition{{0,5}})
+	* utf::tolerance(_TOL)
+) {
+	using namespace hbrs::mpl;
+	namespace detail = hbrs::theta_utils::detail;
+	namespace hana = boost::hana;
+	using namespace hbrs::theta_utils;
+	
+	static constexpr auto datasets = hana::make_tuple(
+		make_sm(
+			make_ctsav(mpl::detail::mat_a), 
+			make_matrix_size(hana::size_c<mpl::detail::mat_a_m>, hana::size_c<mpl::detail::mat_a_n>),
+			row_major_c
+		),
+		make_sm(
+			make_ctsav(mpl::detail::mat_l),
+			make_matrix_size(hana::size_c<mpl::detail::mat_l_m>, hana::size_c<mpl::detail::mat_l_n>),
+			row_major_c
+		)
+	);
+	
+	#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+	typedef detail::theta_field_distribution_2 dist_t;
+	
+	std::size_t dataset_nr = 0;
+	hana::for_each(datasets, [&dataset_nr](auto const& dataset) {
+		BOOST_TEST_MESSAGE("dataset_nr=" << dataset_nr);
+		
+		theta_field_matrix series = make_theta_field_matrix(
+			rtsam<double, storage_order::row_major>{(*size)(dataset)}
+		);
+		detail::copy_matrix(make_el_matrix(dataset), series);
+		auto series_sz = series.size();
+		
+		auto to_local = [&series_sz](auto && dist) {
+			return hana::to<el_matrix_tag>(detail::gather(
+				HBRS_MPL_FWD(dist),
+				detail::gather_control<
+					dist_t,
+					matrix_size<std::size_t, std::size_t>
+				>{{}, series_sz}
+			));
+		};
+		
+		std::function<bool(std::size_t)> all = [](std::size_t) { return true; };
+		
+		for(bool center : { true, false }) {
+			pca_control<bool,bool,bool> ctrl{ true /* economy */, center, false /* normalize */ };
+			
+			detail::pca_decomposition exact = detail::pca_decompose(
+				detail::scatter(series, detail::scatter_control<dist_t>{{}}), ctrl);
+			auto expected = to_local(detail::pca_reconstruct(exact, all, false));
+			
+			/* sketch of full rank spans the range of the data matrix, hence the decomposition is exact */
+			for(std::size_t oversampling : { 0, 5 }) {
+				for(std::size_t power_iterations : { 0, 2 }) {
+					BOOST_TEST_MESSAGE(
+						"center=" << center << " oversampling=" << oversampling
+						<< " power_iterations=" << power_iterations);
+					
+					detail::pca_decomposition randomized = detail::pca_decompose_randomized(
+						detail::scatter(series, detail::scatter_control<dist_t>{{}}),
+						ctrl,
+						{ series_sz.n(), oversampling, power_iterations }
+					);
+					
+					BOOST_TEST(randomized.latent() == exact.latent(), tt::per_element());
+					HBRS_MPL_TEST_MMEQ(
+						expected, to_local(detail::pca_reconstruct(randomized, all, false)), false);
+				}
+			}
+			
+			/* truncated sketch yields leading principal components only */
+			detail::pca_decomposition leading = detail::pca_decompose_randomized(
+				detail::scatter(series, detail::scatter_control<dist_t>{{}}), ctrl, { 1, 5, 2 });
+			BOOST_TEST(leading.latent().size() == 1u);
+			BOOST_TEST(leading.coeff().Width() == 1);
+		}
+		++dataset_nr;
+	});
+	#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+}
+
+
+BOOST_AUTO_TEST_CASE(incremental_pca,
+	* utf::precondition(hbrs::theta_utils::detail::mpi_world_size_condition{{0,5}})
+	* utf::tolerance(_TOL)
+) {
+	using namespace hbrs::mpl;
+	namespace detail = hbrs::theta_utils::detail;
+	namespace hana = boost::hana;
+	using namespace hbrs::theta_utils;
+	namespace mpi = hbrs::mpl::detail::mpi;
+	
+	static constexpr auto datasets = hana::make_tuple(
+		make_sm(
+			make_ctsav(mpl::detail::mat_a), 
+			make_matrix_size(hana::size_c<mpl::detail::mat_a_m>, hana::size_c<mpl::detail::mat_a_n>),
+			row_major_c
+		),
+		make_sm(
+			make_ctsav(mpl::detail::mat_l),
+			make_matrix_size(hana::size_c<mpl::detail::mat_l_m>, hana::size_c<mpl::detail::mat_l_n>),
+			row_major_c
+		)
+	);
+	
+	#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+	std::size_t dataset_nr = 0;
+	hana::for_each(datasets, [&dataset_nr](auto const& dataset) {
+		BOOST_TEST_MESSAGE("dataset_nr=" << dataset_nr);
+		
+		El::Matrix<double> const data = make_el_matrix(dataset).data();
+		El::Int const n = data.Width();
+		
+		for(bool center : { true, false }) {
+			for(bool normalize : { true, false }) {
+				BOOST_TEST_MESSAGE("center=" << center << " normalize=" << normalize);
+				pca_control<bool,bool,bool> const ctrl{ true, center, normalize };
+				
+				El::Matrix<double> standardized{data}, mean, scale;
+				detail::standardize_rows(standardized, ctrl, mean, scale);
+				
+				/* every process appends its copy of the data matrix, hence singular values grow with sqrt(p) */
+				El::Matrix<double> A{standardized}, s_ref;
+				El::SVD(A, s_ref);
+				El::Scale(std::sqrt(static_cast<double>(mpi::comm_size())), s_ref);
+				
+				for(El::Int chunk : { El::Int{1}, El::Int{2}, n }) {
+					for(std::size_t rank : { std::size_t{0}, std::size_t{1} }) {
+						BOOST_TEST_MESSAGE("chunk=" << chunk << " rank=" << rank);
+						
+						detail::incremental_svd svd{ {}, {}, {} };
+						detail::row_moments moments{ 0, {}, {} };
+						El::Matrix<double> columns;
+						for(El::Int j = 0; j < n; j += chunk) {
+							El::Copy(data(El::ALL, El::IR(j, std::min(j+chunk, n))), columns);
+							detail::update_incremental_pca(columns, ctrl, rank, svd, moments);
+						}
+						
+						BOOST_TEST(moments.count() == static_cast<std::size_t>(n));
+						
+						/* the last chunk has been standardized like the complete data matrix */
+						El::Matrix<double> expected;
+						El::Copy(standardized(El::ALL, El::IR(n - columns.Width(), n)), expected);
+						HBRS_MPL_TEST_MMEQ(make_el_matrix(expected), make_el_matrix(columns), false);
+						
+						El::Int const k = svd.singular_values().Height();
+						BOOST_TEST(k <= std::min(data.Height(), n));
+						if (rank > 0) {
+							BOOST_TEST(k <= static_cast<El::Int>(rank));
+						}
+						
+						for(El::Int i = 0; i < k; ++i) {
+							double const error = std::abs(svd.singular_values().Get(i, 0) - s_ref.Get(i, 0));
+							BOOST_TEST(error <= 1e-6 * s_ref.Get(0, 0));
+						}
+						
+						if (rank == 0) {
+							/* selecting all principal components reproduces the standardized data */
+							El::Matrix<double> filtered = detail::incremental_svd_filter(
+								svd, standardized, [](std::size_t) { return true; });
+							HBRS_MPL_TEST_MMEQ(make_el_matrix(standardized), make_el_matrix(filtered), false);
+						}
+					}
+				}
+			}
+		}
+		++dataset_nr;
+	});
+	#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -29,11 +29,11 @@
 
 #include <hbrs/mpl/detail/mpi.hpp>
 #include <hbrs/mpl/detail/log.hpp>
-#include <hbrs/theta_utils/detail/iff.hpp>
 
 #include <boost/numeric/conversion/cast.hpp>
 #include <boost/assert.hpp>
 #include <algorithm>
+#include <numeric>
 
 HBRS_THETA_UTILS_NAMESPACE_BEGIN
 namespace mpi = hbrs::mpl::detail::mpi;
@@ -45,8 +45,15 @@ distributed_size(
 	theta_field_matrix const& series,
 	theta_field_distribution_1
 ) {
-	auto lcl_sz = series.size();
-	
+	return distributed_size(series.size(), theta_field_distribution_1{});
+}
+
+HBRS_THETA_UTILS_API
+mpl::matrix_size<std::size_t, std::size_t>
+distributed_size(
+	mpl::matrix_size<std::size_t, std::size_t> const& lcl_sz,
+	theta_field_distribution_1
+) {
 	if (mpi::comm_size() == 1) {
 		return lcl_sz;
 	}
@@ -73,8 +80,15 @@ distributed_size(
 	theta_field_matrix const& series,
 	theta_field_distribution_2
 ) {
-	auto lcl_sz = series.size();
-	
+	return distributed_size(series.size(), theta_field_distribution_2{});
+}
+
+HBRS_THETA_UTILS_API
+mpl::matrix_size<std::size_t, std::size_t>
+distributed_size(
+	mpl::matrix_size<std::size_t, std::size_t> const& lcl_sz,
+	theta_field_distribution_2
+) {
 	if (mpi::comm_size() == 1) {
 		return lcl_sz;
 	}
@@ -96,8 +110,270 @@ distributed_size(
 	return { gbl_max_m * mpi::comm_size(), gbl_max_n };
 }
 
+HBRS_THETA_UTILS_API
+theta_field_distribution_3
+make_theta_field_distribution_3(mpl::matrix_size<std::size_t, std::size_t> const& lcl_sz) {
+	using hbrs::mpl::detail::loggable;
+	std::size_t mpi_sz = boost::numeric_cast<std::size_t>(mpi::comm_size());
+	std::size_t mpi_rank = boost::numeric_cast<std::size_t>(mpi::comm_rank());
+	
+	std::size_t lcl_n = lcl_sz.n();
+	std::size_t gbl_min_n, gbl_max_n;
+	mpi::allreduce(&lcl_n, &gbl_min_n, 1, MPI_MIN, MPI_COMM_WORLD);
+	mpi::allreduce(&lcl_n, &gbl_max_n, 1, MPI_MAX, MPI_COMM_WORLD);
+	
+	if(gbl_min_n != gbl_max_n) {
+		BOOST_THROW_EXCEPTION((mpl::incompatible_matrix_exception{} << mpl::errinfo_matrix_size{lcl_sz}));
+	}
+	
+	theta_field_distribution_3 dist {
+		std::vector<std::size_t>(mpi_sz, 0u) /* domain_ms */,
+		std::vector<std::size_t>(mpi_sz, 0u) /* local_ms */,
+		std::vector<std::size_t>(mpi_sz, 0u) /* send_counts */,
+		std::vector<std::size_t>(mpi_sz, 0u) /* recv_counts */
+	};
+	
+	std::size_t lcl_m = lcl_sz.m();
+	mpi::allgather(&lcl_m, 1, dist.domain_ms.data(), 1, MPI_COMM_WORLD);
+	std::size_t gbl_m = std::accumulate(dist.domain_ms.begin(), dist.domain_ms.end(), std::size_t{0});
+	
+	std::vector<std::size_t> surplus(mpi_sz, 0u), deficit(mpi_sz, 0u);
+	for(std::size_t p = 0; p < mpi_sz; ++p) {
+		dist.local_ms[p] = round_robin_count(0, gbl_m, p, mpi_sz);
+		if (dist.domain_ms[p] > dist.local_ms[p]) {
+			surplus[p] = dist.domain_ms[p] - dist.local_ms[p];
+		} else {
+			deficit[p] = dist.local_ms[p] - dist.domain_ms[p];
+		}
+	}
+	
+	// match surplus rows with free local rows, both ordered by process, identically on all processes
+	for(std::size_t src = 0, dst = 0; src < mpi_sz && dst < mpi_sz;) {
+		std::size_t rows = std::min(surplus[src], deficit[dst]);
+		if (src == mpi_rank) {
+			dist.send_counts[dst] += rows;
+		}
+		if (dst == mpi_rank) {
+			dist.recv_counts[src] += rows;
+		}
+		surplus[src] -= rows;
+		deficit[dst] -= rows;
+		
+		if (surplus[src] == 0) {
+			++src;
+		}
+		if (deficit[dst] == 0) {
+			++dst;
+		}
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(trace) << "domain_ms:" << loggable{dist.domain_ms} << "@mpi_rank:" << mpi_rank;
+	HBRS_MPL_LOG_TRIVIAL(trace) << "local_ms:" << loggable{dist.local_ms} << "@mpi_rank:" << mpi_rank;
+	HBRS_MPL_LOG_TRIVIAL(trace) << "send_counts:" << loggable{dist.send_counts} << "@mpi_rank:" << mpi_rank;
+	HBRS_MPL_LOG_TRIVIAL(trace) << "recv_counts:" << loggable{dist.recv_counts} << "@mpi_rank:" << mpi_rank;
+	return dist;
+}
+
+HBRS_THETA_UTILS_API
+mpl::matrix_size<std::size_t, std::size_t>
+distributed_size(
+	mpl::matrix_size<std::size_t, std::size_t> const& lcl_sz,
+	theta_field_distribution_3 const& dist
+) {
+	return {
+		std::accumulate(dist.domain_ms.begin(), dist.domain_ms.end(), std::size_t{0}),
+		lcl_sz.n()
+	};
+}
+
+HBRS_THETA_UTILS_API
+std::size_t
+round_robin_count(std::size_t first, std::size_t last, std::size_t rank, std::size_t size) {
+	BOOST_ASSERT(first <= last);
+	BOOST_ASSERT(rank < size);
+	// number of rows in [0, x) which are assigned to rank
+	auto const count = [rank, size](std::size_t x) { return x / size + (rank < x % size ? 1u : 0u); };
+	return count(last) - count(first);
+}
+
+HBRS_THETA_UTILS_API
+std::vector<double>
+alltoallv_rows(
+	std::vector<double> const& send,
+	std::vector<std::size_t> const& send_counts,
+	std::vector<std::size_t> const& recv_counts,
+	std::size_t row_length,
+	MPI_Comm comm
+) {
+	// rows are sent as a derived datatype, so counts and displacements are numbers of rows instead of numbers of
+	// doubles which would overflow int much earlier
+	auto const to_int = [](std::vector<std::size_t> const& counts, std::vector<int> & ints, std::vector<int> & displs) {
+		ints.resize(counts.size());
+		displs.resize(counts.size());
+		std::size_t displ = 0;
+		for(std::size_t i = 0; i < counts.size(); ++i) {
+			ints[i] = boost::numeric_cast<int>(counts[i]);
+			displs[i] = boost::numeric_cast<int>(displ);
+			displ += counts[i];
+		}
+		return displ;
+	};
+	
+	std::vector<int> send_counts_, send_displs, recv_counts_, recv_displs;
+	[[maybe_unused]] std::size_t const send_rows = to_int(send_counts, send_counts_, send_displs);
+	std::size_t const recv_rows = to_int(recv_counts, recv_counts_, recv_displs);
+	BOOST_ASSERT(send.size() == send_rows * row_length);
+	
+	std::vector<double> recv(recv_rows * row_length);
+	
+	MPI_Datatype row;
+	MPI_Type_contiguous(boost::numeric_cast<int>(row_length), MPI_DOUBLE, &row);
+	MPI_Type_commit(&row);
+	
+	MPI_Alltoallv(
+		send.data(), send_counts_.data(), send_displs.data(), row,
+		recv.data(), recv_counts_.data(), recv_displs.data(), row,
+		comm
+	);
+	
+	MPI_Type_free(&row);
+	return recv;
+}
+
 #ifdef HBRS_MPL_ENABLE_ELEMENTAL
 
+HBRS_THETA_UTILS_API
+std::shared_ptr<El::Grid const>
+make_process_grid(std::size_t height) {
+	if (height == 0) {
+		return std::make_shared<El::Grid const>(El::mpi::COMM_WORLD);
+	}
+	
+	BOOST_ASSERT(mpi::comm_size() % height == 0);
+	return std::make_shared<El::Grid const>(El::mpi::COMM_WORLD, boost::numeric_cast<int>(height));
+}
+
+namespace {
+
+/* Global row and column indices of a [MC,MR] distributed matrix are assigned to process rows and columns of the grid
+ * round robin. Domains are concatenated in order of processes, like with theta_field_distribution_1.
+ */
+struct grid_plan {
+	grid_plan(El::Grid const& grid, std::size_t lcl_m, std::size_t n)
+	: height{boost::numeric_cast<std::size_t>(grid.Height())},
+	  width{boost::numeric_cast<std::size_t>(grid.Width())},
+	  n{n},
+	  mpi_sz{boost::numeric_cast<std::size_t>(mpi::comm_size())},
+	  mpi_rank{boost::numeric_cast<std::size_t>(mpi::comm_rank())},
+	  lcl_ms(mpi_sz, 0u), lcl_ms_sums(mpi_sz, 0u),
+	  grid_rows(mpi_sz, 0u), grid_cols(mpi_sz, 0u) {
+		BOOST_ASSERT(height * width == mpi_sz);
+		mpi::allgather(&lcl_m, 1, lcl_ms.data(), 1, MPI_COMM_WORLD);
+		std::partial_sum(lcl_ms.begin(), lcl_ms.end(), lcl_ms_sums.begin());
+		
+		// vc rank of process (i,j) of the grid is i+j*height, grid is defined on MPI_COMM_WORLD
+		for(std::size_t i = 0; i < height; ++i) {
+			for(std::size_t j = 0; j < width; ++j) {
+				std::size_t rank = boost::numeric_cast<std::size_t>(grid.VCToViewing((int)(i + j*height)));
+				grid_rows.at(rank) = i;
+				grid_cols.at(rank) = j;
+			}
+		}
+	}
+	
+	std::size_t
+	first_row(std::size_t rank) const { return lcl_ms_sums[rank] - lcl_ms[rank]; }
+	
+	std::size_t
+	last_row(std::size_t rank) const { return lcl_ms_sums[rank]; }
+	
+	/* number of rows of domain of process src which are stored at process dst */
+	std::size_t
+	count(std::size_t src, std::size_t dst) const {
+		return round_robin_count(first_row(src), last_row(src), grid_rows[dst], height);
+	}
+	
+	/* largest number of local columns of all processes */
+	std::size_t
+	max_width() const {
+		return (n + width - 1) / width;
+	}
+	
+	std::size_t height, width, n, mpi_sz, mpi_rank;
+	std::vector<std::size_t> lcl_ms, lcl_ms_sums;
+	// process row and process column of each process
+	std::vector<std::size_t> grid_rows, grid_cols;
+};
+
+mpl::el_dist_matrix<double, El::MC, El::MR, El::ELEMENT>
+scatter_to_grid(El::Matrix<double> const& from, El::Grid const& grid) {
+	using std::size_t;
+	
+	size_t const lcl_m = boost::numeric_cast<size_t>(from.Height());
+	mpl::matrix_size<size_t, size_t> gbl_sz = distributed_size(
+		mpl::matrix_size<size_t, size_t>{lcl_m, boost::numeric_cast<size_t>(from.Width())},
+		theta_field_distribution_1{}
+	);
+	grid_plan const plan{grid, lcl_m, gbl_sz.n()};
+	
+	mpl::el_dist_matrix<double, El::MC, El::MR, El::ELEMENT> to{
+		grid,
+		boost::numeric_cast<El::Int>(gbl_sz.m()),
+		boost::numeric_cast<El::Int>(gbl_sz.n())
+	};
+	El::Matrix<double> & to_lcl = to.data().Matrix();
+	BOOST_ASSERT(to.data().ColShift() == (El::Int)plan.grid_rows[plan.mpi_rank]);
+	BOOST_ASSERT(to.data().RowShift() == (El::Int)plan.grid_cols[plan.mpi_rank]);
+	
+	std::vector<size_t> send_counts(plan.mpi_sz), recv_counts(plan.mpi_sz), offsets(plan.mpi_sz, 0u);
+	for(size_t p = 0; p < plan.mpi_sz; ++p) {
+		send_counts[p] = plan.count(plan.mpi_rank, p);
+		recv_counts[p] = plan.count(p, plan.mpi_rank);
+	}
+	std::partial_sum(send_counts.begin(), send_counts.end() - 1, offsets.begin() + 1);
+	
+	// process at each position of the grid, stored row by row
+	std::vector<size_t> procs(plan.mpi_sz);
+	for(size_t p = 0; p < plan.mpi_sz; ++p) {
+		procs[plan.grid_rows[p] * plan.width + plan.grid_cols[p]] = p;
+	}
+	
+	// values for each process are packed as rows of its local matrix in ascending order of global rows and columns.
+	// Rows are padded to the largest local width, so a single row datatype fits all processes and counts passed to
+	// alltoallv_rows() are numbers of rows instead of numbers of values which would overflow int much earlier.
+	size_t const row_length = plan.max_width();
+	double const* from_buf = from.LockedBuffer();
+	size_t const from_ldim = boost::numeric_cast<size_t>(from.LDim());
+	// each local row is sent to all processes of its process row
+	BOOST_ASSERT(std::accumulate(send_counts.begin(), send_counts.end(), size_t{0}) == lcl_m * plan.width);
+	std::vector<double> send(lcl_m * plan.width * row_length, 0.);
+	for(size_t i = 0; i < lcl_m; ++i) {
+		size_t const grid_row = (plan.first_row(plan.mpi_rank) + i) % plan.height;
+		for(size_t c = 0; c < plan.width; ++c) {
+			double * row = send.data() + row_length * offsets[procs[grid_row * plan.width + c]]++;
+			for(size_t j = c; j < plan.n; j += plan.width) {
+				*row++ = from_buf[i + j * from_ldim];
+			}
+		}
+	}
+	
+	// rows received from all processes in order of processes are in ascending order of global rows
+	std::vector<double> recv = alltoallv_rows(send, send_counts, recv_counts, row_length, MPI_COMM_WORLD);
+	size_t const lcl_width = boost::numeric_cast<size_t>(to_lcl.Width());
+	BOOST_ASSERT(lcl_width <= row_length);
+	BOOST_ASSERT(recv.size() == (size_t)to_lcl.Height() * row_length);
+	for(size_t l = 0; l < lcl_width; ++l) {
+		double * col = to_lcl.Buffer(0, (El::Int)l);
+		for(size_t k = 0; k < (size_t)to_lcl.Height(); ++k) {
+			col[k] = recv[k * row_length + l];
+		}
+	}
+	
+	return to;
+}
+
+/* unnamed namespace */ }
+
 HBRS_THETA_UTILS_API
 mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT>
 scatter(
@@ -206,130 +482,54 @@ scatter(
 	size_t gbl_m = lcl_ms_sums.back();
 	HBRS_MPL_LOG_TRIVIAL(trace) << "gbl_m:" << gbl_m << "@mpi_rank:" << mpi_rank;
 	
-	size_t balanced_chunk_size = gbl_m / mpi_sz; // integer division
-	size_t nr_of_bigger_chunks = gbl_m % mpi_sz; // number of processes that get chunks of size=chunk_size+1
-	size_t nr_of_normal_chunks = mpi_sz - nr_of_bigger_chunks;
-	BOOST_ASSERT((nr_of_bigger_chunks+nr_of_normal_chunks) == mpi_sz);
+	El::DistMatrix<double, El::VC, El::STAR, El::ELEMENT> & gbl_to = to.data();
+	El::Matrix<double> & lcl_to = gbl_to.Matrix();
+	// round robin distribution, i.e. local row k of process p is global row k*mpi_sz+p
+	BOOST_ASSERT(gbl_to.ColShift() == (El::Int)mpi_rank);
+	BOOST_ASSERT(gbl_to.ColStride() == (El::Int)mpi_sz);
 	
-	std::vector<size_t> bal_lcl_ms(mpi_sz, 0u);
-	for(size_t i = 0; i < nr_of_bigger_chunks; ++i) {
-		bal_lcl_ms.at(i) = balanced_chunk_size+1;
-	}
-	for(size_t i = nr_of_bigger_chunks; i < mpi_sz; ++i) {
-		bal_lcl_ms.at(i) = balanced_chunk_size;
+	/* Plan the redistribution per process instead of per row: process p sends its rows with gbl_row % mpi_sz == q to
+	 * process q. Rows for each destination are packed in ascending order of global rows, so rows received from all
+	 * sources, ordered by source, are already in the order of local rows of the receiving process.
+	 */
+	size_t const first_row = lcl_ms_sums.at(mpi_rank) - lcl_m;
+	std::vector<size_t> send_counts(mpi_sz, 0u), recv_counts(mpi_sz, 0u);
+	for(size_t p = 0; p < mpi_sz; ++p) {
+		send_counts[p] = round_robin_count(first_row, first_row + lcl_m, p, mpi_sz);
+		recv_counts[p] = round_robin_count(lcl_ms_sums[p] - lcl_ms[p], lcl_ms_sums[p], mpi_rank, mpi_sz);
 	}
-	std::vector<size_t> bal_lcl_ms_sums(mpi_sz, 0u);
-	std::partial_sum(bal_lcl_ms.begin(), bal_lcl_ms.end(), bal_lcl_ms_sums.begin());
-	
-	HBRS_MPL_LOG_TRIVIAL(trace) << "bal_lcl_ms:" << loggable{bal_lcl_ms} << "@mpi_rank:" << mpi_rank;
-	HBRS_MPL_LOG_TRIVIAL(trace) << "bal_lcl_ms_sums:" << loggable{bal_lcl_ms_sums} << "@mpi_rank:" << mpi_rank;
-	
-	size_t bal_lcl_m = bal_lcl_ms.at(mpi_rank);
-	mpl::rtsam<double, mpl::storage_order::row_major> bal_lcl_to =
-		{ mpl::make_matrix_size(bal_lcl_m, lcl_n) };
+	HBRS_MPL_LOG_TRIVIAL(trace) << "send_counts:" << loggable{send_counts} << "@mpi_rank:" << mpi_rank;
+	HBRS_MPL_LOG_TRIVIAL(trace) << "recv_counts:" << loggable{recv_counts} << "@mpi_rank:" << mpi_rank;
 	
+	// row of the send buffer for each local row
+	std::vector<size_t> send_rows(lcl_m);
 	{
-		mpl::rtsam<double, mpl::storage_order::row_major> lcl_to =
-			copy_matrix(from, mpl::rtsam<double, mpl::storage_order::row_major>{lcl_sz});
-		std::vector<MPI_Request> reqs;
-		for(size_t gbl_row = 0; gbl_row<gbl_m; ++gbl_row) {
-			size_t send_proc = std::distance(
-				lcl_ms_sums.begin(),
-				std::lower_bound(lcl_ms_sums.begin(), lcl_ms_sums.end(), gbl_row+1)
-			);
-			
-			// block distribution
-// 			size_t recv_proc = std::distance(
-// 				bal_lcl_ms_sums.begin(),
-// 				std::lower_bound(bal_lcl_ms_sums.begin(), bal_lcl_ms_sums.end(), gbl_row)
-// 			);
-			// round robin distribution
-			size_t recv_proc = gbl_row % mpi_sz;
-			
-			
-			size_t lcl_send_row = (send_proc == 0) ? gbl_row : (gbl_row - lcl_ms_sums.at(send_proc-1));
-			// block distribution
-// 			size_t lcl_recv_row = (recv_proc == 0) ? gbl_row : (gbl_row - bal_lcl_ms_sums.at(recv_proc-1));
-			// round robin distribution
-			size_t lcl_recv_row = gbl_row / mpi_sz;
-			
-			HBRS_MPL_LOG_TRIVIAL(trace) << "gbl_row:" << gbl_row << ",send_proc:" << send_proc << ",recv_proc:" << recv_proc << "@mpi_rank:" << mpi_rank;
-			HBRS_MPL_LOG_TRIVIAL(trace) << "gbl_row:" << gbl_row << ",lcl_send_row:" << lcl_send_row << ",lcl_recv_row:" << lcl_recv_row << "@mpi_rank:" << mpi_rank;
-			
-			if ((send_proc == recv_proc) && (send_proc == mpi_rank)) {
-				HBRS_MPL_LOG_TRIVIAL(trace) << "gbl_row:" << gbl_row << ", COPY" << "@mpi_rank:" << mpi_rank;
-				
-				double const& lcl_send_ref = lcl_to.at(mpl::make_matrix_index(lcl_send_row, 0));
-				double      & lcl_recv_ref = bal_lcl_to.at(mpl::make_matrix_index(lcl_recv_row, 0));
-				std::copy_n(&lcl_send_ref, lcl_n, &lcl_recv_ref);
-				
-			} else if (send_proc == mpi_rank) {
-				HBRS_MPL_LOG_TRIVIAL(trace) << "gbl_row:" << gbl_row << ", SEND_ROW" << "@mpi_rank:" << mpi_rank;
-				
-				double const& lcl_send_ref = lcl_to.at(mpl::make_matrix_index(lcl_send_row, 0));
-				reqs.push_back(
-					mpi::isend(
-						&lcl_send_ref,
-						lcl_n,
-						recv_proc /*dest*/,
-						send_proc /*tag*/,
-						MPI_COMM_WORLD
-					)
-				);
-			} else if (recv_proc == mpi_rank) {
-				HBRS_MPL_LOG_TRIVIAL(trace) << "gbl_row:" << gbl_row << ", RECV_ROW" << "@mpi_rank:" << mpi_rank;
-				
-				double & lcl_recv_ref = bal_lcl_to.at(mpl::make_matrix_index(lcl_recv_row, 0));
-				reqs.push_back(
-					mpi::irecv(
-						&lcl_recv_ref,
-						lcl_n,
-						send_proc /*source*/,
-						send_proc /*tag*/,
-						MPI_COMM_WORLD
-					)
-				);
-			} else {
-				HBRS_MPL_LOG_TRIVIAL(trace) << "gbl_row:" << gbl_row << ", SKIP" << "@mpi_rank:" << mpi_rank;
-			}
-		}
-		
-		for(size_t i = 0; i < reqs.size(); ++i) {
-			HBRS_MPL_LOG_TRIVIAL(trace) << "reqs[" << i << "], WAIT_BEGIN" << "@mpi_rank:" << mpi_rank;
-			
-			[[maybe_unused]] auto stat = mpi::wait(reqs[i]);
-			//TODO: Do anything with stat?
-			HBRS_MPL_LOG_TRIVIAL(trace) << "reqs[" << i << "], WAIT_END" << "@mpi_rank:" << mpi_rank;
+		std::vector<size_t> offsets(mpi_sz, 0u);
+		std::partial_sum(send_counts.begin(), send_counts.end() - 1, offsets.begin() + 1);
+		for(size_t i = 0; i < lcl_m; ++i) {
+			send_rows[i] = offsets[(first_row + i) % mpi_sz]++;
 		}
 	}
 	
-	El::DistMatrix<double, El::VC, El::STAR, El::ELEMENT> & gbl_to = to.data();
-	El::Matrix<double> & lcl_to = gbl_to.Matrix();
+	std::vector<double> send(lcl_m * lcl_n);
+	for(size_t j = 0; j < lcl_n; ++j) {
+		theta_field const& field = from.data().at(j);
+		size_t const no_of_points = lcl_m/3;
+		for(size_t i = 0; i < no_of_points; ++i) {
+			send[send_rows[i] * lcl_n + j] = field.x_velocity()[i];
+			send[send_rows[i + no_of_points] * lcl_n + j] = field.y_velocity()[i];
+			send[send_rows[i + 2*no_of_points] * lcl_n + j] = field.z_velocity()[i];
+		}
+	}
 	
-	BOOST_ASSERT(gbl_to.Matrix().Height() == bal_lcl_to.size().m());
-	BOOST_ASSERT(gbl_to.Matrix().Width() == bal_lcl_to.size().n());
+	std::vector<double> recv = alltoallv_rows(send, send_counts, recv_counts, lcl_n, MPI_COMM_WORLD);
 	
-	for(size_t gbl_row = 0; gbl_row<gbl_m; ++gbl_row) {
-		size_t lcl_row = gbl_row / mpi_sz;
-		bool is_lcl_row = ((gbl_row % mpi_sz) == mpi_rank);
-		BOOST_ASSERT(iff(is_lcl_row, gbl_to.IsLocalRow(gbl_row)));
-		
-		if (is_lcl_row) {
-			HBRS_MPL_LOG_TRIVIAL(trace) << "lcl_row:" << lcl_row << "@mpi_rank:" << mpi_rank;
-			
-			for(size_t col = 0; col < lcl_n; ++col) {
-				BOOST_ASSERT(gbl_to.IsLocal(gbl_row, col));
-				
-				gbl_to.SetLocal(
-					gbl_to.LocalRow((El::Int)gbl_row),
-					gbl_to.LocalCol((El::Int)col),
-					bal_lcl_to.at(mpl::make_matrix_index(lcl_row, col))
-				);
-			}
+	BOOST_ASSERT(recv.size() == boost::numeric_cast<size_t>(lcl_to.Height()) * lcl_n);
+	for(size_t j = 0; j < lcl_n; ++j) {
+		double * col = lcl_to.Buffer(0, (El::Int)j);
+		for(size_t k = 0; k < (size_t)lcl_to.Height(); ++k) {
+			col[k] = recv[k * lcl_n + j];
 		}
-		
-		HBRS_MPL_LOG_TRIVIAL(trace) << "lcl_to:" << loggable{lcl_to} << "@mpi_rank:" << mpi_rank;
-		HBRS_MPL_LOG_TRIVIAL(trace) << "gbl_to:" << loggable{gbl_to} << "@mpi_rank:" << mpi_rank;
 	}
 	
 	HBRS_MPL_LOG_TRIVIAL(trace) << "DONE@mpi_rank:" << mpi_rank;
@@ -421,6 +621,187 @@ scatter(
 	
 	return to;
 }
+
+HBRS_THETA_UTILS_API
+mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT>
+scatter(
+	std::vector<theta_field_path> const& from,
+	scatter_control<theta_field_distribution_2>
+) {
+	using std::size_t;
+	
+	BOOST_ASSERT(!from.empty());
+	size_t const no_of_points = read_theta_field_size(from.at(0).full_path().string());
+	
+	mpl::matrix_size<size_t, size_t> lcl_sz{3 * no_of_points, from.size()};
+	mpl::matrix_size<size_t, size_t> gbl_sz = distributed_size(lcl_sz, theta_field_distribution_2{});
+	
+	static El::Grid const grid{};
+	mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT> to{
+		grid,
+		boost::numeric_cast<El::Int>(gbl_sz.m()),
+		boost::numeric_cast<El::Int>(gbl_sz.n())
+	};
+	
+	El::Matrix<double> & to_lcl = to.data().Matrix();
+	BOOST_ASSERT(lcl_sz.n() == to.size().n());
+	BOOST_ASSERT(lcl_sz.m() <= to_lcl.Height());
+	BOOST_ASSERT(gbl_sz.n() == to_lcl.Width());
+	
+	// if to-matrix is larger than the local fields then unused rows will just be zero, see scatter() above
+	if (lcl_sz.m() < to_lcl.Height()) {
+		decltype(auto) to_lcl_unused = to_lcl(El::IR(lcl_sz.m(), El::END), El::ALL);
+		El::Zero(to_lcl_unused);
+	}
+	
+	// columns of local matrix are contiguous, so each file is read into its column without any copies
+	for(size_t j = 0; j < from.size(); ++j) {
+		read_theta_velocities(from[j].full_path().string(), to_lcl.Buffer(0, (El::Int)j), no_of_points);
+	}
+	
+	return to;
+}
+
+HBRS_THETA_UTILS_API
+mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT>
+scatter(
+	theta_field_matrix const& from,
+	scatter_control<theta_field_distribution_3> const& ctrl
+) {
+	using std::size_t;
+	theta_field_distribution_3 const& dist = ctrl.algorithm;
+	
+	mpl::matrix_size<size_t, size_t> lcl_sz = from.size();
+	mpl::matrix_size<size_t, size_t> gbl_sz = distributed_size(lcl_sz, dist);
+	
+	static El::Grid const grid{};
+	mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT> to{
+		grid,
+		boost::numeric_cast<El::Int>(gbl_sz.m()),
+		boost::numeric_cast<El::Int>(gbl_sz.n())
+	};
+	
+	size_t mpi_rank = boost::numeric_cast<size_t>(mpi::comm_rank());
+	El::Matrix<double> & to_lcl = to.data().Matrix();
+	BOOST_ASSERT(lcl_sz.m() == dist.domain_ms.at(mpi_rank));
+	BOOST_ASSERT(dist.local_ms.at(mpi_rank) == (size_t)to_lcl.Height());
+	
+	El::Matrix<double> from_lcl = copy_matrix(
+		from, mpl::el_matrix<double>{ (El::Int)lcl_sz.m(), (El::Int)lcl_sz.n() }).data();
+	
+	size_t const kept = std::min(lcl_sz.m(), (size_t)to_lcl.Height());
+	decltype(auto) to_lcl_kept = to_lcl(El::IR(0, kept), El::ALL);
+	El::Copy(from_lcl(El::IR(0, kept), El::ALL), to_lcl_kept);
+	
+	std::vector<double> send((lcl_sz.m() - kept) * lcl_sz.n());
+	for(size_t j = 0; j < lcl_sz.n(); ++j) {
+		double const* col = from_lcl.LockedBuffer(0, (El::Int)j);
+		for(size_t i = kept; i < lcl_sz.m(); ++i) {
+			send[(i - kept) * lcl_sz.n() + j] = col[i];
+		}
+	}
+	
+	std::vector<double> recv = alltoallv_rows(send, dist.send_counts, dist.recv_counts, lcl_sz.n(), MPI_COMM_WORLD);
+	BOOST_ASSERT(recv.size() == ((size_t)to_lcl.Height() - kept) * lcl_sz.n());
+	for(size_t j = 0; j < lcl_sz.n(); ++j) {
+		double * col = to_lcl.Buffer(0, (El::Int)j);
+		for(size_t i = kept; i < (size_t)to_lcl.Height(); ++i) {
+			col[i] = recv[(i - kept) * lcl_sz.n() + j];
+		}
+	}
+	
+	return to;
+}
+
+HBRS_THETA_UTILS_API
+mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT>
+scatter(
+	std::vector<theta_field_path> const& from,
+	scatter_control<theta_field_distribution_3> const& ctrl
+) {
+	using std::size_t;
+	theta_field_distribution_3 const& dist = ctrl.algorithm;
+	
+	BOOST_ASSERT(!from.empty());
+	size_t const no_of_points = read_theta_field_size(from.at(0).full_path().string());
+	
+	mpl::matrix_size<size_t, size_t> lcl_sz{3 * no_of_points, from.size()};
+	mpl::matrix_size<size_t, size_t> gbl_sz = distributed_size(lcl_sz, dist);
+	
+	static El::Grid const grid{};
+	mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT> to{
+		grid,
+		boost::numeric_cast<El::Int>(gbl_sz.m()),
+		boost::numeric_cast<El::Int>(gbl_sz.n())
+	};
+	
+	size_t mpi_rank = boost::numeric_cast<size_t>(mpi::comm_rank());
+	El::Matrix<double> & to_lcl = to.data().Matrix();
+	BOOST_ASSERT(lcl_sz.m() == dist.domain_ms.at(mpi_rank));
+	BOOST_ASSERT(dist.local_ms.at(mpi_rank) == (size_t)to_lcl.Height());
+	
+	size_t const kept = std::min(lcl_sz.m(), (size_t)to_lcl.Height());
+	std::vector<double> send((lcl_sz.m() - kept) * lcl_sz.n());
+	
+	if (kept == lcl_sz.m()) {
+		// whole domain fits into local matrix, so each file is read into its column without any copies
+		for(size_t j = 0; j < from.size(); ++j) {
+			read_theta_velocities(from[j].full_path().string(), to_lcl.Buffer(0, (El::Int)j), no_of_points);
+		}
+	} else {
+		std::vector<double> col(lcl_sz.m());
+		for(size_t j = 0; j < from.size(); ++j) {
+			read_theta_velocities(from[j].full_path().string(), col.data(), no_of_points);
+			std::copy_n(col.begin(), kept, to_lcl.Buffer(0, (El::Int)j));
+			for(size_t i = kept; i < lcl_sz.m(); ++i) {
+				send[(i - kept) * lcl_sz.n() + j] = col[i];
+			}
+		}
+	}
+	
+	std::vector<double> recv = alltoallv_rows(send, dist.send_counts, dist.recv_counts, lcl_sz.n(), MPI_COMM_WORLD);
+	BOOST_ASSERT(recv.size() == ((size_t)to_lcl.Height() - kept) * lcl_sz.n());
+	for(size_t j = 0; j < lcl_sz.n(); ++j) {
+		double * col = to_lcl.Buffer(0, (El::Int)j);
+		for(size_t i = kept; i < (size_t)to_lcl.Height(); ++i) {
+			col[i] = recv[(i - kept) * lcl_sz.n() + j];
+		}
+	}
+	
+	return to;
+}
+
+HBRS_THETA_UTILS_API
+mpl::el_dist_matrix<double, El::MC, El::MR, El::ELEMENT>
+scatter(
+	theta_field_matrix const& from,
+	scatter_control<theta_field_distribution_4> const& ctrl
+) {
+	BOOST_ASSERT(ctrl.algorithm.grid);
+	mpl::matrix_size<std::size_t, std::size_t> lcl_sz = from.size();
+	return scatter_to_grid(
+		copy_matrix(from, mpl::el_matrix<double>{ (El::Int)lcl_sz.m(), (El::Int)lcl_sz.n() }).data(),
+		*ctrl.algorithm.grid
+	);
+}
+
+HBRS_THETA_UTILS_API
+mpl::el_dist_matrix<double, El::MC, El::MR, El::ELEMENT>
+scatter(
+	std::vector<theta_field_path> const& from,
+	scatter_control<theta_field_distribution_4> const& ctrl
+) {
+	BOOST_ASSERT(ctrl.algorithm.grid);
+	BOOST_ASSERT(!from.empty());
+	std::size_t const no_of_points = read_theta_field_size(from.at(0).full_path().string());
+	
+	El::Matrix<double> from_lcl{ (El::Int)(3 * no_of_points), (El::Int)from.size() };
+	for(std::size_t j = 0; j < from.size(); ++j) {
+		read_theta_velocities(from[j].full_path().string(), from_lcl.Buffer(0, (El::Int)j), no_of_points);
+	}
+	
+	return scatter_to_grid(from_lcl, *ctrl.algorithm.grid);
+}
 #endif // !HBRS_MPL_ENABLE_ELEMENTAL
 /* namespace detail */ }
 HBRS_THETA_UTILS_NAMESPACE_END
@@ -21,12 +21,16 @@
 
 #include <hbrs/theta_utils/config.hpp>
 #include <hbrs/theta_utils/dt/theta_field_matrix.hpp>
+#include <hbrs/theta_utils/dt/theta_field.hpp>
 
 #include <hbrs/mpl/config.hpp>
 #ifdef HBRS_MPL_ENABLE_ELEMENTAL
     #include <hbrs/mpl/dt/el_dist_matrix.hpp>
 #endif // !HBRS_MPL_ENABLE_ELEMENTAL
 #include <hbrs/mpl/dt/matrix_size.hpp>
+#include <mpi.h>
+#include <memory>
+#include <vector>
 
 HBRS_THETA_UTILS_NAMESPACE_BEGIN
 namespace mpl = hbrs::mpl;
@@ -35,6 +39,45 @@ namespace detail {
 struct HBRS_THETA_UTILS_API theta_field_distribution_1{};
 struct HBRS_THETA_UTILS_API theta_field_distribution_2{};
 
+/* Distributes rows of all domains to a global matrix of exactly the sum of all domain sizes, i.e. without the zero rows
+ * of theta_field_distribution_2. Elemental assigns floor or ceil of gbl_m/mpi_sz rows to each process, so each process
+ * keeps as many of its own rows as fit into its local matrix and its remaining (surplus) rows are moved to processes
+ * with smaller domains. Surplus rows of all processes, ordered by process, fill the free local rows of all processes,
+ * ordered by process, too.
+ */
+struct HBRS_THETA_UTILS_API theta_field_distribution_3 {
+	// number of rows of the domain, i.e. of the local theta fields, of each process
+	std::vector<std::size_t> domain_ms;
+	// number of rows of the local matrix of each process
+	std::vector<std::size_t> local_ms;
+	// number of surplus rows this process sends to each process
+	std::vector<std::size_t> send_counts;
+	// number of surplus rows of each process which fill the local matrix of this process
+	std::vector<std::size_t> recv_counts;
+};
+
+/* Collective operation, lcl_sz is the size of the data matrix of this process */
+HBRS_THETA_UTILS_API
+theta_field_distribution_3
+make_theta_field_distribution_3(mpl::matrix_size<std::size_t, std::size_t> const& lcl_sz);
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+/* Concatenates rows of all domains in order of processes like theta_field_distribution_1, but scatters them directly to
+ * a [MC,MR] distributed matrix on a 2d process grid, i.e. both rows and columns are distributed as required by the svd.
+ * Rows of [VC,STAR] distributed results, e.g. principal components, are gathered with theta_field_distribution_1.
+ */
+struct HBRS_THETA_UTILS_API theta_field_distribution_4 {
+	std::shared_ptr<El::Grid const> grid;
+};
+
+/* Process grid on MPI_COMM_WORLD with height process rows, which must divide the number of processes, or a nearly
+ * square grid if height is zero
+ */
+HBRS_THETA_UTILS_API
+std::shared_ptr<El::Grid const>
+make_process_grid(std::size_t height);
+#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+
 template<typename Algorithm>
 struct scatter_control{
 	Algorithm algorithm;
@@ -47,6 +90,13 @@ distributed_size(
 	theta_field_distribution_1
 );
 
+HBRS_THETA_UTILS_API
+mpl::matrix_size<std::size_t, std::size_t>
+distributed_size(
+	mpl::matrix_size<std::size_t, std::size_t> const& lcl_sz,
+	theta_field_distribution_1
+);
+
 HBRS_THETA_UTILS_API
 mpl::matrix_size<std::size_t, std::size_t>
 distributed_size(
@@ -54,6 +104,41 @@ distributed_size(
 	theta_field_distribution_2
 );
 
+/* Same as above but for a local data matrix of size lcl_sz which does not have to be materialized */
+HBRS_THETA_UTILS_API
+mpl::matrix_size<std::size_t, std::size_t>
+distributed_size(
+	mpl::matrix_size<std::size_t, std::size_t> const& lcl_sz,
+	theta_field_distribution_2
+);
+
+HBRS_THETA_UTILS_API
+mpl::matrix_size<std::size_t, std::size_t>
+distributed_size(
+	mpl::matrix_size<std::size_t, std::size_t> const& lcl_sz,
+	theta_field_distribution_3 const& dist
+);
+
+/* Number of rows in [first, last) which a round robin distribution among size processes assigns to process rank, i.e.
+ * rows with row % size == rank
+ */
+HBRS_THETA_UTILS_API
+std::size_t
+round_robin_count(std::size_t first, std::size_t last, std::size_t rank, std::size_t size);
+
+/* Redistributes rows of row_length doubles with a single MPI_Alltoallv. send holds send_counts[0] rows for process 0,
+ * followed by send_counts[1] rows for process 1 and so on. Returns the received rows ordered by source process.
+ */
+HBRS_THETA_UTILS_API
+std::vector<double>
+alltoallv_rows(
+	std::vector<double> const& send,
+	std::vector<std::size_t> const& send_counts,
+	std::vector<std::size_t> const& recv_counts,
+	std::size_t row_length,
+	MPI_Comm comm
+);
+
 #ifdef HBRS_MPL_ENABLE_ELEMENTAL
 HBRS_THETA_UTILS_API
 hbrs::mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT>
@@ -68,6 +153,45 @@ scatter(
 	theta_field_matrix const& from,
 	scatter_control<theta_field_distribution_2>
 );
+
+/* Reads velocities of the theta fields in from straight into the local matrix, one column per file. Returns the same
+ * matrix as scatter(theta_field_matrix{read_theta_fields(from, {".*_velocity"})}, ...) but skips the intermediate
+ * theta_field and theta_field_matrix copies.
+ */
+HBRS_THETA_UTILS_API
+hbrs::mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT>
+scatter(
+	std::vector<theta_field_path> const& from,
+	scatter_control<theta_field_distribution_2>
+);
+
+HBRS_THETA_UTILS_API
+hbrs::mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT>
+scatter(
+	theta_field_matrix const& from,
+	scatter_control<theta_field_distribution_3> const& ctrl
+);
+
+HBRS_THETA_UTILS_API
+hbrs::mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT>
+scatter(
+	std::vector<theta_field_path> const& from,
+	scatter_control<theta_field_distribution_3> const& ctrl
+);
+
+HBRS_THETA_UTILS_API
+hbrs::mpl::el_dist_matrix<double, El::MC, El::MR, El::ELEMENT>
+scatter(
+	theta_field_matrix const& from,
+	scatter_control<theta_field_distribution_4> const& ctrl
+);
+
+HBRS_THETA_UTILS_API
+hbrs::mpl::el_dist_matrix<double, El::MC, El::MR, El::ELEMENT>
+scatter(
+	std::vector<theta_field_path> const& from,
+	scatter_control<theta_field_distribution_4> const& ctrl
+);
 #endif // !HBRS_MPL_ENABLE_ELEMENTAL
 
 /* namespace detail */ }
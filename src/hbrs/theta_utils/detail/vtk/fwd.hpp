@@ -32,13 +32,40 @@
 HBRS_THETA_UTILS_NAMESPACE_BEGIN
 namespace fs = boost::filesystem;
 
-enum class vtk_file_format { legacy_ascii, xml_binary };
+enum class vtk_file_format { legacy_ascii, xml_binary, hdf, xml_streamed };
+enum class vtk_compressor { none, zlib, lz4, lzma };
+enum class vtk_cell_kind { all, volume, surface };
 
 struct HBRS_THETA_UTILS_API vtk_path;
+struct HBRS_THETA_UTILS_API vtk_domain_topology;
+struct HBRS_THETA_UTILS_API vtk_xml_encoding;
+struct HBRS_THETA_UTILS_API vtk_cell_selection;
+
+/* Computes cells and halo-exchange plan of the local part of grid, i.e. of the points given by global_id */
+HBRS_THETA_UTILS_API
+vtk_domain_topology
+make_vtk_domain_topology(theta_grid const& grid, shared_global_id const& global_id);
+
+/* Like above, but only selected cells and the points referenced by them are exported */
+HBRS_THETA_UTILS_API
+vtk_domain_topology
+make_vtk_domain_topology(
+	theta_grid const& grid,
+	shared_global_id const& global_id,
+	vtk_cell_selection const& selection);
+
+/* Adds point data of field to a grid which shares points and cells with topology. Point data references the buffers of
+ * field, so field must outlive the returned grid. Values of boundary points are appended to the variables of field and,
+ * if cells are selected, values of exported points are moved to their front, hence field is modified and cannot be
+ * passed again. Variables should have spare capacity for the appended values to avoid reallocating them, see
+ * read_theta_field(). Must be called by all processes. */
+HBRS_THETA_UTILS_API
+vtkSmartPointer<vtkUnstructuredGrid>
+make_vtk_unstructured_grid(vtk_domain_topology const& topology, theta_field & field);
 
 HBRS_THETA_UTILS_API
 vtkSmartPointer<vtkUnstructuredGrid>
-make_vtk_unstructured_grid(theta_grid const& grid, theta_field const& field);
+make_vtk_unstructured_grid(theta_grid const& grid, theta_field & field);
 
 HBRS_THETA_UTILS_API
 void
@@ -48,10 +75,34 @@ HBRS_THETA_UTILS_API
 void
 write_vtk_xml_binary(vtkSmartPointer<vtkUnstructuredGrid> grid, char const * file_path);
 
+HBRS_THETA_UTILS_API
+void
+write_vtk_xml_binary(
+	vtkSmartPointer<vtkUnstructuredGrid> grid,
+	char const * file_path,
+	vtk_xml_encoding const& encoding);
+
 HBRS_THETA_UTILS_API
 void
 write_vtk_xml_binary_parallel(vtkSmartPointer<vtkUnstructuredGrid> grid, char const * file_path);
 
+HBRS_THETA_UTILS_API
+void
+write_vtk_xml_binary_parallel(
+	vtkSmartPointer<vtkUnstructuredGrid> grid,
+	char const * file_path,
+	vtk_xml_encoding const& encoding);
+
+/* Writes points and cells of topology and point data of field to a VTU file, or to a piece of a PVTU file if run on
+ * several processes, without building a vtkUnstructuredGrid. Data arrays are streamed uncompressed into the appended
+ * section in chunks of fixed size. Point data of boundary points is exchanged, so it must be called by all processes.
+ */
+HBRS_THETA_UTILS_API
+void
+write_vtk_xml_streamed(vtk_domain_topology const& topology, theta_field const& field, char const * file_path);
+
+/* Reading of up to pipeline_depth following time steps and writing of up to pipeline_depth previous time steps overlap
+ * with building the current one, zero processes time steps strictly one after another */
 HBRS_THETA_UTILS_API
 void
 convert_to_vtk(
@@ -63,7 +114,23 @@ convert_to_vtk(
 	std::vector<std::string> const& excludes,
 	bool simple_numbering,
 	vtk_file_format format,
-	bool overwrite);
+	bool overwrite,
+	std::size_t pipeline_depth,
+	vtk_xml_encoding const& encoding,
+	vtk_cell_selection const& selection);
+
+/* Writes the time step of field_path with each compressor, compression level and encoding of the XML writers to
+ * temporary folders in folder and prints bytes written and seconds per step for each setting to out */
+HBRS_THETA_UTILS_API
+void
+benchmark_vtk_xml_encodings(
+	theta_grid_path const& grid_path,
+	theta_field_path const& field_path,
+	fs::path const& folder,
+	std::vector<std::string> const& includes,
+	std::vector<std::string> const& excludes,
+	vtk_cell_selection const& selection,
+	std::ostream & out);
 
 HBRS_THETA_UTILS_NAMESPACE_END
 
@@ -156,16 +156,17 @@ HBRS_THETA_UTILS_NAMESPACE_END
 #include <vtkUnstructuredGridWriter.h>
 #include <vtkXMLUnstructuredGridWriter.h>
 #include <vtkXMLPUnstructuredGridWriter.h>
+#include <vtkXMLWriter.h>
 #include <vtkPoints.h>
 #include <vtkUnstructuredGrid.h>
 #include <vtkDoubleArray.h>
+#include <vtkFloatArray.h>
+#include <vtkSOADataArrayTemplate.h>
 #include <vtkPointData.h>
-#include <vtkTetra.h>
-#include <vtkWedge.h>
-#include <vtkHexahedron.h>
-#include <vtkPyramid.h>
-#include <vtkTriangle.h>
-#include <vtkQuad.h>
+#include <vtkCellArray.h>
+#include <vtkIdTypeArray.h>
+#include <vtkUnsignedCharArray.h>
+#include <vtkVersion.h>
 #include <vtkCommand.h>
 #include <vtkObject.h>
 #include <vtkMPIController.h>
@@ -175,7 +176,10 @@ HBRS_THETA_UTILS_NAMESPACE_END
 #include <hbrs/theta_utils/dt/exception.hpp>
 #include <boost/throw_exception.hpp>
 #include <boost/numeric/conversion/cast.hpp>
+#include <algorithm>
+#include <array>
 #include <iostream>
+#include <utility>
 
 HBRS_THETA_UTILS_NAMESPACE_BEGIN
 namespace mpi = hbrs::mpl::detail::mpi;
@@ -201,44 +205,198 @@ private:
 
 typedef Observer<vtkCommand::ErrorEvent, const char *> ErrorObserver;
 typedef Observer<vtkCommand::WarningEvent, const char *> WarningObserver;
-/* namespace detail */ }
 
-HBRS_THETA_UTILS_API
-vtkSmartPointer<vtkUnstructuredGrid>
-make_vtk_unstructured_grid(theta_grid const& grid, theta_field const& field) {
-	static constexpr auto INVALID_ID = std::numeric_limits<std::size_t>::max();
+/* Sends ids_for_rank[i] to process i and returns the ids which have been sent to this process, ordered by rank */
+static std::vector<std::vector<std::size_t>>
+alltoallv_ids(std::vector<std::vector<std::size_t>> const& ids_for_rank) {
+	std::size_t const mpi_size = ids_for_rank.size();
+	MPI_Datatype const type = mpi::datatype(hana::type_c<std::size_t>);
+	
+	std::vector<std::size_t> send_sizes(mpi_size), recv_sizes(mpi_size);
+	for(std::size_t i = 0; i < mpi_size; ++i) {
+		send_sizes[i] = ids_for_rank[i].size();
+	}
+	MPI_Alltoall(send_sizes.data(), 1, type, recv_sizes.data(), 1, type, MPI_COMM_WORLD);
 	
-	std::size_t const mpi_size = boost::numeric_cast<std::size_t>(mpi::comm_size());
-	std::size_t const mpi_rank = boost::numeric_cast<std::size_t>(mpi::comm_rank());
-	bool distributed = !field.global_id().empty();
-	BOOST_ASSERT(!distributed ? mpi_size == 1 : true);
-	BOOST_ASSERT(mpi_size > 1 ? distributed : true);
+	auto const to_int = [mpi_size](
+		std::vector<std::size_t> const& sizes,
+		std::vector<int> & counts,
+		std::vector<int> & displs
+	) {
+		counts.resize(mpi_size);
+		displs.resize(mpi_size);
+		std::size_t displ = 0;
+		for(std::size_t i = 0; i < mpi_size; ++i) {
+			counts[i] = boost::numeric_cast<int>(sizes[i]);
+			displs[i] = boost::numeric_cast<int>(displ);
+			displ += sizes[i];
+		}
+		return displ;
+	};
 	
-	std::size_t grid_no_of_points = boost::lexical_cast<std::size_t>(grid.no_of_points());
-	std::size_t no_of_points = field.global_id().empty() ? grid_no_of_points : field.global_id().size();
+	std::vector<int> send_counts, send_displs, recv_counts, recv_displs;
+	std::vector<std::size_t> send(to_int(send_sizes, send_counts, send_displs));
+	std::vector<std::size_t> recv(to_int(recv_sizes, recv_counts, recv_displs));
+	for(std::size_t i = 0; i < mpi_size; ++i) {
+		std::copy(ids_for_rank[i].begin(), ids_for_rank[i].end(), send.begin() + send_displs[i]);
+	}
 	
-	// no_of_points is smaller than grid.no_of_points() if grid was distributed among several processes
-	BOOST_ASSERT(no_of_points <= grid_no_of_points);
+	MPI_Alltoallv(
+		send.data(), send_counts.data(), send_displs.data(), type,
+		recv.data(), recv_counts.data(), recv_displs.data(), type,
+		MPI_COMM_WORLD
+	);
 	
-#define __has_var(__var)                                                                                               \
-	auto const has_ ## __var = field.__var().size() > 0;                                                               \
-	if (has_ ## __var && field.__var().size() > no_of_points) {                                                        \
-		BOOST_THROW_EXCEPTION(std::runtime_error{                                                                      \
-			std::string{"dimensions of variable "} + #__var + " do not match size of grid"                             \
-		});                                                                                                            \
-	}                                                                                                                  \
+	std::vector<std::vector<std::size_t>> ids_from_rank(mpi_size);
+	for(std::size_t i = 0; i < mpi_size; ++i) {
+		ids_from_rank[i].assign(recv.begin() + recv_displs[i], recv.begin() + recv_displs[i] + recv_counts[i]);
+	}
+	return ids_from_rank;
+}
+
+/* Collects cells of a vtkUnstructuredGrid straight in the arrays which are passed to VTK at once, which avoids
+ * allocating a vtkCell per element and inserting it with InsertNextCell() as well as copying intermediate buffers.
+ * Arrays are allocated for at most max_no_of_cells cells with max_no_of_ids point ids in total and shrunk to the cells
+ * which have actually been collected. */
+struct vtk_cell_buffer {
+	vtk_cell_buffer(std::size_t max_no_of_cells, std::size_t max_no_of_ids)
+	: types_{vtkSmartPointer<vtkUnsignedCharArray>::New()},
+#if VTK_MAJOR_VERSION >= 9
+	  offsets_{vtkSmartPointer<vtkIdTypeArray>::New()},
+	  connectivity_{vtkSmartPointer<vtkIdTypeArray>::New()},
+#else
+	  ids_{vtkSmartPointer<vtkIdTypeArray>::New()},
+	  locations_{vtkSmartPointer<vtkIdTypeArray>::New()},
+#endif
+	  max_no_of_cells_{boost::numeric_cast<vtkIdType>(max_no_of_cells)},
+	  max_no_of_ids_{boost::numeric_cast<vtkIdType>(max_no_of_ids)},
+	  no_of_cells_{0},
+	  no_of_ids_{0}
+	{
+		types_->SetNumberOfValues(max_no_of_cells_);
+#if VTK_MAJOR_VERSION >= 9
+		offsets_->SetNumberOfValues(max_no_of_cells_ + 1);
+		offsets_->SetValue(0, 0);
+		connectivity_->SetNumberOfValues(max_no_of_ids_);
+#else
+		// legacy layout of cell arrays, i.e. number of points of each cell followed by its point ids
+		ids_->SetNumberOfValues(max_no_of_cells_ + max_no_of_ids_);
+		locations_->SetNumberOfValues(max_no_of_cells_);
+#endif
+	}
 	
-	__has_var(density)
-	__has_var(x_velocity)
-	__has_var(y_velocity)
-	__has_var(z_velocity)
-	__has_var(pressure)
-	__has_var(residual)
+	template<int CellType, typename Object, typename LocalIdOf>
+	void
+	push_back(Object const& object, LocalIdOf && local_id_of) {
+		static constexpr vtkIdType size = std::tuple_size<Object>::value;
+		BOOST_ASSERT(no_of_cells_ < max_no_of_cells_);
+		BOOST_ASSERT(no_of_ids_ + size <= max_no_of_ids_);
+		
+#if VTK_MAJOR_VERSION >= 9
+		vtkIdType * ids = connectivity_->GetPointer(no_of_ids_);
+#else
+		locations_->SetValue(no_of_cells_, no_of_cells_ + no_of_ids_);
+		vtkIdType * ids = ids_->GetPointer(no_of_cells_ + no_of_ids_);
+		*ids++ = size;
+#endif
+		for (vtkIdType j = 0; j < size; ++j) {
+			ids[j] = boost::numeric_cast<vtkIdType>(local_id_of(object[j]));
+		}
+		
+		types_->SetValue(no_of_cells_, CellType);
+		++no_of_cells_;
+		no_of_ids_ += size;
+#if VTK_MAJOR_VERSION >= 9
+		offsets_->SetValue(no_of_cells_, no_of_ids_);
+#endif
+	}
 	
-#undef __has_var
+	/* Hands the arrays over to grid, so cells must not be pushed back afterwards */
+	void
+	set_cells_of(vtkUnstructuredGrid * grid) {
+		// shrinking keeps the values and usually does not move them
+		types_->SetNumberOfValues(no_of_cells_);
+		
+		vtkSmartPointer<vtkCellArray> cells = vtkSmartPointer<vtkCellArray>::New();
+#if VTK_MAJOR_VERSION >= 9
+		offsets_->SetNumberOfValues(no_of_cells_ + 1);
+		connectivity_->SetNumberOfValues(no_of_ids_);
+		cells->SetData(offsets_, connectivity_);
+		grid->SetCells(types_, cells);
+#else
+		ids_->SetNumberOfValues(no_of_cells_ + no_of_ids_);
+		locations_->SetNumberOfValues(no_of_cells_);
+		cells->SetCells(no_of_cells_, ids_);
+		grid->SetCells(types_, locations_, cells);
+#endif
+	}
 	
-	vtkSmartPointer<vtkUnstructuredGrid> vtk_grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+private:
+	vtkSmartPointer<vtkUnsignedCharArray> types_;
+#if VTK_MAJOR_VERSION >= 9
+	vtkSmartPointer<vtkIdTypeArray> offsets_;
+	vtkSmartPointer<vtkIdTypeArray> connectivity_;
+#else
+	vtkSmartPointer<vtkIdTypeArray> ids_;
+	vtkSmartPointer<vtkIdTypeArray> locations_;
+#endif
+	vtkIdType max_no_of_cells_;
+	vtkIdType max_no_of_ids_;
+	vtkIdType no_of_cells_;
+	vtkIdType no_of_ids_;
+};
+
+/* Maps global ids of owned and boundary points to their local ids. Pairs are kept sorted by global id and looked up
+ * with a binary search, so memory is linear in the number of local points instead of the number of grid points. If
+ * the grid is not distributed, global and local ids are equal and nothing is stored. */
+struct local_id_map {
+	static constexpr std::size_t INVALID_ID = std::numeric_limits<std::size_t>::max();
+	
+	explicit
+	local_id_map(bool identity, std::size_t no_of_points) : identity_{identity}, no_of_points_{no_of_points} {}
+	
+	/* Pairs inserted are not visible to find() before sort() is called */
+	void
+	insert(std::size_t global_id, std::size_t local_id) {
+		BOOST_ASSERT(!identity_);
+		ids_.emplace_back(global_id, local_id);
+	}
+	
+	/* Sorts pairs inserted since the last call and merges them with the already sorted ones */
+	void
+	sort() {
+		auto middle = ids_.begin() + boost::numeric_cast<std::ptrdiff_t>(no_of_sorted_);
+		std::sort(middle, ids_.end());
+		std::inplace_merge(ids_.begin(), middle, ids_.end());
+		BOOST_ASSERT(std::adjacent_find(ids_.begin(), ids_.end(), [](auto const& a, auto const& b) {
+			return a.first == b.first;
+		}) == ids_.end());
+		no_of_sorted_ = ids_.size();
+	}
+	
+	std::size_t
+	find(std::size_t global_id) const {
+		if (identity_) {
+			return global_id < no_of_points_ ? global_id : INVALID_ID;
+		}
+		
+		BOOST_ASSERT(no_of_sorted_ == ids_.size());
+		auto it = std::lower_bound(ids_.begin(), ids_.end(), global_id, [](auto const& pair, std::size_t id) {
+			return pair.first < id;
+		});
+		return it != ids_.end() && it->first == global_id ? it->second : INVALID_ID;
+	}
 	
+private:
+	bool identity_;
+	std::size_t no_of_points_;
+	std::vector<std::pair<std::size_t, std::size_t>> ids_;
+	std::size_t no_of_sorted_ = 0;
+};
+
+/* Lets errors of obj throw a vtk_exception and prints its warnings to stderr */
+static void
+observe_vtk_object(vtkObject * obj) {
 	vtkSmartPointer<detail::ErrorObserver> throw_error{new detail::ErrorObserver{
 		[](auto caller, auto calldata){
 			BOOST_THROW_EXCEPTION(
@@ -246,20 +404,68 @@ make_vtk_unstructured_grid(theta_grid const& grid, theta_field const& field) {
 			);
 		}
 	}};
-	vtk_grid->AddObserver(vtkCommand::ErrorEvent, throw_error);
+	obj->AddObserver(vtkCommand::ErrorEvent, throw_error);
 	
 	vtkSmartPointer<detail::WarningObserver> print_warning {new detail::WarningObserver{
 		[](auto caller, auto calldata){
 			std::cerr << calldata << std::endl;
 		}
 	}};
-	vtk_grid->AddObserver(vtkCommand::WarningEvent,print_warning);
+	obj->AddObserver(vtkCommand::WarningEvent,print_warning);
+}
+/* namespace detail */ }
+
+vtk_domain_topology::vtk_domain_topology(
+	std::size_t no_of_points,
+	boost::optional<std::vector<std::size_t>> point_ids,
+	std::vector<std::vector<std::size_t>> send_ids,
+	std::vector<std::size_t> recv_counts,
+	vtkSmartPointer<vtkUnstructuredGrid> geometry
+) : no_of_points_{no_of_points}, point_ids_{std::move(point_ids)}, send_ids_{std::move(send_ids)},
+	recv_counts_{std::move(recv_counts)}, geometry_{geometry} {}
+
+HBRS_THETA_UTILS_DEFINE_ATTR(no_of_points, std::size_t, vtk_domain_topology)
+HBRS_THETA_UTILS_DEFINE_ATTR(point_ids, boost::optional<std::vector<std::size_t>>, vtk_domain_topology)
+HBRS_THETA_UTILS_DEFINE_ATTR(send_ids, std::vector<std::vector<std::size_t>>, vtk_domain_topology)
+HBRS_THETA_UTILS_DEFINE_ATTR(recv_counts, std::vector<std::size_t>, vtk_domain_topology)
+HBRS_THETA_UTILS_DEFINE_ATTR(geometry, vtkSmartPointer<vtkUnstructuredGrid>, vtk_domain_topology)
+
+HBRS_THETA_UTILS_API
+vtk_domain_topology
+make_vtk_domain_topology(theta_grid const& grid, shared_global_id const& global_id) {
+	return make_vtk_domain_topology(grid, global_id, vtk_cell_selection{});
+}
+
+HBRS_THETA_UTILS_API
+vtk_domain_topology
+make_vtk_domain_topology(
+	theta_grid const& grid,
+	shared_global_id const& global_id,
+	vtk_cell_selection const& selection
+) {
+	static constexpr auto INVALID_ID = detail::local_id_map::INVALID_ID;
+	
+	std::size_t const mpi_size = boost::numeric_cast<std::size_t>(mpi::comm_size());
+	std::size_t const mpi_rank = boost::numeric_cast<std::size_t>(mpi::comm_rank());
+	bool distributed = global_id && !global_id->empty();
+	BOOST_ASSERT(!distributed ? mpi_size == 1 : true);
+	BOOST_ASSERT(mpi_size > 1 ? distributed : true);
+	
+	std::size_t grid_no_of_points = boost::lexical_cast<std::size_t>(grid.no_of_points());
+	std::size_t no_of_points = distributed ? global_id->size() : grid_no_of_points;
+	
+	// no_of_points is smaller than grid.no_of_points() if grid was distributed among several processes
+	BOOST_ASSERT(no_of_points <= grid_no_of_points);
+	
+	vtkSmartPointer<vtkUnstructuredGrid> vtk_grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+	
+	detail::observe_vtk_object(vtk_grid);
 	
 	std::function<std::size_t(std::size_t)> get_id;
 	if (distributed) {
-		get_id = [&field](std::size_t i) {
-			BOOST_ASSERT(i < field.global_id().size());
-			return field.global_id()[i];
+		get_id = [&global_id = *global_id](std::size_t i) {
+			BOOST_ASSERT(i < global_id.size());
+			return boost::numeric_cast<std::size_t>(global_id[i]);
 		};
 	} else {
 		get_id = [](std::size_t i) {
@@ -267,112 +473,186 @@ make_vtk_unstructured_grid(theta_grid const& grid, theta_field const& field) {
 		};
 	}
 	
-	vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
-	vtk_grid->SetPoints(points);
+	detail::local_id_map local_ids{!distributed, no_of_points};
+	if (distributed) {
+		for(std::size_t i = 0; i < no_of_points; ++i) {
+			local_ids.insert(get_id(i), i);
+		}
+		local_ids.sort();
+	}
 	
-	// add points of local grid
-	for(std::size_t i = 0; i < no_of_points; ++i) {
-		std::size_t global_id = get_id(i);
-		BOOST_ASSERT(global_id < grid_no_of_points);
-		points->InsertNextPoint(
-			grid.points()[global_id].x,
-			grid.points()[global_id].y,
-			grid.points()[global_id].z
-		);
+	// boundary markers of surface triangles precede those of surface quadrilaterals
+	std::size_t const no_of_surfacetriangles = boost::numeric_cast<std::size_t>(grid.no_of_surfacetriangles());
+	std::vector<int> boundary_markers = selection.boundary_markers;
+	std::sort(boundary_markers.begin(), boundary_markers.end());
+	if (selection.kind != vtk_cell_kind::volume && !boundary_markers.empty() &&
+		grid.boundarymarker_of_surfaces().size() != boost::numeric_cast<std::size_t>(grid.no_of_surfaceelements()))
+	{
+		BOOST_THROW_EXCEPTION(invalid_grid_exception{});
 	}
 	
-	std::vector<std::size_t> global_to_local_id(grid_no_of_points, INVALID_ID);
-	for(std::size_t i = 0; i < no_of_points; ++i) {
-		global_to_local_id[get_id(i)] = i;
+	auto const volume_selected = [&selection](int) {
+		return selection.kind != vtk_cell_kind::surface;
+	};
+	auto const surface_selected = [&](std::size_t surface) {
+		return selection.kind != vtk_cell_kind::volume && (boundary_markers.empty() ||
+			std::binary_search(
+				boundary_markers.begin(), boundary_markers.end(), grid.boundarymarker_of_surfaces()[surface]));
+	};
+	auto const surfacetriangle_selected = [&](int i) {
+		return surface_selected(boost::numeric_cast<std::size_t>(i));
+	};
+	auto const surfacequadrilateral_selected = [&](int i) {
+		return surface_selected(no_of_surfacetriangles + boost::numeric_cast<std::size_t>(i));
+	};
+	
+	// If cells are selected, only owned points which are referenced by selected cells are exported and these are
+	// renumbered in order of their local ids. Point data of all owned points can still be sent to other processes.
+	boost::optional<std::vector<std::size_t>> point_ids;
+	std::vector<std::size_t> exported_id_of;
+	if (selection.kind != vtk_cell_kind::all || !boundary_markers.empty()) {
+		std::vector<bool> is_referenced(no_of_points, false);
+		auto const mark_points = [&](auto const& no_of_objects, auto const& points_of_objects, auto const& selected) {
+			for(int i = 0; i < no_of_objects; ++i) {
+				if (!selected(i)) {
+					continue;
+				}
+				for(auto global_id : points_of_objects[i]) {
+					std::size_t local_id = local_ids.find(global_id);
+					if (local_id != INVALID_ID) {
+						is_referenced[local_id] = true;
+					}
+				}
+			}
+		};
+		
+		mark_points(grid.no_of_tetraeders(), grid.points_of_tetraeders(), volume_selected);
+		mark_points(grid.no_of_prisms(), grid.points_of_prisms(), volume_selected);
+		mark_points(grid.no_of_hexaeders(), grid.points_of_hexaeders(), volume_selected);
+		mark_points(grid.no_of_pyramids(), grid.points_of_pyramids(), volume_selected);
+		mark_points(grid.no_of_surfacetriangles(), grid.points_of_surfacetriangles(), surfacetriangle_selected);
+		mark_points(
+			grid.no_of_surfacequadrilaterals(), grid.points_of_surfacequadrilaterals(), surfacequadrilateral_selected);
+		
+		point_ids = std::vector<std::size_t>{};
+		exported_id_of.assign(no_of_points, INVALID_ID);
+		for(std::size_t i = 0; i < no_of_points; ++i) {
+			if (is_referenced[i]) {
+				exported_id_of[i] = point_ids->size();
+				point_ids->push_back(i);
+			}
+		}
 	}
+	std::size_t const no_of_exported_points = point_ids ? point_ids->size() : no_of_points;
 	
+	// global ids of boundary points are collected with duplicates, these are removed after all cells are seen
 	std::vector<std::size_t> missing_global_ids;
 	
+	// cells of local grid and boundary cells are passed to vtk_grid at once, see below
+	detail::vtk_cell_buffer cells(
+		grid.no_of_tetraeders() + grid.no_of_prisms() + grid.no_of_hexaeders() + grid.no_of_pyramids() +
+			grid.no_of_surfacetriangles() + grid.no_of_surfacequadrilaterals(),
+		std::tuple_size<theta_grid::tetraeder>::value * grid.no_of_tetraeders() +
+			std::tuple_size<theta_grid::prism>::value * grid.no_of_prisms() +
+			std::tuple_size<theta_grid::hexaeder>::value * grid.no_of_hexaeders() +
+			std::tuple_size<theta_grid::pyramid>::value * grid.no_of_pyramids() +
+			std::tuple_size<theta_grid::surfacetriangle>::value * grid.no_of_surfacetriangles() +
+			std::tuple_size<theta_grid::surfacequadrilateral>::value * grid.no_of_surfacequadrilaterals()
+	);
+	
+	// boundary points are exported behind the exported owned points
+	auto const local_id_of = [&](std::size_t global_id) {
+		std::size_t local_id = local_ids.find(global_id);
+		BOOST_ASSERT(local_id != INVALID_ID);
+		if (local_id >= no_of_points) {
+			return no_of_exported_points + (local_id - no_of_points);
+		}
+		return point_ids ? exported_id_of[local_id] : local_id;
+	};
+	
 	auto insert_vtk_cell = [&](
 		auto const& no_of_objects,
 		auto const& points_of_objects,
 		auto const& object_size,
-		auto cell_type
+		auto cell_type,
+		auto const& selected
 	) -> std::vector<std::size_t> {
-		typedef typename decltype(cell_type)::type CellType;
+		static constexpr int CellType = decltype(cell_type)::value;
 		std::vector<std::size_t> bdry_objects;
 		
 		if (distributed) {
 			for(int i = 0; i < no_of_objects; ++i) {
+				if (!selected(i)) {
+					continue;
+				}
+				
 				std::size_t no_in_grid = 0;
-				std::vector<std::size_t> points_not_in_grid;
 				for (std::size_t j = 0; j < object_size; ++j) {
 					auto global_id = points_of_objects[i][j];
-					auto local_id = global_to_local_id[global_id];
-					if (local_id == INVALID_ID) {
-						points_not_in_grid.push_back(global_id);
-					} else {
+					auto local_id = local_ids.find(global_id);
+					if (local_id != INVALID_ID) {
 						++no_in_grid;
 					}
 				}
 				
 				bool partly_in_grid = no_in_grid > 0;
-				bool partly_not_in_grid = !points_not_in_grid.empty();
+				bool partly_not_in_grid = no_in_grid < object_size;
 				
 				if (!partly_in_grid) {
 					continue;
 				}
 				
 				if (partly_not_in_grid) {
-					static auto const insert_global_ids = [](
-						std::vector<size_t> & seq, 
-						std::vector<size_t> & more_seq
-					) {
-						seq.insert(seq.end(), more_seq.begin(), more_seq.end());
-						std::sort(seq.begin(), seq.end());
-						auto last = std::unique(seq.begin(), seq.end());
-						seq.erase(last, seq.end());
-					};
-					
-					insert_global_ids(missing_global_ids, points_not_in_grid);
+					for (std::size_t j = 0; j < object_size; ++j) {
+						std::size_t global_id = points_of_objects[i][j];
+						if (local_ids.find(global_id) == INVALID_ID) {
+							missing_global_ids.push_back(global_id);
+						}
+					}
 					bdry_objects.push_back(i);
 					continue;
 				}
 				
-				vtkSmartPointer<CellType> cell = vtkSmartPointer<CellType>::New();
-				for (std::size_t j = 0; j < object_size; ++j) {
-					std::size_t global_id = points_of_objects[i][j];
-					std::size_t local_id = global_to_local_id[global_id];
-					BOOST_ASSERT(local_id != INVALID_ID);
-					cell->GetPointIds()->SetId(j, local_id);
+				cells.push_back<CellType>(points_of_objects[i], local_id_of);
+			}
+		} else if (point_ids) {
+			for(int i = 0; i < no_of_objects; ++i) {
+				if (selected(i)) {
+					cells.push_back<CellType>(points_of_objects[i], local_id_of);
 				}
-				
-				vtk_grid->InsertNextCell(cell->GetCellType(),cell->GetPointIds());
 			}
 		} else {
 			for(int i = 0; i < no_of_objects; ++i) {
-				vtkSmartPointer<CellType> cell = vtkSmartPointer<CellType>::New();
-				for (std::size_t j = 0; j < object_size; ++j) {
-					cell->GetPointIds()->SetId(j, points_of_objects[i][j]);
+				if (selected(i)) {
+					cells.push_back<CellType>(points_of_objects[i], [](int id) { return id; });
 				}
-				vtk_grid->InsertNextCell(cell->GetCellType(),cell->GetPointIds());
 			}
 		}
 		
 		return bdry_objects;
 	};
 	
-#define __insert_vtk_cell(__var, __cell_type)                                                                          \
+#define __insert_vtk_cell(__var, __cell_type, __selected)                                                              \
 	std::vector<std::size_t> missing_ ## __var ## s = insert_vtk_cell(                                                 \
 		grid.no_of_ ## __var ## s(),                                                                                   \
 		grid.points_of_ ## __var ## s(),                                                                               \
 		std::tuple_size<theta_grid::__var>::value,                                                                     \
-		hana::type_c<__cell_type>                                                                                      \
+		hana::int_c<__cell_type>,                                                                                      \
+		__selected                                                                                                     \
 	);
-	__insert_vtk_cell(tetraeder, vtkTetra)
-	__insert_vtk_cell(prism, vtkWedge)
-	__insert_vtk_cell(hexaeder, vtkHexahedron)
-	__insert_vtk_cell(pyramid, vtkPyramid)
-	__insert_vtk_cell(surfacetriangle, vtkTriangle)
-	__insert_vtk_cell(surfacequadrilateral, vtkQuad)
+	__insert_vtk_cell(tetraeder, VTK_TETRA, volume_selected)
+	__insert_vtk_cell(prism, VTK_WEDGE, volume_selected)
+	__insert_vtk_cell(hexaeder, VTK_HEXAHEDRON, volume_selected)
+	__insert_vtk_cell(pyramid, VTK_PYRAMID, volume_selected)
+	__insert_vtk_cell(surfacetriangle, VTK_TRIANGLE, surfacetriangle_selected)
+	__insert_vtk_cell(surfacequadrilateral, VTK_QUAD, surfacequadrilateral_selected)
 	
 #undef __insert_vtk_cell
 	
+	std::sort(missing_global_ids.begin(), missing_global_ids.end());
+	missing_global_ids.erase(
+		std::unique(missing_global_ids.begin(), missing_global_ids.end()), missing_global_ids.end());
+	
 	typedef std::vector<std::size_t> provided_global_ids;
 	std::vector<provided_global_ids> pro_gbl_ids_for_rank;
 	std::vector<provided_global_ids> pro_gbl_ids_from_rank;
@@ -380,136 +660,79 @@ make_vtk_unstructured_grid(theta_grid const& grid, theta_field const& field) {
 	
 	// exchange boundary points
 	if (distributed) {
-		typedef std::vector<std::size_t> required_global_ids;
-		std::vector<required_global_ids> req_gbl_ids_by_rank(mpi_size);
-		req_gbl_ids_by_rank[mpi_rank] = missing_global_ids;
-		
 		for(std::size_t i = 0; i < missing_global_ids.size(); ++i) {
-			BOOST_ASSERT(global_to_local_id[missing_global_ids[i]] == INVALID_ID);
+			BOOST_ASSERT(local_ids.find(missing_global_ids[i]) == INVALID_ID);
 		}
 		
 		for(std::size_t i = 1; i < missing_global_ids.size(); ++i) {
 			BOOST_ASSERT(missing_global_ids[i-1] < missing_global_ids[i]);
 		}
 		
-		// exchange sizes of req_gbl_ids_by_rank across all nodes using bcasts
+		// Owners of global ids are looked up in a distributed directory instead of broadcasting missing global ids to
+		// all nodes: Global ids are partitioned into contiguous ranges, one per node, and each node keeps the owners of
+		// the global ids in its range. Hence traffic is linear in the number of boundary points.
+		std::size_t const range_size = std::max<std::size_t>((grid_no_of_points + mpi_size - 1) / mpi_size, 1);
+		std::size_t const range_first = std::min(mpi_rank * range_size, grid_no_of_points);
+		std::size_t const range_last = std::min(range_first + range_size, grid_no_of_points);
+		auto const directory_of = [range_size](std::size_t global_id) { return global_id / range_size; };
+		
+		// register points of local grid at the directory
+		std::vector<std::size_t> owner_of(range_last - range_first, INVALID_ID);
 		{
-			std::vector<MPI_Request> reqs;
-			reqs.reserve(mpi_size);
-			
-			std::vector<std::size_t> sizes;
-			sizes.resize(mpi_size, 0);
-			sizes[mpi_rank] = missing_global_ids.size();
-			
-			for(int i = 0; i < mpi_size; ++i) {
-				reqs.push_back(
-					mpi::ibcast(&sizes[i], 1, i, MPI_COMM_WORLD)
-				);
+			std::vector<std::vector<std::size_t>> owned_for_rank(mpi_size);
+			for(std::size_t i = 0; i < no_of_points; ++i) {
+				std::size_t global_id = get_id(i);
+				owned_for_rank[directory_of(global_id)].push_back(global_id);
 			}
-			for(int i = 0; i < mpi_size; ++i) {
-				auto stat = mpi::wait(reqs[i]);
-				if (i != mpi_rank) {
-					req_gbl_ids_by_rank[i].resize(sizes[i], 0);
+			
+			std::vector<std::vector<std::size_t>> owned_from_rank = detail::alltoallv_ids(owned_for_rank);
+			for(std::size_t i = 0; i < mpi_size; ++i) {
+				for(auto global_id : owned_from_rank[i]) {
+					BOOST_ASSERT(global_id >= range_first && global_id < range_last);
+					owner_of[global_id - range_first] = i;
 				}
 			}
 		}
 		
-		// exchange req_gbl_ids_by_rank across all nodes using bcasts
-		{
-			std::vector<MPI_Request> reqs;
-			reqs.reserve(mpi_size);
-			for(int i = 0; i < mpi_size; ++i) {
-				reqs.push_back(
-					mpi::ibcast(req_gbl_ids_by_rank[i].data(), req_gbl_ids_by_rank[i].size(), i, MPI_COMM_WORLD)
-				);
-			}
-			for(int i = 0; i < mpi_size; ++i) {
-				auto stat = mpi::wait(reqs[i]);
-			}
+		// look up owners of missing points at the directory
+		std::vector<std::vector<std::size_t>> queries_for_rank(mpi_size);
+		for(auto global_id : missing_global_ids) {
+			queries_for_rank[directory_of(global_id)].push_back(global_id);
 		}
 		
-		// prepare global ids that this node can provide for other nodes
-		pro_gbl_ids_for_rank.resize(mpi_size);
+		std::vector<std::vector<std::size_t>> queries_from_rank = detail::alltoallv_ids(queries_for_rank);
+		std::vector<std::vector<std::size_t>> owners_for_rank(mpi_size);
 		for(std::size_t i = 0; i < mpi_size; ++i) {
-			if (i != mpi_rank) {
-				auto & missing = req_gbl_ids_by_rank[i];
-				
-				for(std::size_t x = 1; x < missing.size(); ++x) {
-					BOOST_ASSERT(missing[x-1] < missing[x]);
-				}
-				
-				auto & provided = pro_gbl_ids_for_rank[i];
-				for(std::size_t j = 0; j < missing.size(); ++j) {
-					auto global_id = missing[j];
-					auto local_id = global_to_local_id[global_id];
-					if (local_id != INVALID_ID) {
-						provided.push_back(global_id);
-					}
-				}
-				
-				for(std::size_t x = 1; x < provided.size(); ++x) {
-					BOOST_ASSERT(provided[x-1] < provided[x]);
-				}
+			for(auto global_id : queries_from_rank[i]) {
+				BOOST_ASSERT(global_id >= range_first && global_id < range_last);
+				owners_for_rank[i].push_back(owner_of[global_id - range_first]);
 			}
 		}
 		
+		std::vector<std::vector<std::size_t>> owners_from_rank = detail::alltoallv_ids(owners_for_rank);
+		
+		// request missing points from their owners, ranges of the directory are ascending so requests are sorted, too
 		pro_gbl_ids_from_rank.resize(mpi_size);
-		{
-			// send global_id of missing points between nodes using point-to-point communications
-			std::vector<MPI_Request> send_reqs;
-			send_reqs.reserve(mpi_size-1);
-			for(int i = 0; i < mpi_size; ++i) {
-				if (i != mpi_rank) {
-					
-					for(std::size_t x = 1; x < pro_gbl_ids_for_rank[i].size(); ++x) {
-						BOOST_ASSERT(pro_gbl_ids_for_rank[i][x-1] < pro_gbl_ids_for_rank[i][x]);
-					}
-					
-					send_reqs.push_back(
-						mpi::isend(
-							pro_gbl_ids_for_rank[i].data(),
-							pro_gbl_ids_for_rank[i].size(),
-							i/*dest*/,
-							mpi_rank/*tag*/,
-							MPI_COMM_WORLD
-						)
-					);
-				}
-			}
-			
-			//MPI_Barrier is not required here because MPI_Probe is blocking
-			
-			// probe no of provided points
-			for(int i = 0; i < mpi_size; ++i) {
-				if (i != mpi_rank) {
-					MPI_Status stat = mpi::probe(i, i, MPI_COMM_WORLD);
-					int count = mpi::get_count(stat, mpi::datatype(hana::type_c<std::size_t>));
-					pro_gbl_ids_from_rank[i].resize(boost::numeric_cast<std::size_t>(count), 0);
-				}
-			}
-			
-			// receive global_id of missing points between nodes using point-to-point communications
-			std::vector<MPI_Request> recv_reqs;
-			recv_reqs.reserve(mpi_size-1);
-			for(int i = 0; i < mpi_size; ++i) {
-				if (i != mpi_rank) {
-					recv_reqs.push_back(
-						mpi::irecv(
-							pro_gbl_ids_from_rank[i].data(),
-							pro_gbl_ids_from_rank[i].size(),
-							i /*source*/, 
-							i /*tag*/, 
-							MPI_COMM_WORLD
-						)
-					);
+		for(std::size_t i = 0; i < mpi_size; ++i) {
+			BOOST_ASSERT(owners_from_rank[i].size() == queries_for_rank[i].size());
+			for(std::size_t j = 0; j < queries_for_rank[i].size(); ++j) {
+				auto owner = owners_from_rank[i][j];
+				if (owner == INVALID_ID) {
+					//no one has this global id
+					continue;
 				}
+				BOOST_ASSERT(owner != mpi_rank);
+				pro_gbl_ids_from_rank[owner].push_back(queries_for_rank[i][j]);
 			}
-			
-			for(int i = 0; i < send_reqs.size(); ++i) {
-				auto stat = mpi::wait(send_reqs[i]);
-			}
-			for(int i = 0; i < recv_reqs.size(); ++i) {
-				auto stat = mpi::wait(recv_reqs[i]);
+		}
+		
+		// global ids that this node provides for other nodes
+		pro_gbl_ids_for_rank = detail::alltoallv_ids(pro_gbl_ids_from_rank);
+		for(std::size_t i = 0; i < mpi_size; ++i) {
+			auto & provided = pro_gbl_ids_for_rank[i];
+			for(std::size_t x = 0; x < provided.size(); ++x) {
+				BOOST_ASSERT(local_ids.find(provided[x]) != INVALID_ID);
+				BOOST_ASSERT(x == 0 || provided[x-1] < provided[x]);
 			}
 		}
 		
@@ -523,20 +746,55 @@ make_vtk_unstructured_grid(theta_grid const& grid, theta_field const& field) {
 				
 				for(std::size_t gi = 0; gi < provided_ids.size(); ++gi) {
 					auto global_id = provided_ids[gi];
-					BOOST_ASSERT(global_to_local_id[global_id] == INVALID_ID);
+					BOOST_ASSERT(local_ids.find(global_id) == INVALID_ID);
 					auto local_id = no_of_points+no_of_provided_global_ids;
 					BOOST_ASSERT(local_id != INVALID_ID);
-					global_to_local_id[global_id] = local_id;
+					local_ids.insert(global_id, local_id);
 					++no_of_provided_global_ids;
-					
-					points->InsertNextPoint(
-						grid.points()[global_id].x,
-						grid.points()[global_id].y,
-						grid.points()[global_id].z
-					);
 				}
 			}
 		}
+		local_ids.sort();
+	}
+	
+	// coordinates of local points followed by those of boundary points are copied into a pre-sized buffer at once
+	{
+		vtkSmartPointer<vtkFloatArray> coords = vtkSmartPointer<vtkFloatArray>::New();
+		coords->SetNumberOfComponents(3);
+		coords->SetNumberOfTuples(boost::numeric_cast<vtkIdType>(no_of_exported_points + no_of_provided_global_ids));
+		float * coord = coords->GetPointer(0);
+		
+		auto const copy_point = [&grid, &coord](std::size_t global_id) {
+			theta_grid::point const& point = grid.point_of(boost::numeric_cast<int>(global_id));
+			*coord++ = static_cast<float>(point.x);
+			*coord++ = static_cast<float>(point.y);
+			*coord++ = static_cast<float>(point.z);
+		};
+		
+		if (point_ids) {
+			for(auto i : *point_ids) {
+				copy_point(get_id(i));
+			}
+		} else {
+			for(std::size_t i = 0; i < no_of_points; ++i) {
+				BOOST_ASSERT(get_id(i) < grid_no_of_points);
+				copy_point(get_id(i));
+			}
+		}
+		
+		if (distributed) {
+			for(std::size_t i = 0; i < mpi_size; ++i) {
+				if (i != mpi_rank) {
+					for(auto global_id : pro_gbl_ids_from_rank[i]) {
+						copy_point(global_id);
+					}
+				}
+			}
+		}
+		
+		vtkSmartPointer<vtkPoints> points = vtkSmartPointer<vtkPoints>::New();
+		points->SetData(coords);
+		vtk_grid->SetPoints(points);
 	}
 	
 	// add boundary geometry
@@ -547,12 +805,12 @@ make_vtk_unstructured_grid(theta_grid const& grid, theta_field const& field) {
 			auto const& object_size,
 			auto cell_type
 		) {
-			typedef typename decltype(cell_type)::type CellType;
+			static constexpr int CellType = decltype(cell_type)::value;
 			for(auto i : missing_objects) {
 				bool partly_not_in_grid = false;
 				for (std::size_t j = 0; j < object_size; ++j) {
 					auto global_id = points_of_objects[i][j];
-					auto local_id = global_to_local_id[global_id];
+					auto local_id = local_ids.find(global_id);
 					if (local_id == INVALID_ID) {
 						//no one has this global id so we dont add this object
 						partly_not_in_grid = true;
@@ -563,15 +821,7 @@ make_vtk_unstructured_grid(theta_grid const& grid, theta_field const& field) {
 					continue;
 				}
 				
-				vtkSmartPointer<CellType> cell = vtkSmartPointer<CellType>::New();
-				for (std::size_t j = 0; j < object_size; ++j) {
-					auto global_id = points_of_objects[i][j];
-					auto local_id = global_to_local_id[global_id];
-					BOOST_ASSERT(local_id != INVALID_ID);
-					cell->GetPointIds()->SetId(j, local_id);
-				}
-				
-				vtk_grid->InsertNextCell(cell->GetCellType(),cell->GetPointIds());
+				cells.push_back<CellType>(points_of_objects[i], local_id_of);
 			}
 		};
 		
@@ -580,227 +830,276 @@ make_vtk_unstructured_grid(theta_grid const& grid, theta_field const& field) {
 		missing_ ## __var ## s,                                                                                        \
 		grid.points_of_ ## __var ## s(),                                                                               \
 		std::tuple_size<theta_grid::__var>::value,                                                                     \
-		hana::type_c<__cell_type>                                                                                      \
+		hana::int_c<__cell_type>                                                                                       \
 	);
 	
-		__insert_missing_vtk_cell(tetraeder, vtkTetra)
-		__insert_missing_vtk_cell(prism, vtkWedge)
-		__insert_missing_vtk_cell(hexaeder, vtkHexahedron)
-		__insert_missing_vtk_cell(pyramid, vtkPyramid)
-		__insert_missing_vtk_cell(surfacetriangle, vtkTriangle)
-		__insert_missing_vtk_cell(surfacequadrilateral, vtkQuad)
+		__insert_missing_vtk_cell(tetraeder, VTK_TETRA)
+		__insert_missing_vtk_cell(prism, VTK_WEDGE)
+		__insert_missing_vtk_cell(hexaeder, VTK_HEXAHEDRON)
+		__insert_missing_vtk_cell(pyramid, VTK_PYRAMID)
+		__insert_missing_vtk_cell(surfacetriangle, VTK_TRIANGLE)
+		__insert_missing_vtk_cell(surfacequadrilateral, VTK_QUAD)
 	
 #undef __insert_missing_vtk_cell
 	}
 	
-	auto exchange_point_data = [&](
-		std::vector<double> const& local_data,
-		std::vector<std::vector<double>> & data_by_rank
-	) -> void {
-		data_by_rank.resize(mpi_size, std::vector<double>{});
-		
-		std::vector<std::vector<double>> local_data_for_rank(mpi_size, std::vector<double>{});
-		for(int i = 0; i < mpi_size; ++i) {
+	cells.set_cells_of(vtk_grid);
+	
+	// point data of provided points is looked up by local id, so global ids are not needed after this point
+	std::vector<std::vector<std::size_t>> send_ids(mpi_size);
+	std::vector<std::size_t> recv_counts(mpi_size, 0);
+	if (distributed) {
+		for(std::size_t i = 0; i < mpi_size; ++i) {
 			if (i != mpi_rank) {
-				auto & data_for_remote = local_data_for_rank[i];
-				auto & global_ids_for_remote = pro_gbl_ids_for_rank[i];
-				data_for_remote.resize(global_ids_for_remote.size(), 0);
-				for(std::size_t g = 0; g < global_ids_for_remote.size(); ++g) {
-					auto global_id = global_ids_for_remote[g];
-					auto local_id = global_to_local_id[global_id];
-					BOOST_ASSERT(local_id != INVALID_ID);
-					data_for_remote[g] = local_data[local_id];
+				for(auto global_id : pro_gbl_ids_for_rank[i]) {
+					auto local_id = local_ids.find(global_id);
+					BOOST_ASSERT(local_id < no_of_points);
+					send_ids[i].push_back(local_id);
 				}
+				recv_counts[i] = pro_gbl_ids_from_rank[i].size();
 			}
 		}
-		
-		std::vector<MPI_Request> send_reqs;
-		send_reqs.reserve(mpi_size-1);
-		
-		for(int i = 0; i < mpi_size; ++i) {
-			if (i != mpi_rank) {
-				//allocate recv buffer
-				data_by_rank[i].resize(pro_gbl_ids_from_rank[i].size(), 0);
-				
-				//send data
-				send_reqs.push_back(
-					mpi::isend(
-						local_data_for_rank[i].data(),
-						local_data_for_rank[i].size(),
-						i/*dest*/,
-						mpi_rank/*tag*/,
-						MPI_COMM_WORLD
-					)
-				);
-			}
-		}
-		
-		for(int i = 0; i < mpi_size; ++i) {
-			if (i != mpi_rank) {
-				MPI_Status stat = mpi::probe(i, i, MPI_COMM_WORLD);
-				int count = mpi::get_count(stat, mpi::datatype(hana::type_c<double>));
-				data_by_rank[i].resize(boost::numeric_cast<std::size_t>(count), 0);
-			}
-		}
-		
-		std::vector<MPI_Request> recv_reqs;
-		recv_reqs.reserve(mpi_size-1);
-		for(int i = 0; i < mpi_size; ++i) {
-			if (i != mpi_rank) {
-				recv_reqs.push_back(
-					mpi::irecv(
-						data_by_rank[i].data(),
-						data_by_rank[i].size(),
-						i /*source*/,
-						i /*tag*/,
-						MPI_COMM_WORLD
-					)
-				);
+	}
+	
+	return { no_of_points, std::move(point_ids), std::move(send_ids), std::move(recv_counts), vtk_grid };
+}
+
+namespace detail {
+
+/* Point data of a variable and the buffer where its boundary values received from other processes are stored */
+typedef std::pair<std::vector<double> const*, double*> exchanged_var;
+
+/* Sends point data of owned points to processes which have them as boundary points and stores the received point data
+ * of boundary points in order of ranks. All variables are packed into a single message per process, each one as a
+ * contiguous block. Must be called by all processes. */
+static void
+exchange_point_data(vtk_domain_topology const& topology, std::vector<exchanged_var> const& vars) {
+	std::size_t const mpi_size = boost::numeric_cast<std::size_t>(mpi::comm_size());
+	std::size_t const mpi_rank = boost::numeric_cast<std::size_t>(mpi::comm_rank());
+	
+	std::vector<std::size_t> recv_offsets(mpi_size, 0);
+	std::size_t no_of_provided_global_ids = 0;
+	for(std::size_t i = 0; i < mpi_size; ++i) {
+		recv_offsets[i] = no_of_provided_global_ids;
+		no_of_provided_global_ids += topology.recv_counts()[i];
+	}
+	
+	std::size_t const no_of_vars = vars.size();
+	if (no_of_vars == 0) {
+		return;
+	}
+	
+	std::vector<std::vector<double>> local_data_for_rank(mpi_size, std::vector<double>{});
+	for(std::size_t i = 0; i < mpi_size; ++i) {
+		auto & data_for_remote = local_data_for_rank[i];
+		auto & local_ids_for_remote = topology.send_ids()[i];
+		std::size_t const count = local_ids_for_remote.size();
+		data_for_remote.resize(no_of_vars * count, 0);
+		for(std::size_t v = 0; v < no_of_vars; ++v) {
+			std::vector<double> const& local_data = *vars[v].first;
+			for(std::size_t g = 0; g < count; ++g) {
+				data_for_remote[v*count + g] = local_data[local_ids_for_remote[g]];
 			}
 		}
-		
-		for(int i = 0; i < send_reqs.size(); ++i) {
-			auto stat = mpi::wait(send_reqs[i]);
-		}
-		for(int i = 0; i < recv_reqs.size(); ++i) {
-			auto stat = mpi::wait(recv_reqs[i]);
+	}
+	
+	std::vector<double> data_from_remotes(no_of_vars * no_of_provided_global_ids, 0);
+	
+	// message sizes are known from the topology, so neither probes nor empty messages are required
+	std::vector<MPI_Request> reqs;
+	for(std::size_t i = 0; i < mpi_size; ++i) {
+		if (i != mpi_rank && topology.recv_counts()[i] > 0) {
+			reqs.push_back(
+				mpi::irecv(
+					data_from_remotes.data() + no_of_vars * recv_offsets[i],
+					no_of_vars * topology.recv_counts()[i],
+					i /*source*/,
+					i /*tag*/,
+					MPI_COMM_WORLD
+				)
+			);
 		}
-	};
+	}
 	
-#define __exchange_var(__var)                                                                                          \
-	std::vector<std::vector<double>> bdry_ ## __var ## _from_rank;                                                     \
-	if (has_ ## __var && distributed) {                                                                                \
-		exchange_point_data(field.__var(), bdry_ ## __var ## _from_rank);                                              \
+	for(std::size_t i = 0; i < mpi_size; ++i) {
+		if (i != mpi_rank && !local_data_for_rank[i].empty()) {
+			reqs.push_back(
+				mpi::isend(
+					local_data_for_rank[i].data(),
+					local_data_for_rank[i].size(),
+					i/*dest*/,
+					mpi_rank/*tag*/,
+					MPI_COMM_WORLD
+				)
+			);
+		}
 	}
-		
-	__exchange_var(density)
-	__exchange_var(x_velocity)
-	__exchange_var(y_velocity)
-	__exchange_var(z_velocity)
-	__exchange_var(pressure)
-	__exchange_var(residual)
 	
-#undef __exchange_var
+	for(std::size_t i = 0; i < reqs.size(); ++i) {
+		auto stat = mpi::wait(reqs[i]);
+	}
 	
-	auto insert_vtk_pointdata = [&](
-		const char * name,
-		std::vector<double> const& f,
-		std::vector<std::vector<double>> & more_f
-	) {
-		vtkSmartPointer<vtkDoubleArray> pd = vtkSmartPointer<vtkDoubleArray>::New();
-		
-		pd->SetNumberOfValues(no_of_points+no_of_provided_global_ids);
-		pd->SetName(name);
-		
-		for (std::size_t i = 0; i < no_of_points; ++i) {
-			pd->SetValue(i, f[i]);
-		}
-		
-		for(int i = 0; i < mpi_size; ++i) {
-			if (i != mpi_rank) {
-				auto & more_f_from_rank = more_f[i];
-				auto & gbl_ids_from_rank = pro_gbl_ids_from_rank[i];
-				BOOST_ASSERT(more_f_from_rank.size() == gbl_ids_from_rank.size());
-				
-				for(std::size_t d = 0; d < more_f_from_rank.size(); ++d) {
-					auto data_f = more_f_from_rank[d];
-					auto global_id = gbl_ids_from_rank[d];
-					auto local_id = global_to_local_id[global_id];
-					BOOST_ASSERT(local_id != INVALID_ID);
-					BOOST_ASSERT(local_id < (no_of_points + no_of_provided_global_ids));
-					pd->SetValue(local_id, data_f);
-				}
-				
-			}
+	for(std::size_t i = 0; i < mpi_size; ++i) {
+		std::size_t const count = topology.recv_counts()[i];
+		double const* data_from_remote = data_from_remotes.data() + no_of_vars * recv_offsets[i];
+		for(std::size_t v = 0; v < no_of_vars; ++v) {
+			std::copy_n(data_from_remote + v*count, count, vars[v].second + recv_offsets[i]);
 		}
-		
-		vtk_grid->GetPointData()->AddArray(pd);
-	};
-	
-#define __insert_vtk_pointdata(__field)                                                                                \
-	{                                                                                                                  \
-		if (has_ ## __field) {                                                                                         \
-			insert_vtk_pointdata(                                                                                  \
-				#__field,                                                                                               \
-				field.__field(),                                                                                      \
-				bdry_ ## __field ## _from_rank                                                                       \
-			);                                                                                                         \
-		}                                                                                                              \
 	}
+}
 
-	auto insert_vtk_pointdata_vec = [&](
-		const char * name,
-		std::vector<double> const& f1,
-		std::vector<double> const& f2,
-		std::vector<double> const& f3,
-		std::vector<std::vector<double>> & more_f1,
-		std::vector<std::vector<double>> & more_f2,
-		std::vector<std::vector<double>> & more_f3
-	) {
-		vtkSmartPointer<vtkDoubleArray> f = vtkSmartPointer<vtkDoubleArray>::New();
-			f->SetNumberOfComponents(3);
-			f->SetNumberOfTuples(no_of_points+no_of_provided_global_ids);
-			f->SetName(name);
-			
-			for (std::size_t i = 0; i < no_of_points; ++i) {
-				f->SetTuple3(i, f1[i], f2[i], f3[i]);
-			}
-			
-			for(int i = 0; i < mpi_size; ++i) {
-				if (i != mpi_rank) {
-					auto & more_f1_from_rank = more_f1[i];
-					auto & more_f2_from_rank = more_f2[i];
-					auto & more_f3_from_rank = more_f3[i];
-					auto & gbl_ids_from_rank = pro_gbl_ids_from_rank[i];
-					BOOST_ASSERT(more_f1_from_rank.size() == gbl_ids_from_rank.size());
-					BOOST_ASSERT(more_f2_from_rank.size() == gbl_ids_from_rank.size());
-					BOOST_ASSERT(more_f3_from_rank.size() == gbl_ids_from_rank.size());
-					
-					for(std::size_t d = 0; d < more_f1_from_rank.size(); ++d) {
-						auto data_f1 = more_f1_from_rank[d];
-						auto data_f2 = more_f2_from_rank[d];
-						auto data_f3 = more_f3_from_rank[d];
-						auto global_id = gbl_ids_from_rank[d];
-						auto local_id = global_to_local_id[global_id];
-						BOOST_ASSERT(local_id != INVALID_ID);
-						BOOST_ASSERT(local_id < (no_of_points + no_of_provided_global_ids));
-						f->SetTuple3(local_id, data_f1, data_f2, data_f3);
-					}
-					
-				}
+/* Number of values of each variable of a field after values of boundary points have been appended to those of the
+ * exported owned points, see make_vtk_unstructured_grid() */
+static std::size_t
+point_data_capacity(vtk_domain_topology const& topology) {
+	std::size_t no_of_values = topology.point_ids() ? topology.point_ids()->size() : topology.no_of_points();
+	for(auto count : topology.recv_counts()) {
+		no_of_values += count;
+	}
+	return no_of_values;
+}
+
+/* namespace detail */ }
+
+HBRS_THETA_UTILS_API
+vtkSmartPointer<vtkUnstructuredGrid>
+make_vtk_unstructured_grid(vtk_domain_topology const& topology, theta_field & field) {
+	std::size_t const mpi_size = boost::numeric_cast<std::size_t>(mpi::comm_size());
+	BOOST_ASSERT(topology.send_ids().size() == mpi_size);
+	BOOST_ASSERT(topology.recv_counts().size() == mpi_size);
+	
+	std::size_t const no_of_points = topology.no_of_points();
+	
+#define __has_var(__var)                                                                                               \
+	auto const has_ ## __var = field.__var().size() > 0;                                                               \
+	if (has_ ## __var && field.__var().size() != no_of_points) {                                                       \
+		BOOST_THROW_EXCEPTION(std::runtime_error{                                                                      \
+			std::string{"dimensions of variable "} + #__var + " do not match size of grid"                             \
+		});                                                                                                            \
+	}                                                                                                                  \
+	
+	__has_var(density)
+	__has_var(x_velocity)
+	__has_var(y_velocity)
+	__has_var(z_velocity)
+	__has_var(pressure)
+	__has_var(residual)
+	
+#undef __has_var
+	
+	// points and cells are shared with the topology, only point data is added to this grid
+	vtkSmartPointer<vtkUnstructuredGrid> vtk_grid = vtkSmartPointer<vtkUnstructuredGrid>::New();
+	detail::observe_vtk_object(vtk_grid);
+	vtk_grid->ShallowCopy(topology.geometry());
+	
+	std::size_t const no_of_values = detail::point_data_capacity(topology);
+	std::size_t const no_of_exported_points = topology.point_ids() ? topology.point_ids()->size() : no_of_points;
+	
+	// Point data is wrapped into vtk arrays without copying, hence the returned grid references the buffers of field.
+	// Values of boundary points are received behind the values of owned points, i.e. into spare capacity of field.
+	// If cells are selected, values of exported points are moved to the front afterwards, which can be done in place
+	// because exported points are in ascending order of their local ids, and boundary values are moved behind them.
+	std::vector<std::vector<double> *> vars;
+	
+#define __add_var(__var)                                                                                               \
+	if (has_ ## __var) {                                                                                               \
+		vars.push_back(&field.__var());                                                                                \
+	}
+	
+	__add_var(density)
+	if (has_x_velocity && has_y_velocity && has_z_velocity) {
+		vars.push_back(&field.x_velocity());
+		vars.push_back(&field.y_velocity());
+		vars.push_back(&field.z_velocity());
+	}
+	__add_var(pressure)
+	__add_var(residual)
+	
+#undef __add_var
+	
+	std::vector<detail::exchanged_var> exchanged_vars;
+	for(auto var : vars) {
+		var->resize(no_of_points + (no_of_values - no_of_exported_points));
+		exchanged_vars.emplace_back(var, var->data() + no_of_points);
+	}
+	
+	detail::exchange_point_data(topology, exchanged_vars);
+	
+	if (topology.point_ids()) {
+		for(auto var : vars) {
+			std::vector<double> & f = *var;
+			std::size_t k = 0;
+			for(auto i : *topology.point_ids()) {
+				BOOST_ASSERT(k <= i);
+				f[k++] = f[i];
 			}
-			
-			vtk_grid->GetPointData()->AddArray(f);
+			std::copy(f.begin() + no_of_points, f.end(), f.begin() + no_of_exported_points);
+			f.resize(no_of_values);
+		}
+	}
+	
+	auto make_vtk_pointdata = [&](const char * name, std::vector<double> & f) {
+		BOOST_ASSERT(f.size() == no_of_values);
+		vtkSmartPointer<vtkDoubleArray> pd = vtkSmartPointer<vtkDoubleArray>::New();
+		pd->SetName(name);
+		pd->SetArray(f.data(), boost::numeric_cast<vtkIdType>(no_of_values), 1 /* save */);
+		vtk_grid->GetPointData()->AddArray(pd);
 	};
 	
-#define __insert_vtk_pointdata_vec(__name, __field1, __field2, __field3)                                               \
-	{                                                                                                                  \
-		auto has_ ## __name = has_ ## __field1 && has_ ## __field2 && has_ ## __field3;                                \
-		if (has_ ## __name) {                                                                                          \
-			insert_vtk_pointdata_vec(                                                                                  \
-				#__name,                                                                                               \
-				field.__field1(),                                                                                      \
-				field.__field2(),                                                                                      \
-				field.__field2(),                                                                                      \
-				bdry_ ## __field1 ## _from_rank,                                                                       \
-				bdry_ ## __field2 ## _from_rank,                                                                       \
-				bdry_ ## __field3 ## _from_rank                                                                        \
-			);                                                                                                         \
-		}                                                                                                              \
+#define __make_vtk_pointdata(__field)                                                                                  \
+	if (has_ ## __field) {                                                                                             \
+		make_vtk_pointdata(#__field, field.__field());                                                                 \
+	}
+	
+	// vector components are kept in separate arrays instead of interleaving them
+	auto make_vtk_pointdata_vec = [&](
+		const char * name,
+		std::vector<double> & f1,
+		std::vector<double> & f2,
+		std::vector<double> & f3
+	) {
+		std::array<std::vector<double> *, 3> const fs{ &f1, &f2, &f3 };
+		vtkSmartPointer<vtkSOADataArrayTemplate<double>> pd = vtkSmartPointer<vtkSOADataArrayTemplate<double>>::New();
+		pd->SetNumberOfComponents(3);
+		pd->SetName(name);
+		
+		for(int c = 0; c < 3; ++c) {
+			BOOST_ASSERT(fs[c]->size() == no_of_values);
+			pd->SetArray(
+				c,
+				fs[c]->data(),
+				boost::numeric_cast<vtkIdType>(no_of_values),
+				true /* updateMaxId */,
+				true /* save */
+			);
+		}
+		
+		vtk_grid->GetPointData()->AddArray(pd);
+	};
+	
+#define __make_vtk_pointdata_vec(__name, __field1, __field2, __field3)                                                 \
+	if (has_ ## __field1 && has_ ## __field2 && has_ ## __field3) {                                                    \
+		make_vtk_pointdata_vec(#__name, field.__field1(), field.__field2(), field.__field3());                         \
 	}
 	
 	// TODO: Make it possible to select fields that gonna be written
-	__insert_vtk_pointdata(density)
-	__insert_vtk_pointdata_vec(velocity, x_velocity, y_velocity, z_velocity)
-	__insert_vtk_pointdata(pressure)
-	__insert_vtk_pointdata(residual)
+	__make_vtk_pointdata(density)
+	__make_vtk_pointdata_vec(velocity, x_velocity, y_velocity, z_velocity)
+	__make_vtk_pointdata(pressure)
+	__make_vtk_pointdata(residual)
 	
-#undef __insert_vtk_pointdata_vec
-#undef __insert_vtk_pointdata
+#undef __make_vtk_pointdata_vec
+#undef __make_vtk_pointdata
 	
 	return vtk_grid;
 }
 
+HBRS_THETA_UTILS_API
+vtkSmartPointer<vtkUnstructuredGrid>
+make_vtk_unstructured_grid(theta_grid const& grid, theta_field & field) {
+	return make_vtk_unstructured_grid(make_vtk_domain_topology(grid, field.global_id()), field);
+}
+
 HBRS_THETA_UTILS_API
 void
 write_vtk_legacy_ascii(vtkSmartPointer<vtkUnstructuredGrid> grid, char const * file_path) {
@@ -819,9 +1118,69 @@ write_vtk_legacy_ascii(vtkSmartPointer<vtkUnstructuredGrid> grid, char const * f
 	wtr->Write();
 }
 
+namespace detail {
+
+/* Selects compressor, compression level and encoding of data arrays of a VTK XML writer */
+static void
+set_vtk_xml_encoding(vtkXMLWriter * wtr, vtk_xml_encoding const& encoding) {
+#if VTK_MAJOR_VERSION < 8 || (VTK_MAJOR_VERSION == 8 && VTK_MINOR_VERSION < 2)
+	if (encoding.compressor == vtk_compressor::lz4 || encoding.compressor == vtk_compressor::lzma ||
+		encoding.level > 0)
+	{
+		BOOST_THROW_EXCEPTION(unsupported_format_exception{} << errinfo_vtk_error{
+			"LZ4 and LZMA compressors and compression levels require VTK 8.2 or later"
+		});
+	}
+#endif
+	
+	switch (encoding.compressor) {
+		case vtk_compressor::none:
+			wtr->SetCompressorTypeToNone();
+			break;
+		case vtk_compressor::zlib:
+			wtr->SetCompressorTypeToZLib();
+			break;
+#if VTK_MAJOR_VERSION > 8 || (VTK_MAJOR_VERSION == 8 && VTK_MINOR_VERSION >= 2)
+		case vtk_compressor::lz4:
+			wtr->SetCompressorTypeToLZ4();
+			break;
+		case vtk_compressor::lzma:
+			wtr->SetCompressorTypeToLZMA();
+			break;
+#endif
+		default:
+			BOOST_ASSERT_MSG(false, "unknown compressor");
+	}
+	
+#if VTK_MAJOR_VERSION > 8 || (VTK_MAJOR_VERSION == 8 && VTK_MINOR_VERSION >= 2)
+	if (encoding.level > 0) {
+		wtr->SetCompressionLevel(encoding.level);
+	}
+#endif
+	
+	if (encoding.raw_appended) {
+		wtr->SetDataModeToAppended();
+		wtr->EncodeAppendedDataOff();
+	} else {
+		wtr->SetDataModeToBinary();
+	}
+}
+
+/* namespace detail */ }
+
 HBRS_THETA_UTILS_API
 void
 write_vtk_xml_binary(vtkSmartPointer<vtkUnstructuredGrid> grid, char const * file_path) {
+	write_vtk_xml_binary(grid, file_path, vtk_xml_encoding{});
+}
+
+HBRS_THETA_UTILS_API
+void
+write_vtk_xml_binary(
+	vtkSmartPointer<vtkUnstructuredGrid> grid,
+	char const * file_path,
+	vtk_xml_encoding const& encoding
+) {
 	vtkNew<vtkXMLUnstructuredGridWriter> wtr;
 	vtkSmartPointer<detail::ErrorObserver> throw_error{new detail::ErrorObserver{
 		[](auto caller, auto calldata){
@@ -832,9 +1191,7 @@ write_vtk_xml_binary(vtkSmartPointer<vtkUnstructuredGrid> grid, char const * fil
 	}};
 	wtr->AddObserver(vtkCommand::ErrorEvent, throw_error);
 	wtr->SetFileName(file_path);
-// 	wtr->SetDataModeToAscii();
-	wtr->SetDataModeToBinary();
-	wtr->SetCompressorTypeToZLib();
+	detail::set_vtk_xml_encoding(wtr.GetPointer(), encoding);
 	wtr->SetInputData(grid);
 	wtr->Write();
 }
@@ -842,6 +1199,16 @@ write_vtk_xml_binary(vtkSmartPointer<vtkUnstructuredGrid> grid, char const * fil
 HBRS_THETA_UTILS_API
 void
 write_vtk_xml_binary_parallel(vtkSmartPointer<vtkUnstructuredGrid> grid, char const * file_path) {
+	write_vtk_xml_binary_parallel(grid, file_path, vtk_xml_encoding{});
+}
+
+HBRS_THETA_UTILS_API
+void
+write_vtk_xml_binary_parallel(
+	vtkSmartPointer<vtkUnstructuredGrid> grid,
+	char const * file_path,
+	vtk_xml_encoding const& encoding
+) {
 	vtkSmartPointer<vtkMPIController> ctrl = vtkSmartPointer<vtkMPIController>::New();
 	ctrl->Initialize(0,0,true);
 	vtkMultiProcessController::SetGlobalController(ctrl);
@@ -861,9 +1228,7 @@ write_vtk_xml_binary_parallel(vtkSmartPointer<vtkUnstructuredGrid> grid, char co
 	}};
 	wtr->AddObserver(vtkCommand::ErrorEvent, throw_error);
 	wtr->SetFileName(file_path);
-// 	wtr->SetDataModeToAscii();
-	wtr->SetDataModeToBinary();
-	wtr->SetCompressorTypeToZLib();
+	detail::set_vtk_xml_encoding(wtr.GetPointer(), encoding);
 	wtr->SetInputData(grid);
 	wtr->Write();
 	
@@ -941,6 +1306,725 @@ write_pvd(std::vector<fs::path> const& series, fs::path filename) {
 
 HBRS_THETA_UTILS_NAMESPACE_END
 
+#include <hbrs/theta_utils/dt/exception.hpp>
+#include <hbrs/mpl/detail/mpi.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/numeric/conversion/cast.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/detail/endian.hpp>
+#include <boost/system/error_code.hpp>
+#include <vtkCellArray.h>
+#include <vtkFloatArray.h>
+#include <vtkPoints.h>
+#include <vtkVersion.h>
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+HBRS_THETA_UTILS_NAMESPACE_BEGIN
+namespace mpi = hbrs::mpl::detail::mpi;
+
+namespace detail {
+
+#if VTK_MAJOR_VERSION >= 9
+typedef vtkIdType const* vtk_cell_points;
+#else
+typedef vtkIdType * vtk_cell_points;
+#endif
+
+/* Writes unstructured grids to VTU files without building a vtkUnstructuredGrid: Points and cells are read from the
+ * topology and point data is read from the buffers of the field. Data arrays are written uncompressed to the appended
+ * section, each one in chunks of chunk_size bytes, so no array is copied as a whole. Point data of boundary points is
+ * exchanged on construction, hence construction must be done by all processes, but writing can be done on any thread.
+ */
+struct vtu_stream_writer {
+	static constexpr std::size_t chunk_size = 1<<20;
+	
+	vtu_stream_writer(vtk_domain_topology const& topology, theta_field const& field)
+	: topology_{topology}, mpi_size_{mpi::comm_size()}, mpi_rank_{mpi::comm_rank()}, no_of_provided_global_ids_{0} {
+		std::size_t const no_of_points = topology.no_of_points();
+		for(auto count : topology.recv_counts()) {
+			no_of_provided_global_ids_ += count;
+		}
+		
+#define __has_var(__var)                                                                                               \
+	auto const has_ ## __var = field.__var().size() > 0;                                                               \
+	if (has_ ## __var && field.__var().size() != no_of_points) {                                                       \
+		BOOST_THROW_EXCEPTION(std::runtime_error{                                                                      \
+			std::string{"dimensions of variable "} + #__var + " do not match size of grid"                             \
+		});                                                                                                            \
+	}                                                                                                                  \
+	
+		__has_var(density)
+		__has_var(x_velocity)
+		__has_var(y_velocity)
+		__has_var(z_velocity)
+		__has_var(pressure)
+		__has_var(residual)
+		
+#undef __has_var
+		
+		// same variables in same order as make_vtk_unstructured_grid()
+		if (has_density) {
+			vars_.push_back({ "density", { &field.density() } });
+		}
+		if (has_x_velocity && has_y_velocity && has_z_velocity) {
+			vars_.push_back({ "velocity", { &field.x_velocity(), &field.y_velocity(), &field.z_velocity() } });
+		}
+		if (has_pressure) {
+			vars_.push_back({ "pressure", { &field.pressure() } });
+		}
+		if (has_residual) {
+			vars_.push_back({ "residual", { &field.residual() } });
+		}
+		
+		std::vector<exchanged_var> exchanged_vars;
+		for(auto & var : vars_) {
+			var.boundary_values.resize(var.components.size());
+			for(std::size_t c = 0; c < var.components.size(); ++c) {
+				var.boundary_values[c].resize(no_of_provided_global_ids_);
+				exchanged_vars.emplace_back(var.components[c], var.boundary_values[c].data());
+			}
+		}
+		exchange_point_data(topology, exchanged_vars);
+	}
+	
+	/* Writes a VTU file or, if several processes take part, the piece of this process and a PVTU file which
+	 * references the pieces of all processes */
+	void
+	write(fs::path const& file_path) const {
+		if (mpi_size_ > 1) {
+			write_piece(piece_path(file_path, mpi_rank_));
+			if (mpi_rank_ == 0) {
+				write_summary(file_path);
+			}
+		} else {
+			write_piece(file_path);
+		}
+	}
+	
+private:
+	struct variable {
+		char const * name;
+		std::vector<std::vector<double> const*> components;
+		std::vector<std::vector<double>> boundary_values;
+	};
+	
+	static char const *
+	byte_order() {
+	#if defined(BOOST_LITTLE_ENDIAN)
+		return "LittleEndian";
+	#elif defined(BOOST_BIG_ENDIAN)
+		return "BigEndian";
+	#else
+		#error "unsupported endianness"
+	#endif
+	}
+	
+	/* name of pieces matches the one of vtkXMLPUnstructuredGridWriter */
+	static fs::path
+	piece_path(fs::path const& file_path, int piece) {
+		return file_path.parent_path() /
+			(file_path.stem().string() + '_' + boost::lexical_cast<std::string>(piece) + ".vtu");
+	}
+	
+	static void
+	throw_if_failed(std::ofstream const& out, fs::path const& file_path) {
+		if (!out) {
+			BOOST_THROW_EXCEPTION((
+				fs::filesystem_error{
+					"writing vtu file failed",
+					file_path,
+					make_error_code(boost::system::errc::io_error)
+				}
+			));
+		}
+	}
+	
+	/* Writes the size of an appended block followed by no_of_values values returned by next(), which are buffered in
+	 * a chunk of at most chunk_size bytes */
+	template<typename T, typename Generator>
+	static void
+	write_block(std::ostream & out, std::size_t no_of_values, Generator && next) {
+		std::uint64_t const no_of_bytes = no_of_values * sizeof(T);
+		out.write(reinterpret_cast<char const*>(&no_of_bytes), sizeof(no_of_bytes));
+		
+		std::vector<T> chunk(std::min(no_of_values, std::max<std::size_t>(chunk_size / sizeof(T), 1)));
+		for(std::size_t first = 0; first < no_of_values; first += chunk.size()) {
+			std::size_t const count = std::min(chunk.size(), no_of_values - first);
+			for(std::size_t i = 0; i < count; ++i) {
+				chunk[i] = next();
+			}
+			out.write(reinterpret_cast<char const*>(chunk.data()), count * sizeof(T));
+		}
+	}
+	
+	void
+	write_piece(fs::path const& file_path) const {
+		vtkUnstructuredGrid * geometry = topology_.geometry();
+		std::size_t const no_of_points = boost::numeric_cast<std::size_t>(geometry->GetNumberOfPoints());
+		std::size_t const no_of_cells = boost::numeric_cast<std::size_t>(geometry->GetNumberOfCells());
+#if VTK_MAJOR_VERSION >= 9
+		std::size_t const no_of_ids = boost::numeric_cast<std::size_t>(
+			geometry->GetCells()->GetNumberOfConnectivityIds());
+#else
+		std::size_t const no_of_ids = boost::numeric_cast<std::size_t>(
+			geometry->GetCells()->GetNumberOfConnectivityEntries() - geometry->GetNumberOfCells());
+#endif
+		std::size_t const no_of_exported_points = no_of_points - no_of_provided_global_ids_;
+		
+		vtkFloatArray * coords = vtkFloatArray::SafeDownCast(geometry->GetPoints()->GetData());
+		BOOST_ASSERT(coords != nullptr);
+		
+		// offsets of data arrays in the appended section are known in advance from their sizes
+		std::uint64_t offset = 0;
+		auto const next_offset = [&offset](std::size_t no_of_bytes) {
+			std::uint64_t const current = offset;
+			offset += sizeof(std::uint64_t) + no_of_bytes;
+			return current;
+		};
+		
+		std::ofstream out{file_path.string(), std::ios::out | std::ios::binary | std::ios::trunc};
+		throw_if_failed(out, file_path);
+		
+		out << "<?xml version=\"1.0\"?>\n"
+			<< "<VTKFile type=\"UnstructuredGrid\" version=\"1.0\" byte_order=\"" << byte_order()
+			<< "\" header_type=\"UInt64\">\n"
+			<< "  <UnstructuredGrid>\n"
+			<< "    <Piece NumberOfPoints=\"" << no_of_points << "\" NumberOfCells=\"" << no_of_cells << "\">\n"
+			<< "      <PointData>\n";
+		for(auto const& var : vars_) {
+			out << "        <DataArray type=\"Float64\" Name=\"" << var.name << "\"";
+			if (var.components.size() > 1) {
+				out << " NumberOfComponents=\"" << var.components.size() << "\"";
+			}
+			out << " format=\"appended\" offset=\""
+				<< next_offset(no_of_points * var.components.size() * sizeof(double)) << "\"/>\n";
+		}
+		out << "      </PointData>\n"
+			<< "      <CellData>\n"
+			<< "      </CellData>\n"
+			<< "      <Points>\n"
+			<< "        <DataArray type=\"Float32\" Name=\"Points\" NumberOfComponents=\"3\""
+			<< " format=\"appended\" offset=\"" << next_offset(no_of_points * 3 * sizeof(float)) << "\"/>\n"
+			<< "      </Points>\n"
+			<< "      <Cells>\n"
+			<< "        <DataArray type=\"Int64\" Name=\"connectivity\" format=\"appended\" offset=\""
+			<< next_offset(no_of_ids * sizeof(std::int64_t)) << "\"/>\n"
+			<< "        <DataArray type=\"Int64\" Name=\"offsets\" format=\"appended\" offset=\""
+			<< next_offset(no_of_cells * sizeof(std::int64_t)) << "\"/>\n"
+			<< "        <DataArray type=\"UInt8\" Name=\"types\" format=\"appended\" offset=\""
+			<< next_offset(no_of_cells * sizeof(std::uint8_t)) << "\"/>\n"
+			<< "      </Cells>\n"
+			<< "    </Piece>\n"
+			<< "  </UnstructuredGrid>\n"
+			<< "  <AppendedData encoding=\"raw\">\n"
+			<< "   _";
+		
+		// values of exported owned points are followed by those of boundary points, components are interleaved
+		boost::optional<std::vector<std::size_t>> const& point_ids = topology_.point_ids();
+		for(auto const& var : vars_) {
+			std::size_t const no_of_components = var.components.size();
+			std::size_t k = 0, c = 0;
+			write_block<double>(out, no_of_points * no_of_components, [&]() {
+				double const value = k < no_of_exported_points
+					? (*var.components[c])[point_ids ? (*point_ids)[k] : k]
+					: var.boundary_values[c][k - no_of_exported_points];
+				if (++c == no_of_components) {
+					c = 0;
+					++k;
+				}
+				return value;
+			});
+		}
+		
+		float const * coord = coords->GetPointer(0);
+		write_block<float>(out, no_of_points * 3, [&coord]() { return *coord++; });
+		
+		{
+			vtkIdType cell = 0, npts = 0, j = 0;
+			vtk_cell_points pts = nullptr;
+			write_block<std::int64_t>(out, no_of_ids, [&]() {
+				while (j == npts) {
+					geometry->GetCellPoints(cell++, npts, pts);
+					j = 0;
+				}
+				return static_cast<std::int64_t>(pts[j++]);
+			});
+		}
+		
+		{
+			vtkIdType cell = 0;
+			std::int64_t end = 0;
+			write_block<std::int64_t>(out, no_of_cells, [&]() {
+				end += geometry->GetCellSize(cell++);
+				return end;
+			});
+		}
+		
+		{
+			vtkIdType cell = 0;
+			write_block<std::uint8_t>(out, no_of_cells, [&]() {
+				return static_cast<std::uint8_t>(geometry->GetCellType(cell++));
+			});
+		}
+		
+		out << "\n"
+			<< "  </AppendedData>\n"
+			<< "</VTKFile>\n";
+		
+		out.close();
+		throw_if_failed(out, file_path);
+	}
+	
+	void
+	write_summary(fs::path const& file_path) const {
+		std::ofstream out{file_path.string(), std::ios::out | std::ios::trunc};
+		throw_if_failed(out, file_path);
+		
+		out << "<?xml version=\"1.0\"?>\n"
+			<< "<VTKFile type=\"PUnstructuredGrid\" version=\"1.0\" byte_order=\"" << byte_order()
+			<< "\" header_type=\"UInt64\">\n"
+			<< "  <PUnstructuredGrid GhostLevel=\"0\">\n"
+			<< "    <PPointData>\n";
+		for(auto const& var : vars_) {
+			out << "      <PDataArray type=\"Float64\" Name=\"" << var.name << "\"";
+			if (var.components.size() > 1) {
+				out << " NumberOfComponents=\"" << var.components.size() << "\"";
+			}
+			out << "/>\n";
+		}
+		out << "    </PPointData>\n"
+			<< "    <PCellData>\n"
+			<< "    </PCellData>\n"
+			<< "    <PPoints>\n"
+			<< "      <PDataArray type=\"Float32\" Name=\"Points\" NumberOfComponents=\"3\"/>\n"
+			<< "    </PPoints>\n";
+		for(int i = 0; i < mpi_size_; ++i) {
+			out << "    <Piece Source=\"" << piece_path(file_path, i).filename().string() << "\"/>\n";
+		}
+		out << "  </PUnstructuredGrid>\n"
+			<< "</VTKFile>\n";
+		
+		out.close();
+		throw_if_failed(out, file_path);
+	}
+	
+	vtk_domain_topology const& topology_;
+	int mpi_size_;
+	int mpi_rank_;
+	std::size_t no_of_provided_global_ids_;
+	std::vector<variable> vars_;
+};
+
+/* namespace detail */ }
+
+HBRS_THETA_UTILS_API
+void
+write_vtk_xml_streamed(vtk_domain_topology const& topology, theta_field const& field, char const * file_path) {
+	detail::vtu_stream_writer{topology, field}.write(file_path);
+}
+
+HBRS_THETA_UTILS_NAMESPACE_END
+
+#ifdef HBRS_THETA_UTILS_ENABLE_HDF5
+#include <hbrs/theta_utils/dt/exception.hpp>
+#include <hbrs/mpl/detail/mpi.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/numeric/conversion/cast.hpp>
+#include <boost/optional.hpp>
+#include <vtkPoints.h>
+#include <vtkPointData.h>
+#include <vtkIdList.h>
+#include <vtkFloatArray.h>
+#include <vtkDoubleArray.h>
+#include <vtkSOADataArrayTemplate.h>
+#include <hdf5.h>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+HBRS_THETA_UTILS_NAMESPACE_BEGIN
+namespace mpi = hbrs::mpl::detail::mpi;
+namespace detail {
+
+/* Throws a hdf5_exception if an HDF5 call failed, i.e. returned a negative value */
+template<typename T>
+static T
+h5_check(T ret, char const * what) {
+	if (ret < 0) {
+		BOOST_THROW_EXCEPTION(hdf5_exception{} << errinfo_hdf5_error{std::string{what} + " failed"});
+	}
+	return ret;
+}
+
+/* Owns an HDF5 identifier and closes it with the matching function */
+struct h5_id {
+	h5_id() : id_{-1}, close_{nullptr} {}
+	h5_id(hid_t id, herr_t (*close)(hid_t), char const * what) : id_{h5_check(id, what)}, close_{close} {}
+	h5_id(h5_id const&) = delete;
+	h5_id(h5_id && o) : id_{o.id_}, close_{o.close_} { o.id_ = -1; }
+	
+	h5_id&
+	operator=(h5_id const&) = delete;
+	h5_id&
+	operator=(h5_id && o) {
+		std::swap(id_, o.id_);
+		std::swap(close_, o.close_);
+		return *this;
+	}
+	
+	~h5_id() {
+		if (id_ >= 0) {
+			close_(id_);
+		}
+	}
+	
+	operator hid_t() const { return id_; }
+	
+private:
+	hid_t id_;
+	herr_t (*close_)(hid_t);
+};
+
+/* Offset of the part of this process and total size of the parts of all processes */
+static std::pair<hsize_t, hsize_t>
+part_offset(std::size_t size) {
+	MPI_Datatype const type = mpi::datatype(hana::type_c<std::size_t>);
+	std::size_t offset = 0, total = 0;
+	MPI_Exscan(&size, &offset, 1, type, MPI_SUM, MPI_COMM_WORLD);
+	if (mpi::comm_rank() == 0) {
+		// result of MPI_Exscan is undefined on the first process
+		offset = 0;
+	}
+	MPI_Allreduce(&size, &total, 1, type, MPI_SUM, MPI_COMM_WORLD);
+	return { offset, total };
+}
+
+/* Writes a series of grids which share points and cells, e.g. the results of make_vtk_unstructured_grid() for a
+ * single topology, to a single file in ParaView's transient VTKHDF format. Points and cells are written by the first
+ * step only, each further step appends its point data and time value. Each process writes its grid as a separate
+ * part, collectively if HDF5 has been built with MPI support.
+ * 
+ * Ref.: https://docs.vtk.org/en/latest/design_documents/VTKFileFormats.html#vtkhdf-file-format
+ */
+struct vtk_hdf_writer {
+	vtk_hdf_writer(fs::path const& path) : no_of_steps_{0}, no_of_points_{0}, point_offset_{0}, total_points_{0} {
+		h5_id fapl{H5Pcreate(H5P_FILE_ACCESS), H5Pclose, "H5Pcreate"};
+		dxpl_ = h5_id{H5Pcreate(H5P_DATASET_XFER), H5Pclose, "H5Pcreate"};
+#ifdef H5_HAVE_PARALLEL
+		h5_check(H5Pset_fapl_mpio(fapl, MPI_COMM_WORLD, MPI_INFO_NULL), "H5Pset_fapl_mpio");
+		h5_check(H5Pset_dxpl_mpio(dxpl_, H5FD_MPIO_COLLECTIVE), "H5Pset_dxpl_mpio");
+#else
+		if (mpi::comm_size() > 1) {
+			// without MPI support every process would have to write to its own file
+			BOOST_THROW_EXCEPTION(unsupported_format_exception{} << errinfo_vtk_file_format{vtk_file_format::hdf});
+		}
+#endif
+		file_ = h5_id{H5Fcreate(path.string().c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl), H5Fclose, "H5Fcreate"};
+		root_ = h5_id{H5Gcreate2(file_, "VTKHDF", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT), H5Gclose, "H5Gcreate2"};
+		
+		int const version[2] = { 2, 0 };
+		write_attribute(root_, "Version", H5T_NATIVE_INT, 2, version, true);
+		
+		char const type[] = "UnstructuredGrid";
+		h5_id str{H5Tcopy(H5T_C_S1), H5Tclose, "H5Tcopy"};
+		h5_check(H5Tset_size(str, std::strlen(type)), "H5Tset_size");
+		h5_check(H5Tset_strpad(str, H5T_STR_NULLPAD), "H5Tset_strpad");
+		write_attribute(root_, "Type", str, 0, type, true);
+	}
+	
+	vtk_hdf_writer(vtk_hdf_writer const&) = delete;
+	vtk_hdf_writer&
+	operator=(vtk_hdf_writer const&) = delete;
+	
+	void
+	write(vtkUnstructuredGrid * grid, double time) {
+		if (no_of_steps_ == 0) {
+			write_geometry(grid);
+		}
+		
+		if (boost::numeric_cast<hsize_t>(grid->GetNumberOfPoints()) != no_of_points_) {
+			BOOST_THROW_EXCEPTION(std::runtime_error{"points of grid do not match points of first step"});
+		}
+		
+		hsize_t const step = no_of_steps_;
+		std::int64_t const zero = 0;
+		std::int64_t const no_of_parts = mpi::comm_size();
+		
+		append_step_value("Steps/Values", H5T_NATIVE_DOUBLE, &time);
+		append_step_value("Steps/PartOffsets", H5T_NATIVE_INT64, &zero);
+		append_step_value("Steps/NumberOfParts", H5T_NATIVE_INT64, &no_of_parts);
+		// geometry of the first step is reused by all steps
+		append_step_value("Steps/PointOffsets", H5T_NATIVE_INT64, &zero);
+		append_step_value("Steps/CellOffsets", H5T_NATIVE_INT64, &zero);
+		append_step_value("Steps/ConnectivityIdOffsets", H5T_NATIVE_INT64, &zero);
+		
+		for(auto const& name : point_data_) {
+			vtkDataArray * array = grid->GetPointData()->GetArray(name.c_str());
+			if (array == nullptr || boost::numeric_cast<hsize_t>(array->GetNumberOfTuples()) != no_of_points_) {
+				BOOST_THROW_EXCEPTION(std::runtime_error{"point data " + name + " does not match first step"});
+			}
+			
+			std::string const dataset = "PointData/" + name;
+			hsize_t const first = step * total_points_ + point_offset_;
+			extend(dataset.c_str(), (step+1) * total_points_);
+			
+			// components of vectors are kept in separate arrays, so each one is written into a column of its own
+			if (auto soa = vtkSOADataArrayTemplate<double>::SafeDownCast(array)) {
+				int const no_of_components = soa->GetNumberOfComponents();
+				for(int c = 0; c < no_of_components; ++c) {
+					write_rows(
+						dataset.c_str(), H5T_NATIVE_DOUBLE, first, no_of_points_, soa->GetComponentArrayPointer(c),
+						no_of_components > 1 ? boost::optional<hsize_t>{c} : boost::none
+					);
+				}
+			} else if (auto aos = vtkDoubleArray::SafeDownCast(array)) {
+				write_rows(dataset.c_str(), H5T_NATIVE_DOUBLE, first, no_of_points_, aos->GetPointer(0));
+			} else {
+				BOOST_THROW_EXCEPTION(std::runtime_error{"point data " + name + " is not an array of doubles"});
+			}
+			
+			std::int64_t const offset = boost::numeric_cast<std::int64_t>(step * total_points_);
+			append_step_value(("Steps/PointDataOffsets/" + name).c_str(), H5T_NATIVE_INT64, &offset);
+		}
+		
+		++no_of_steps_;
+		int const no_of_steps = boost::numeric_cast<int>(no_of_steps_);
+		h5_id steps{H5Gopen2(root_, "Steps", H5P_DEFAULT), H5Gclose, "H5Gopen2"};
+		write_attribute(steps, "NSteps", H5T_NATIVE_INT, 0, &no_of_steps, false);
+		
+		h5_check(H5Fflush(file_, H5F_SCOPE_GLOBAL), "H5Fflush");
+	}
+	
+private:
+	void
+	write_geometry(vtkUnstructuredGrid * grid) {
+		hsize_t const part = boost::numeric_cast<hsize_t>(mpi::comm_rank());
+		hsize_t const no_of_parts = boost::numeric_cast<hsize_t>(mpi::comm_size());
+		
+		// cells are written with point ids local to the part, i.e. the process
+		vtkIdType const no_of_cells = grid->GetNumberOfCells();
+		std::vector<unsigned char> types(no_of_cells);
+		std::vector<std::int64_t> offsets{0};
+		std::vector<std::int64_t> connectivity;
+		offsets.reserve(no_of_cells+1);
+		vtkSmartPointer<vtkIdList> ids = vtkSmartPointer<vtkIdList>::New();
+		for(vtkIdType i = 0; i < no_of_cells; ++i) {
+			types[i] = boost::numeric_cast<unsigned char>(grid->GetCellType(i));
+			grid->GetCellPoints(i, ids);
+			for(vtkIdType j = 0; j < ids->GetNumberOfIds(); ++j) {
+				connectivity.push_back(ids->GetId(j));
+			}
+			offsets.push_back(boost::numeric_cast<std::int64_t>(connectivity.size()));
+		}
+		
+		no_of_points_ = boost::numeric_cast<hsize_t>(grid->GetNumberOfPoints());
+		auto const points = part_offset(no_of_points_);
+		auto const cells = part_offset(types.size());
+		auto const conn_ids = part_offset(connectivity.size());
+		point_offset_ = points.first;
+		total_points_ = points.second;
+		
+		std::int64_t const sizes[3] = {
+			boost::numeric_cast<std::int64_t>(no_of_points_),
+			boost::numeric_cast<std::int64_t>(types.size()),
+			boost::numeric_cast<std::int64_t>(connectivity.size())
+		};
+		create_dataset(root_, "NumberOfPoints", H5T_STD_I64LE, { no_of_parts });
+		create_dataset(root_, "NumberOfCells", H5T_STD_I64LE, { no_of_parts });
+		create_dataset(root_, "NumberOfConnectivityIds", H5T_STD_I64LE, { no_of_parts });
+		write_rows("NumberOfPoints", H5T_NATIVE_INT64, part, 1, &sizes[0]);
+		write_rows("NumberOfCells", H5T_NATIVE_INT64, part, 1, &sizes[1]);
+		write_rows("NumberOfConnectivityIds", H5T_NATIVE_INT64, part, 1, &sizes[2]);
+		
+		vtkDataArray * coords = grid->GetPoints() ? grid->GetPoints()->GetData() : nullptr;
+		if (auto flt = vtkFloatArray::SafeDownCast(coords)) {
+			create_dataset(root_, "Points", H5T_IEEE_F32LE, { total_points_, 3 });
+			write_rows("Points", H5T_NATIVE_FLOAT, point_offset_, no_of_points_, flt->GetPointer(0));
+		} else if (auto dbl = vtkDoubleArray::SafeDownCast(coords)) {
+			create_dataset(root_, "Points", H5T_IEEE_F64LE, { total_points_, 3 });
+			write_rows("Points", H5T_NATIVE_DOUBLE, point_offset_, no_of_points_, dbl->GetPointer(0));
+		} else {
+			BOOST_THROW_EXCEPTION(std::runtime_error{"points of grid are neither floats nor doubles"});
+		}
+		
+		create_dataset(root_, "Types", H5T_STD_U8LE, { cells.second });
+		write_rows("Types", H5T_NATIVE_UCHAR, cells.first, types.size(), types.data());
+		
+		// each part has one offset more than cells
+		create_dataset(root_, "Offsets", H5T_STD_I64LE, { cells.second + no_of_parts });
+		write_rows("Offsets", H5T_NATIVE_INT64, cells.first + part, offsets.size(), offsets.data());
+		
+		create_dataset(root_, "Connectivity", H5T_STD_I64LE, { conn_ids.second });
+		write_rows("Connectivity", H5T_NATIVE_INT64, conn_ids.first, connectivity.size(), connectivity.data());
+		
+		// point data and values of steps are appended by each step
+		static constexpr hsize_t step_chunk = 64;
+		hsize_t const point_chunk = std::max<hsize_t>(std::min<hsize_t>(total_points_, 1<<16), 1);
+		
+		h5_id point_data{H5Gcreate2(root_, "PointData", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT), H5Gclose, "H5Gcreate2"};
+		h5_id steps{H5Gcreate2(root_, "Steps", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT), H5Gclose, "H5Gcreate2"};
+		h5_id point_data_offsets{
+			H5Gcreate2(steps, "PointDataOffsets", H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT), H5Gclose, "H5Gcreate2"
+		};
+		
+		int const no_of_steps = 0;
+		write_attribute(steps, "NSteps", H5T_NATIVE_INT, 0, &no_of_steps, true);
+		create_dataset(steps, "Values", H5T_IEEE_F64LE, { 0 }, step_chunk);
+		for(auto name : { "PartOffsets", "NumberOfParts", "PointOffsets", "CellOffsets", "ConnectivityIdOffsets" }) {
+			create_dataset(steps, name, H5T_STD_I64LE, { 0 }, step_chunk);
+		}
+		
+		vtkPointData * pd = grid->GetPointData();
+		std::vector<hsize_t> no_of_components;
+		for(int i = 0; i < pd->GetNumberOfArrays(); ++i) {
+			vtkDataArray * array = pd->GetArray(i);
+			if (array == nullptr || array->GetName() == nullptr) {
+				continue;
+			}
+			point_data_.push_back(array->GetName());
+			no_of_components.push_back(boost::numeric_cast<hsize_t>(array->GetNumberOfComponents()));
+		}
+		
+		// Datasets are created and written collectively by name, so all processes must have the same point data,
+		// else they would wait for each other forever. Names are compared by their size and hash on all processes.
+		std::string signature;
+		for(std::size_t i = 0; i < point_data_.size(); ++i) {
+			signature += point_data_[i] + ':' + std::to_string(no_of_components[i]) + '\n';
+		}
+		std::size_t const digest[2] = { signature.size(), std::hash<std::string>{}(signature) };
+		std::size_t min_digest[2], max_digest[2];
+		MPI_Datatype const type = mpi::datatype(hana::type_c<std::size_t>);
+		MPI_Allreduce(digest, min_digest, 2, type, MPI_MIN, MPI_COMM_WORLD);
+		MPI_Allreduce(digest, max_digest, 2, type, MPI_MAX, MPI_COMM_WORLD);
+		if (min_digest[0] != max_digest[0] || min_digest[1] != max_digest[1]) {
+			BOOST_THROW_EXCEPTION(std::runtime_error{"point data of grids differs between processes"});
+		}
+		
+		for(std::size_t i = 0; i < point_data_.size(); ++i) {
+			char const * name = point_data_[i].c_str();
+			if (no_of_components[i] > 1) {
+				create_dataset(point_data, name, H5T_IEEE_F64LE, { 0, no_of_components[i] }, point_chunk);
+			} else {
+				create_dataset(point_data, name, H5T_IEEE_F64LE, { 0 }, point_chunk);
+			}
+			create_dataset(point_data_offsets, name, H5T_STD_I64LE, { 0 }, step_chunk);
+		}
+	}
+	
+	/* Writes an attribute which is a scalar if size is zero and an array of size elements else */
+	void
+	write_attribute(hid_t loc, char const * name, hid_t type, hsize_t size, void const * buf, bool create) {
+		h5_id attr;
+		if (create) {
+			h5_id space = size == 0
+				? h5_id{H5Screate(H5S_SCALAR), H5Sclose, "H5Screate"}
+				: h5_id{H5Screate_simple(1, &size, nullptr), H5Sclose, "H5Screate_simple"};
+			attr = h5_id{H5Acreate2(loc, name, type, space, H5P_DEFAULT, H5P_DEFAULT), H5Aclose, "H5Acreate2"};
+		} else {
+			attr = h5_id{H5Aopen(loc, name, H5P_DEFAULT), H5Aclose, "H5Aopen"};
+		}
+		h5_check(H5Awrite(attr, type, buf), "H5Awrite");
+	}
+	
+	/* Creates a dataset with the given dimensions which can be extended along its first dimension if chunk is not zero,
+	 * chunk is the number of rows of a chunk then */
+	void
+	create_dataset(hid_t loc, char const * name, hid_t type, std::vector<hsize_t> dims, hsize_t chunk = 0) {
+		int const rank = boost::numeric_cast<int>(dims.size());
+		std::vector<hsize_t> max_dims = dims;
+		h5_id dcpl{H5Pcreate(H5P_DATASET_CREATE), H5Pclose, "H5Pcreate"};
+		if (chunk > 0) {
+			max_dims[0] = H5S_UNLIMITED;
+			std::vector<hsize_t> chunk_dims = dims;
+			chunk_dims[0] = chunk;
+			h5_check(H5Pset_chunk(dcpl, rank, chunk_dims.data()), "H5Pset_chunk");
+		}
+		
+		h5_id space{H5Screate_simple(rank, dims.data(), max_dims.data()), H5Sclose, "H5Screate_simple"};
+		h5_id dset{H5Dcreate2(loc, name, type, space, H5P_DEFAULT, dcpl, H5P_DEFAULT), H5Dclose, "H5Dcreate2"};
+	}
+	
+	/* Sets the first dimension of an extendible dataset to rows, this is a collective operation */
+	void
+	extend(char const * name, hsize_t rows) {
+		h5_id dset{H5Dopen2(root_, name, H5P_DEFAULT), H5Dclose, "H5Dopen2"};
+		h5_id space{H5Dget_space(dset), H5Sclose, "H5Dget_space"};
+		std::array<hsize_t, 2> dims{ 0, 0 };
+		h5_check(H5Sget_simple_extent_dims(space, dims.data(), nullptr), "H5Sget_simple_extent_dims");
+		dims[0] = rows;
+		h5_check(H5Dset_extent(dset, dims.data()), "H5Dset_extent");
+	}
+	
+	/* Writes rows [first, first+no_of_rows) of a dataset, i.e. all of their columns or only column col if given */
+	void
+	write_rows(
+		char const * name,
+		hid_t mem_type,
+		hsize_t first,
+		hsize_t no_of_rows,
+		void const * buf,
+		boost::optional<hsize_t> col = boost::none
+	) {
+		h5_id dset{H5Dopen2(root_, name, H5P_DEFAULT), H5Dclose, "H5Dopen2"};
+		h5_id file_space{H5Dget_space(dset), H5Sclose, "H5Dget_space"};
+		int const rank = h5_check(H5Sget_simple_extent_ndims(file_space), "H5Sget_simple_extent_ndims");
+		BOOST_ASSERT(rank == 1 || rank == 2);
+		std::array<hsize_t, 2> dims{ 0, 1 };
+		h5_check(H5Sget_simple_extent_dims(file_space, dims.data(), nullptr), "H5Sget_simple_extent_dims");
+		
+		std::array<hsize_t, 2> const start{ first, col ? *col : 0 };
+		std::array<hsize_t, 2> const count{ no_of_rows, col ? 1 : dims[1] };
+		int const mem_rank = (rank == 1 || col) ? 1 : 2;
+		h5_id mem_space{H5Screate_simple(mem_rank, count.data(), nullptr), H5Sclose, "H5Screate_simple"};
+		
+		// processes without rows have to take part in collective writes, too
+		if (no_of_rows == 0) {
+			h5_check(H5Sselect_none(file_space), "H5Sselect_none");
+			h5_check(H5Sselect_none(mem_space), "H5Sselect_none");
+		} else {
+			h5_check(
+				H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start.data(), nullptr, count.data(), nullptr),
+				"H5Sselect_hyperslab"
+			);
+		}
+		
+		h5_check(H5Dwrite(dset, mem_type, mem_space, file_space, dxpl_, buf), "H5Dwrite");
+	}
+	
+	/* Appends the value of the current step to a dataset in group Steps, which is written by the first process only */
+	void
+	append_step_value(char const * name, hid_t mem_type, void const * value) {
+		extend(name, no_of_steps_+1);
+		write_rows(name, mem_type, no_of_steps_, mpi::comm_rank() == 0 ? 1 : 0, value);
+	}
+	
+	h5_id file_;
+	h5_id dxpl_;
+	h5_id root_;
+	hsize_t no_of_steps_;
+	/* number of points of this part, its offset and number of points of all parts */
+	hsize_t no_of_points_;
+	hsize_t point_offset_;
+	hsize_t total_points_;
+	/* names of point data written by each step */
+	std::vector<std::string> point_data_;
+};
+
+/* namespace detail */ }
+HBRS_THETA_UTILS_NAMESPACE_END
+#endif // !HBRS_THETA_UTILS_ENABLE_HDF5
+
 #include <hbrs/theta_utils/dt/exception.hpp>
 #include <boost/throw_exception.hpp>
 #include <boost/algorithm/string/replace.hpp>
@@ -953,12 +2037,14 @@ std::string
 vtk_path::file_extension() const {
 	if (format_ == vtk_file_format::legacy_ascii && !distributed_) {
 		return "vtk";
-	} else if (format_ == vtk_file_format::xml_binary) {
+	} else if (format_ == vtk_file_format::xml_binary || format_ == vtk_file_format::xml_streamed) {
 		if (distributed_) {
 			return "pvtu";
 		} else {
 			return "vtu";
 		}
+	} else if (format_ == vtk_file_format::hdf) {
+		return "vtkhdf";
 	} else {
 		BOOST_THROW_EXCEPTION(unsupported_format_exception{} << errinfo_vtk_file_format{format_});
 	}
@@ -991,11 +2077,94 @@ HBRS_THETA_UTILS_NAMESPACE_END
 #include <hbrs/mpl/detail/log.hpp>
 #include <hbrs/mpl/fn/transform.hpp>
 #include <boost/lexical_cast.hpp>
+#include <boost/optional.hpp>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
 
 HBRS_THETA_UTILS_NAMESPACE_BEGIN
 namespace mpi = hbrs::mpl::detail::mpi;
 
+namespace detail {
+
+/* Runs jobs one after another in order of submission on a thread of its own, or immediately on the calling thread if
+ * asynchronous is false. Jobs which have been submitted already are finished before the executor is destroyed. */
+struct serial_executor {
+	serial_executor(bool asynchronous) : done_{false} {
+		if (asynchronous) {
+			thread_ = std::thread{[this]() { run(); }};
+		}
+	}
+	
+	serial_executor(serial_executor const&) = delete;
+	serial_executor&
+	operator=(serial_executor const&) = delete;
+	
+	~serial_executor() {
+		if (thread_.joinable()) {
+			{
+				std::lock_guard<std::mutex> lock{mutex_};
+				done_ = true;
+			}
+			cv_.notify_one();
+			thread_.join();
+		}
+	}
+	
+	/* Returns a future which holds the result of f or the exception thrown by f */
+	template<typename F>
+	std::future<decltype(std::declval<F&>()())>
+	submit(F f) {
+		typedef decltype(std::declval<F&>()()) R;
+		auto task = std::make_shared<std::packaged_task<R()>>(std::move(f));
+		std::future<R> result = task->get_future();
+		
+		if (!thread_.joinable()) {
+			(*task)();
+			return result;
+		}
+		
+		{
+			std::lock_guard<std::mutex> lock{mutex_};
+			jobs_.emplace_back([task]() { (*task)(); });
+		}
+		cv_.notify_one();
+		return result;
+	}
+	
+private:
+	void
+	run() {
+		for(;;) {
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock{mutex_};
+				cv_.wait(lock, [this]() { return done_ || !jobs_.empty(); });
+				if (jobs_.empty()) {
+					return;
+				}
+				job = std::move(jobs_.front());
+				jobs_.pop_front();
+			}
+			job();
+		}
+	}
+	
+	std::mutex mutex_;
+	std::condition_variable cv_;
+	std::deque<std::function<void()>> jobs_;
+	bool done_;
+	std::thread thread_;
+};
+
+/* namespace detail */ }
+
 static
 void
 safe_write(fs::path path, bool overwrite) {
@@ -1020,18 +2189,19 @@ convert_to_vtk(
 	std::vector<std::string> const& excludes,
 	bool simple_numbering,
 	vtk_file_format format,
-	bool overwrite
+	bool overwrite,
+	std::size_t pipeline_depth,
+	vtk_xml_encoding const& encoding,
+	vtk_cell_selection const& selection
 ) {
 	HBRS_MPL_LOG_TRIVIAL(debug) << "convert_to_vtk:begin";
 	bool distributed = mpi::comm_size() > 1;
-	HBRS_MPL_LOG_TRIVIAL(debug) << "convert_to_vtk:read_theta_grid";
-	theta_grid const grid = read_theta_grid(grid_path);
 	
 	HBRS_MPL_LOG_TRIVIAL(debug) << "convert_to_vtk:vtk_paths";
 	// create vtk filenames
 	std::vector<vtk_path> vtk_paths;
 	vtk_paths.reserve(field_paths.size());
-	for(std::size_t i = 0; i < field_paths.size(); ++i) {
+	for(std::size_t i = 0; i < field_paths.size() && format != vtk_file_format::hdf; ++i) {
 		theta_field_path field_path = field_paths[i];
 		std::string basename;
 		if (simple_numbering) {
@@ -1046,6 +2216,11 @@ convert_to_vtk(
 		vtk_paths.emplace_back(folder, basename, distributed, format);
 	};
 	
+	// all time steps are written to a single file
+	if (format == vtk_file_format::hdf) {
+		vtk_paths.emplace_back(folder, prefix, distributed, format);
+	}
+	
 	HBRS_MPL_LOG_TRIVIAL(debug) << "convert_to_vtk:vtk_paths:safe_write";
 	for(auto vtk_path : vtk_paths) {
 		safe_write(vtk_path.full_path(), overwrite);
@@ -1057,39 +2232,131 @@ convert_to_vtk(
 	safe_write(pvd_path_, overwrite);
 	
 	// write vtk files
-	for(std::size_t i = 0; i < field_paths.size(); ++i) {
-		theta_field_path field_path = field_paths[i];
-		
-		HBRS_MPL_LOG_TRIVIAL(debug) << "convert_to_vtk:read_theta_field:i=" << i;
-		theta_field field = read_theta_field(
-			field_path.full_path().string(),
-			includes /* TODO: Or hardcode includes? {".*_velocity", "global_id"} */,
-			excludes
-		);
-		
-		BOOST_ASSERT(*field.ndomains() == mpi::comm_size());
-		
-		HBRS_MPL_LOG_TRIVIAL(debug) << "convert_to_vtk:make_vtk_unstructured_grid:i=" << i;
-		vtk_path vtk_path = vtk_paths[i];
-		auto vtk_grid = make_vtk_unstructured_grid(grid, field);
-		
+	boost::optional<vtk_domain_topology> topology;
+#ifdef HBRS_THETA_UTILS_ENABLE_HDF5
+	boost::optional<detail::vtk_hdf_writer> hdf_writer;
+#endif
+	auto const write_vtk_grid = [&](std::size_t i, vtkSmartPointer<vtkUnstructuredGrid> vtk_grid) {
 		HBRS_MPL_LOG_TRIVIAL(debug) << "convert_to_vtk:write_vtk_*:i=" << i;
-		if (format == vtk_file_format::legacy_ascii && !distributed) {
+		vtk_path const& vtk_path = vtk_paths[format == vtk_file_format::hdf ? 0 : i];
+		if (format == vtk_file_format::hdf) {
+#ifdef HBRS_THETA_UTILS_ENABLE_HDF5
+			if (!hdf_writer) {
+				hdf_writer.emplace(vtk_path.full_path());
+			}
+			hdf_writer->write(vtk_grid, boost::lexical_cast<double>(field_paths[i].timestamp().string()));
+#else
+			BOOST_THROW_EXCEPTION(unsupported_format_exception{} << errinfo_vtk_file_format{format});
+#endif
+		} else if (format == vtk_file_format::legacy_ascii && !distributed) {
 			write_vtk_legacy_ascii(vtk_grid, vtk_path.full_path().string().data());
 		} else if (format == vtk_file_format::xml_binary) {
 			if (distributed) {
-				write_vtk_xml_binary_parallel(vtk_grid, vtk_path.full_path().string().data());
+				write_vtk_xml_binary_parallel(vtk_grid, vtk_path.full_path().string().data(), encoding);
 			} else {
-				write_vtk_xml_binary(vtk_grid, vtk_path.full_path().string().data());
+				write_vtk_xml_binary(vtk_grid, vtk_path.full_path().string().data(), encoding);
 			}
 		} else {
 			BOOST_THROW_EXCEPTION(unsupported_format_exception{} << errinfo_vtk_file_format{format});
 		}
+	};
+	
+	// Time steps are processed in a pipeline: While a step is built on this thread, up to pipeline_depth following
+	// steps are read ahead and up to pipeline_depth previous steps are compressed and written in the background. MPI
+	// is used on this thread only, so the halo exchange stays here and writers which communicate, i.e. those of
+	// distributed and VTKHDF files, are run here, too. netCDF is not thread-safe, hence the reader reads the grid, too.
+	// Streamed VTU files are written without communication, so these are written in the background in any case.
+	std::size_t const max_pending_writes = std::max<std::size_t>(pipeline_depth, 1);
+	detail::serial_executor reader{pipeline_depth > 0};
+	detail::serial_executor writer{
+		pipeline_depth > 0 &&
+		(format == vtk_file_format::xml_streamed || (!distributed && format != vtk_file_format::hdf))
+	};
+	// Futures are declared after the executors: If an error is rethrown, e.g. by a read ahead, then pending futures
+	// are dropped first and the executors finish all jobs queued so far before references of these jobs go away.
+	std::deque<std::future<theta_field>> fields;
+	std::deque<std::future<void>> writes;
+	
+	// Grid and global ids do not change across a series, so cells and halo-exchange plan are computed just once from
+	// the global ids of the first step. Point data is read afterwards, with room for the values of boundary points
+	// which are appended by make_vtk_unstructured_grid(). Streamed VTU files keep boundary values apart instead.
+	std::size_t capacity = 0;
+	if (!field_paths.empty()) {
+		// each process reads only the cells touching its own points and the points of these cells
+		auto [global_id, grid] = reader.submit([&field_paths, &grid_path, distributed]() {
+			HBRS_MPL_LOG_TRIVIAL(debug) << "convert_to_vtk:read_theta_grid";
+			shared_global_id global_id =
+				read_theta_field(field_paths[0].full_path().string(), {"global_id"}).global_id();
+			theta_grid grid = (distributed && global_id)
+				? read_theta_grid(grid_path, *global_id)
+				: read_theta_grid(grid_path);
+			return std::make_pair(global_id, std::move(grid));
+		}).get();
+		
+		HBRS_MPL_LOG_TRIVIAL(debug) << "convert_to_vtk:make_vtk_domain_topology";
+		topology = make_vtk_domain_topology(grid, global_id, selection);
+		if (format != vtk_file_format::xml_streamed) {
+			capacity = detail::point_data_capacity(*topology);
+		}
+	}
+	
+	std::size_t no_of_reads = 0;
+	auto const read_ahead = [&]() {
+		while (no_of_reads < field_paths.size() && fields.size() <= pipeline_depth) {
+			std::size_t const i = no_of_reads++;
+			fields.push_back(reader.submit([&field_paths, &includes, &excludes, i, capacity]() {
+				HBRS_MPL_LOG_TRIVIAL(debug) << "convert_to_vtk:read_theta_field:i=" << i;
+				return read_theta_field(
+					field_paths[i].full_path().string(),
+					includes /* TODO: Or hardcode includes? {".*_velocity", "global_id"} */,
+					excludes,
+					capacity
+				);
+			}));
+		}
+	};
+	
+	read_ahead();
+	for(std::size_t i = 0; i < field_paths.size(); ++i) {
+		// field must outlive vtk_grid which references its buffers, so it is owned by the write job
+		std::shared_ptr<theta_field> field = std::make_shared<theta_field>(fields.front().get());
+		fields.pop_front();
+		read_ahead();
+		
+		BOOST_ASSERT(*field->ndomains() == mpi::comm_size());
+		BOOST_ASSERT(field->global_id() ? field->global_id()->size() == topology->no_of_points() : true);
+		
+		// rethrows errors of previous writes
+		while (writes.size() >= max_pending_writes) {
+			writes.front().get();
+			writes.pop_front();
+		}
+		
+		if (format == vtk_file_format::xml_streamed) {
+			// only boundary values are exchanged and buffered, all other data is streamed from topology and field
+			HBRS_MPL_LOG_TRIVIAL(debug) << "convert_to_vtk:vtu_stream_writer:i=" << i;
+			auto stream = std::make_shared<detail::vtu_stream_writer const>(*topology, *field);
+			writes.push_back(writer.submit([&vtk_paths, i, stream, field]() {
+				HBRS_MPL_LOG_TRIVIAL(debug) << "convert_to_vtk:write_vtk_xml_streamed:i=" << i;
+				stream->write(vtk_paths[i].full_path());
+			}));
+		} else {
+			HBRS_MPL_LOG_TRIVIAL(debug) << "convert_to_vtk:make_vtk_unstructured_grid:i=" << i;
+			auto vtk_grid = make_vtk_unstructured_grid(*topology, *field);
+			writes.push_back(writer.submit([&write_vtk_grid, i, vtk_grid, field]() { write_vtk_grid(i, vtk_grid); }));
+		}
+	}
+	
+	while (!writes.empty()) {
+		writes.front().get();
+		writes.pop_front();
 	}
 	
 	// let one process write a pvd file for easier ParaView usage
 	// NOTE: A pvd file only works for xml output files
-	if (format == vtk_file_format::xml_binary && (mpi::comm_rank() == 0)) {
+	if ((format == vtk_file_format::xml_binary || format == vtk_file_format::xml_streamed) &&
+		(mpi::comm_rank() == 0))
+	{
 		HBRS_MPL_LOG_TRIVIAL(debug) << "convert_to_vtk:write_pvd";
 		std::vector<fs::path> vtk_plain_paths = (*mpl::transform)(
 			vtk_paths,
@@ -1100,4 +2367,132 @@ convert_to_vtk(
 	
 	HBRS_MPL_LOG_TRIVIAL(debug) << "convert_to_vtk:end";
 }
+
+static char const *
+name_of(vtk_compressor compressor) {
+	switch (compressor) {
+		case vtk_compressor::none:
+			return "none";
+		case vtk_compressor::zlib:
+			return "zlib";
+		case vtk_compressor::lz4:
+			return "lz4";
+		case vtk_compressor::lzma:
+			return "lzma";
+		default:
+			BOOST_ASSERT_MSG(false, "unknown compressor");
+			return "unknown";
+	}
+}
+
+HBRS_THETA_UTILS_API
+void
+benchmark_vtk_xml_encodings(
+	theta_grid_path const& grid_path,
+	theta_field_path const& field_path,
+	fs::path const& folder,
+	std::vector<std::string> const& includes,
+	std::vector<std::string> const& excludes,
+	vtk_cell_selection const& selection,
+	std::ostream & out
+) {
+	HBRS_MPL_LOG_TRIVIAL(debug) << "benchmark_vtk_xml_encodings:begin";
+	bool const distributed = mpi::comm_size() > 1;
+	bool const root = mpi::comm_rank() == 0;
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "benchmark_vtk_xml_encodings:make_vtk_domain_topology";
+	boost::optional<vtk_domain_topology> topology;
+	{
+		shared_global_id const global_id =
+			read_theta_field(field_path.full_path().string(), {"global_id"}).global_id();
+		theta_grid const grid = (distributed && global_id)
+			? read_theta_grid(grid_path, *global_id)
+			: read_theta_grid(grid_path);
+		topology = make_vtk_domain_topology(grid, global_id, selection);
+	}
+	
+	// point data is read with room for values of boundary points, see make_vtk_unstructured_grid()
+	HBRS_MPL_LOG_TRIVIAL(debug) << "benchmark_vtk_xml_encodings:read_theta_field";
+	theta_field field = read_theta_field(
+		field_path.full_path().string(), includes, excludes, detail::point_data_capacity(*topology));
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "benchmark_vtk_xml_encodings:make_vtk_unstructured_grid";
+	auto vtk_grid = make_vtk_unstructured_grid(*topology, field);
+	
+	std::vector<vtk_xml_encoding> encodings;
+	for(bool raw_appended : { false, true }) {
+		encodings.push_back({ vtk_compressor::none, 0, raw_appended });
+#if VTK_MAJOR_VERSION > 8 || (VTK_MAJOR_VERSION == 8 && VTK_MINOR_VERSION >= 2)
+		for(auto compressor : { vtk_compressor::zlib, vtk_compressor::lz4, vtk_compressor::lzma }) {
+			for(int level : { 1, 0, 9 }) {
+				encodings.push_back({ compressor, level, raw_appended });
+			}
+		}
+#else
+		encodings.push_back({ vtk_compressor::zlib, 0, raw_appended });
+#endif
+	}
+	
+	if (root) {
+		out << boost::format("%-10s %-7s %-12s %15s %10s") % "compressor" % "level" % "encoding" % "bytes" % "seconds"
+			<< std::endl;
+	}
+	
+	for(std::size_t i = 0; i < encodings.size(); ++i) {
+		vtk_xml_encoding const& encoding = encodings[i];
+		
+		// each setting is written to a folder of its own, so sizes of all pieces are summed up easily
+		fs::path const dir = folder / ("vtk_benchmark_" + boost::lexical_cast<std::string>(i));
+		int exists = 0;
+		if (root) {
+			exists = fs::exists(dir) ? 1 : 0;
+			if (!exists) {
+				fs::create_directories(dir);
+			}
+		}
+		MPI_Bcast(&exists, 1, MPI_INT, 0, MPI_COMM_WORLD);
+		if (exists) {
+			BOOST_THROW_EXCEPTION((
+				fs::filesystem_error{
+					(boost::format("benchmark folder %s already exists") % dir.string()).str(),
+					make_error_code(boost::system::errc::file_exists)
+				}
+			));
+		}
+		
+		HBRS_MPL_LOG_TRIVIAL(debug) << "benchmark_vtk_xml_encodings:write_vtk_xml_binary:i=" << i;
+		vtk_path const path{dir, "step", distributed, vtk_file_format::xml_binary};
+		auto const start = std::chrono::steady_clock::now();
+		if (distributed) {
+			write_vtk_xml_binary_parallel(vtk_grid, path.full_path().string().data(), encoding);
+		} else {
+			write_vtk_xml_binary(vtk_grid, path.full_path().string().data(), encoding);
+		}
+		std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+		
+		// a step is written when its slowest piece is written
+		double seconds = elapsed.count();
+		MPI_Allreduce(MPI_IN_PLACE, &seconds, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+		
+		if (root) {
+			std::uintmax_t bytes = 0;
+			for(auto && entry : fs::recursive_directory_iterator{dir}) {
+				if (fs::is_regular_file(entry.status())) {
+					bytes += fs::file_size(entry.path());
+				}
+			}
+			fs::remove_all(dir);
+			
+			out << boost::format("%-10s %-7s %-12s %15d %10.3f")
+					% name_of(encoding.compressor)
+					% (encoding.level > 0 ? boost::lexical_cast<std::string>(encoding.level) : std::string{"default"})
+					% (encoding.raw_appended ? "raw-appended" : "base64")
+					% bytes
+					% seconds
+				<< std::endl;
+		}
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "benchmark_vtk_xml_encodings:end";
+}
 HBRS_THETA_UTILS_NAMESPACE_END
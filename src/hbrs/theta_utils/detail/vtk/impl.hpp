@@ -20,6 +20,7 @@
 #include "fwd.hpp"
 
 #include <hbrs/theta_utils/core/preprocessor.hpp>
+#include <boost/optional.hpp>
 
 HBRS_THETA_UTILS_NAMESPACE_BEGIN
 namespace hana = boost::hana;
@@ -53,6 +54,53 @@ struct HBRS_THETA_UTILS_API vtk_path {
 	HBRS_THETA_UTILS_DECLARE_ATTR(format, vtk_file_format)
 };
 
+/* Encoding of data arrays written by the VTK XML writers */
+struct HBRS_THETA_UTILS_API vtk_xml_encoding {
+	vtk_compressor compressor = vtk_compressor::zlib;
+	/* compression level from 1 (fastest) to 9 (smallest), zero keeps the default level of the compressor */
+	int level = 0;
+	/* write raw data arrays to an appended section instead of base64-encoding them inline */
+	bool raw_appended = false;
+};
+
+/* Cells which are exported to VTK, points which are not referenced by any selected cell are dropped */
+struct HBRS_THETA_UTILS_API vtk_cell_selection {
+	vtk_cell_kind kind = vtk_cell_kind::all;
+	/* boundary markers of selected surface cells, all surface cells are selected if empty */
+	std::vector<int> boundary_markers;
+};
+
+/* Points and cells of the local part of a (distributed) theta_grid plus the plan for exchanging point data of boundary
+ * points with other processes. Neither depends on values of point data, so it is reused for all fields of a series.
+ */
+struct HBRS_THETA_UTILS_API vtk_domain_topology {
+	vtk_domain_topology(
+		std::size_t no_of_points,
+		boost::optional<std::vector<std::size_t>> point_ids,
+		std::vector<std::vector<std::size_t>> send_ids,
+		std::vector<std::size_t> recv_counts,
+		vtkSmartPointer<vtkUnstructuredGrid> geometry
+	);
+	vtk_domain_topology(vtk_domain_topology const&) = default;
+	vtk_domain_topology(vtk_domain_topology &&) = default;
+	
+	vtk_domain_topology&
+	operator=(vtk_domain_topology const&) = default;
+	vtk_domain_topology&
+	operator=(vtk_domain_topology &&) = default;
+	
+	/* number of points owned by this process, i.e. size of its point data */
+	HBRS_THETA_UTILS_DECLARE_ATTR(no_of_points, std::size_t)
+	/* local ids of owned points which are exported in this order, all owned points are exported if none */
+	HBRS_THETA_UTILS_DECLARE_ATTR(point_ids, boost::optional<std::vector<std::size_t>>)
+	/* for each process, local ids of owned points whose data is sent to it */
+	HBRS_THETA_UTILS_DECLARE_ATTR(send_ids, std::vector<std::vector<std::size_t>>)
+	/* for each process, number of boundary points whose data is received from it, appended in order of ranks */
+	HBRS_THETA_UTILS_DECLARE_ATTR(recv_counts, std::vector<std::size_t>)
+	/* exported owned and boundary points with local cells followed by boundary cells, but without point data */
+	HBRS_THETA_UTILS_DECLARE_ATTR(geometry, vtkSmartPointer<vtkUnstructuredGrid>)
+};
+
 HBRS_THETA_UTILS_NAMESPACE_END
 
 #endif // !HBRS_THETA_UTILS_DETAIL_VTK_IMPL_HPP
@@ -0,0 +1,575 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE detail_vtk_test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <hbrs/mpl/detail/test.hpp>
+#include <hbrs/mpl/detail/mpi.hpp>
+
+#include <hbrs/theta_utils/detail/vtk.hpp>
+#include <hbrs/theta_utils/detail/test.hpp>
+#include <hbrs/theta_utils/dt/nc_cntr.hpp>
+#include <hbrs/theta_utils/dt/nc_exception.hpp>
+#include <hbrs/theta_utils/dt/theta_grid.hpp>
+#include <hbrs/theta_utils/dt/theta_field.hpp>
+
+#include <boost/filesystem.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/numeric/conversion/cast.hpp>
+#include <vtkCellType.h>
+#include <vtkDataArray.h>
+#include <vtkIdList.h>
+#include <vtkNew.h>
+#include <vtkPointData.h>
+#include <vtkXMLUnstructuredGridReader.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#ifdef HBRS_THETA_UTILS_ENABLE_HDF5
+	#include <hdf5.h>
+#endif
+
+namespace utf = boost::unit_test;
+namespace tt = boost::test_tools;
+namespace fs = boost::filesystem;
+
+namespace {
+using namespace hbrs::theta_utils;
+
+/* test data: tetraeder (0,1,2,3) with surface triangle (0,1,2) and point data which differs between time steps */
+inline static constexpr std::size_t
+series_no_of_points = 4;
+
+double
+density_of(std::size_t step, std::size_t point) {
+	return (step + 1.) * point;
+}
+
+double
+velocity_of(std::size_t step, std::size_t point, std::size_t component) {
+	return (step + 1.) * (point + 1.) * (component + 1.);
+}
+
+/* Writes the grid and no_of_steps time steps of the test data to folder, step j has timestamp j */
+std::pair<theta_grid_path, std::vector<theta_field_path>>
+write_series(fs::path const& folder, std::string const& prefix, std::size_t no_of_steps) {
+	theta_grid_path const grid_path{folder, prefix};
+	
+	nc_dimension const points{"no_of_points", series_no_of_points};
+	nc_dimension const elements{"no_of_elements", 1};
+	nc_dimension const surfaceelements{"no_of_surfaceelements", 1};
+	nc_dimension const triangles{"no_of_surfacetriangles", 1};
+	nc_dimension const per_tetraeder{"points_per_tetraeder", 4};
+	nc_dimension const per_triangle{"points_per_surfacetriangle", 3};
+	write_nc_cntr(
+		nc_cntr{
+			{ points, elements, surfaceelements, triangles, per_tetraeder, per_triangle },
+			{
+				{ "points_xc", { points }, { std::vector<double>{ 0., 1., 0., 0. } } },
+				{ "points_yc", { points }, { std::vector<double>{ 0., 0., 1., 0. } } },
+				{ "points_zc", { points }, { std::vector<double>{ 0., 0., 0., 1. } } },
+				{ "points_of_tetraeders", { elements, per_tetraeder }, { std::vector<int>{ 0, 1, 2, 3 } } },
+				{ "points_of_surfacetriangles", { triangles, per_triangle }, { std::vector<int>{ 0, 1, 2 } } },
+				{ "boundarymarker_of_surfaces", { surfaceelements }, { std::vector<int>{ 1 } } }
+			},
+			{}
+		},
+		grid_path.full_path().string()
+	);
+	
+	std::vector<theta_field_path> field_paths;
+	std::vector<std::tuple<theta_field, theta_field_path>> fields;
+	for(std::size_t j = 0; j < no_of_steps; ++j) {
+		std::vector<double> density, x_velocity, y_velocity, z_velocity;
+		for(std::size_t i = 0; i < series_no_of_points; ++i) {
+			density.push_back(density_of(j, i));
+			x_velocity.push_back(velocity_of(j, i, 0));
+			y_velocity.push_back(velocity_of(j, i, 1));
+			z_velocity.push_back(velocity_of(j, i, 2));
+		}
+		
+		theta_field_path const path{
+			folder,
+			prefix,
+			{ {boost::lexical_cast<std::string>(j), "000"} /* significand */, "00" /* exponent */ } /* timestamp */,
+			static_cast<int>(j) * 10 /* step */,
+			boost::none /* domain_num */,
+			theta_field_path::naming_scheme::theta
+		};
+		field_paths.push_back(path);
+		fields.push_back({
+			theta_field{ density, x_velocity, y_velocity, z_velocity, {}, {}, {}, {1} },
+			path
+		});
+	}
+	write_theta_fields(fields);
+	return { grid_path, field_paths };
+}
+
+/* tetraeder (0,1,2,3) with surface triangle (0,1,2) of boundary marker 1 and surface triangle (0,1,4) of marker 2 */
+theta_grid
+make_marked_grid() {
+	return {
+		{4}, {}, {}, {}, {3}, {},
+		{ {0, 1, 2, 3} }, {}, {}, {}, { {0, 1, 2}, {0, 1, 4} }, {}, {1, 2},
+		{ {0., 0., 0.}, {1., 0., 0.}, {0., 1., 0.}, {0., 0., 1.}, {0., -1., 0.} }
+	};
+}
+
+/* Checks that file_path is a complete VTU file which holds the point data of time step step of the test data */
+void
+check_vtu(fs::path const& file_path, std::size_t step) {
+	BOOST_TEST_REQUIRE(fs::exists(file_path));
+	vtkNew<vtkXMLUnstructuredGridReader> rdr;
+	rdr->SetFileName(file_path.string().data());
+	rdr->Update();
+	vtkUnstructuredGrid * grid = rdr->GetOutput();
+	BOOST_TEST_REQUIRE(grid->GetNumberOfPoints() == (vtkIdType)series_no_of_points);
+	BOOST_TEST(grid->GetNumberOfCells() == 2);
+	
+	vtkDataArray * density = grid->GetPointData()->GetArray("density");
+	vtkDataArray * velocity = grid->GetPointData()->GetArray("velocity");
+	BOOST_TEST_REQUIRE(density != nullptr);
+	BOOST_TEST_REQUIRE(velocity != nullptr);
+	for(std::size_t i = 0; i < series_no_of_points; ++i) {
+		BOOST_TEST(density->GetComponent(i, 0) == density_of(step, i));
+		for(std::size_t c = 0; c < 3; ++c) {
+			BOOST_TEST(velocity->GetComponent(i, c) == velocity_of(step, i, c));
+		}
+	}
+}
+
+std::vector<unsigned char>
+read_bytes(fs::path const& file_path) {
+	std::ifstream ifs{file_path.string(), std::ios::binary};
+	ifs >> std::noskipws;
+	return { std::istream_iterator<unsigned char>{ifs}, std::istream_iterator<unsigned char>{} };
+}
+
+/* Strip of triangles (2i, 2i+1, 2i+2) of which points with even global ids are owned by process 0 and points with odd
+ * global ids by process 1, so each triangle is a boundary cell. Returns the grid and the global ids owned by rank.
+ */
+std::pair<theta_grid, shared_global_id>
+make_boundary_strip(int no_of_triangles, std::size_t rank) {
+	std::vector<theta_grid::surfacetriangle> triangles;
+	std::vector<theta_grid::point> points;
+	auto global_id = std::make_shared<std::vector<int>>();
+	
+	for(int i = 0; i < no_of_triangles; ++i) {
+		triangles.push_back({ 2*i, 2*i+1, 2*i+2 });
+	}
+	
+	for(int i = 0; i <= 2*no_of_triangles; ++i) {
+		points.push_back({ (double)i, (double)(i % 2), 0. });
+		if ((std::size_t)(i % 2) == rank) {
+			global_id->push_back(i);
+		}
+	}
+	
+	theta_grid grid{
+		{}, {}, {}, {}, {3}, {},
+		{}, {}, {}, {}, triangles, {}, std::vector<int>(triangles.size(), 0),
+		points
+	};
+	return std::make_pair(grid, shared_global_id{global_id});
+}
+
+/* unnamed namespace */ }
+
+BOOST_AUTO_TEST_SUITE(detail_vtk_test)
+
+using hbrs::mpl::detail::environment_fixture;
+BOOST_TEST_GLOBAL_FIXTURE(environment_fixture);
+
+BOOST_AUTO_TEST_CASE(boundary_halo_sizes,
+	* utf::precondition(hbrs::theta_utils::detail::mpi_world_size_condition{{1,2}})
+) {
+	using namespace hbrs::theta_utils;
+	
+	namespace mpi = hbrs::mpl::detail::mpi;
+	std::size_t const mpi_size = boost::numeric_cast<std::size_t>(mpi::comm_size());
+	std::size_t const mpi_rank = boost::numeric_cast<std::size_t>(mpi::comm_rank());
+	
+	// Each process is missing all points of the other parity, i.e. no_of_triangles odd or no_of_triangles+1 even
+	// points. See boundary_scaling for timings.
+	for(int no_of_triangles : { 1, 1<<10, 1<<16 }) {
+		BOOST_TEST_MESSAGE("boundary cells=" << no_of_triangles);
+		auto strip = make_boundary_strip(no_of_triangles, mpi_rank);
+		vtk_domain_topology const topology = make_vtk_domain_topology(strip.first, strip.second);
+		
+		std::size_t const no_of_owned = strip.second->size();
+		std::size_t const no_of_missing = mpi_rank == 0 ? no_of_triangles : no_of_triangles + 1;
+		BOOST_TEST(topology.no_of_points() == no_of_owned);
+		
+		std::size_t no_of_received = 0, no_of_sent = 0;
+		for(std::size_t i = 0; i < mpi_size; ++i) {
+			no_of_received += topology.recv_counts()[i];
+			no_of_sent += topology.send_ids()[i].size();
+		}
+		
+		if (mpi_size == 1) {
+			// boundary points have no owner, hence boundary cells are dropped
+			BOOST_TEST(no_of_received == 0);
+			BOOST_TEST(no_of_sent == 0);
+			BOOST_TEST(topology.geometry()->GetNumberOfPoints() == (vtkIdType)no_of_owned);
+			BOOST_TEST(topology.geometry()->GetNumberOfCells() == 0);
+		} else {
+			// each missing point is received exactly once and each owned point is sent to the other process
+			BOOST_TEST(no_of_received == no_of_missing);
+			BOOST_TEST(no_of_sent == no_of_owned);
+			BOOST_TEST(topology.geometry()->GetNumberOfPoints() == (vtkIdType)(no_of_owned + no_of_missing));
+			BOOST_TEST(topology.geometry()->GetNumberOfCells() == no_of_triangles);
+		}
+	}
+}
+
+/* Benchmark of the halo exchange, which is disabled by default because timings are not deterministic. Run it with
+ * --run_test=detail_vtk_test/boundary_scaling --log_level=message on 2 processes. Linear scaling in the number of
+ * boundary cells shows as constant time per boundary cell.
+ */
+BOOST_AUTO_TEST_CASE(boundary_scaling,
+	* utf::disabled()
+	* utf::precondition(hbrs::theta_utils::detail::mpi_world_size_condition{{1,2}})
+) {
+	using namespace hbrs::theta_utils;
+	
+	namespace mpi = hbrs::mpl::detail::mpi;
+	std::size_t const mpi_rank = boost::numeric_cast<std::size_t>(mpi::comm_rank());
+	
+	for(int no_of_triangles : { 1<<14, 1<<16, 1<<18, 1<<20 }) {
+		auto strip = make_boundary_strip(no_of_triangles, mpi_rank);
+		
+		// best of several runs, each taking as long as the slowest process
+		double best = std::numeric_limits<double>::max();
+		for(int r = 0; r < 3; ++r) {
+			theta_field field{
+				std::vector<double>(strip.second->size(), 1.), {}, {}, {}, {}, {}, strip.second, mpi::comm_size()
+			};
+			
+			MPI_Barrier(MPI_COMM_WORLD);
+			auto start = std::chrono::steady_clock::now();
+			vtk_domain_topology const topology = make_vtk_domain_topology(strip.first, strip.second);
+			vtkSmartPointer<vtkUnstructuredGrid> vtk_grid = make_vtk_unstructured_grid(topology, field);
+			std::chrono::duration<double> const elapsed = std::chrono::steady_clock::now() - start;
+			
+			double const lcl_seconds = elapsed.count();
+			double gbl_seconds;
+			mpi::allreduce(&lcl_seconds, &gbl_seconds, 1, MPI_MAX, MPI_COMM_WORLD);
+			best = std::min(best, gbl_seconds);
+		}
+		
+		BOOST_TEST_MESSAGE(
+			"boundary cells=" << no_of_triangles << " seconds=" << best
+			<< " nanoseconds per boundary cell=" << best / no_of_triangles * 1e9
+		);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(cell_selection,
+	* utf::precondition(hbrs::theta_utils::detail::mpi_world_size_condition{{1}})
+) {
+	using namespace hbrs::theta_utils;
+	
+	theta_grid const grid = make_marked_grid();
+	theta_field const field{ {0., 1., 2., 3., 4.}, {}, {}, {}, {}, {}, {}, {} };
+	
+	auto const densities_of = [&](vtk_cell_selection const& selection) {
+		vtk_domain_topology const topology = make_vtk_domain_topology(grid, field.global_id(), selection);
+		theta_field wrapped = field;
+		double const* buffer = wrapped.density().data();
+		vtkSmartPointer<vtkUnstructuredGrid> vtk_grid = make_vtk_unstructured_grid(topology, wrapped);
+		BOOST_TEST(vtk_grid->GetNumberOfPoints() == topology.geometry()->GetNumberOfPoints());
+		
+		vtkDataArray * density = vtk_grid->GetPointData()->GetArray("density");
+		// values of exported points are moved to the front of the buffer of field instead of being copied
+		BOOST_TEST(static_cast<double const*>(density->GetVoidPointer(0)) == buffer);
+		std::vector<double> densities;
+		for(vtkIdType i = 0; i < density->GetNumberOfTuples(); ++i) {
+			densities.push_back(density->GetTuple1(i));
+		}
+		return std::make_pair(vtk_grid->GetNumberOfCells(), densities);
+	};
+	
+	auto const all = densities_of(vtk_cell_selection{});
+	BOOST_TEST(all.first == 3);
+	BOOST_TEST(all.second == std::vector<double>({0., 1., 2., 3., 4.}), tt::per_element());
+	
+	auto const volume = densities_of(vtk_cell_selection{vtk_cell_kind::volume, {}});
+	BOOST_TEST(volume.first == 1);
+	BOOST_TEST(volume.second == std::vector<double>({0., 1., 2., 3.}), tt::per_element());
+	
+	auto const surface = densities_of(vtk_cell_selection{vtk_cell_kind::surface, {}});
+	BOOST_TEST(surface.first == 2);
+	BOOST_TEST(surface.second == std::vector<double>({0., 1., 2., 4.}), tt::per_element());
+	
+	auto const marker = densities_of(vtk_cell_selection{vtk_cell_kind::surface, {2}});
+	BOOST_TEST(marker.first == 1);
+	BOOST_TEST(marker.second == std::vector<double>({0., 1., 4.}), tt::per_element());
+}
+
+BOOST_AUTO_TEST_CASE(streamed_vtu,
+	* utf::precondition(hbrs::theta_utils::detail::mpi_world_size_condition{{1}})
+) {
+	using namespace hbrs::theta_utils;
+	
+	detail::io_fixture fx{"streamed_vtu"};
+	BOOST_TEST_MESSAGE("Working directory: " << fx.wd().path().string());
+	
+	theta_grid const grid = make_marked_grid();
+	theta_field const field{
+		{0., 1., 2., 3., 4.}, {5., 6., 7., 8., 9.}, {-1., -2., -3., -4., -5.}, {.5, .25, .125, 0., 1.}, {}, {}, {}, {}
+	};
+	
+	std::vector<vtk_cell_selection> const selections = {
+		vtk_cell_selection{}, vtk_cell_selection{vtk_cell_kind::surface, {2}}
+	};
+	for(std::size_t s = 0; s < selections.size(); ++s) {
+		vtk_domain_topology const topology = make_vtk_domain_topology(grid, field.global_id(), selections[s]);
+		theta_field wrapped = field;
+		vtkSmartPointer<vtkUnstructuredGrid> expected = make_vtk_unstructured_grid(topology, wrapped);
+		
+		fs::path const path = fx.wd().path() / (fx.prefix() + "_" + boost::lexical_cast<std::string>(s) + ".vtu");
+		write_vtk_xml_streamed(topology, field, path.string().data());
+		
+		vtkNew<vtkXMLUnstructuredGridReader> rdr;
+		rdr->SetFileName(path.string().data());
+		rdr->Update();
+		vtkUnstructuredGrid * actual = rdr->GetOutput();
+		
+		BOOST_TEST_REQUIRE(actual->GetNumberOfPoints() == expected->GetNumberOfPoints());
+		BOOST_TEST_REQUIRE(actual->GetNumberOfCells() == expected->GetNumberOfCells());
+		
+		for(vtkIdType i = 0; i < expected->GetNumberOfPoints(); ++i) {
+			for(int c = 0; c < 3; ++c) {
+				BOOST_TEST(actual->GetPoint(i)[c] == expected->GetPoint(i)[c]);
+			}
+		}
+		
+		for(vtkIdType i = 0; i < expected->GetNumberOfCells(); ++i) {
+			BOOST_TEST(actual->GetCellType(i) == expected->GetCellType(i));
+			vtkNew<vtkIdList> actual_ids, expected_ids;
+			actual->GetCellPoints(i, actual_ids.GetPointer());
+			expected->GetCellPoints(i, expected_ids.GetPointer());
+			BOOST_TEST_REQUIRE(actual_ids->GetNumberOfIds() == expected_ids->GetNumberOfIds());
+			for(vtkIdType j = 0; j < expected_ids->GetNumberOfIds(); ++j) {
+				BOOST_TEST(actual_ids->GetId(j) == expected_ids->GetId(j));
+			}
+		}
+		
+		for(char const * name : { "density", "velocity" }) {
+			vtkDataArray * actual_values = actual->GetPointData()->GetArray(name);
+			vtkDataArray * expected_values = expected->GetPointData()->GetArray(name);
+			BOOST_TEST_REQUIRE(actual_values != nullptr);
+			BOOST_TEST_REQUIRE(actual_values->GetNumberOfComponents() == expected_values->GetNumberOfComponents());
+			BOOST_TEST_REQUIRE(actual_values->GetNumberOfTuples() == expected_values->GetNumberOfTuples());
+			for(vtkIdType i = 0; i < expected_values->GetNumberOfTuples(); ++i) {
+				for(int c = 0; c < expected_values->GetNumberOfComponents(); ++c) {
+					BOOST_TEST(actual_values->GetComponent(i, c) == expected_values->GetComponent(i, c));
+				}
+			}
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(pipeline_depth,
+	* utf::precondition(hbrs::theta_utils::detail::mpi_world_size_condition{{1}})
+) {
+	using namespace hbrs::theta_utils;
+	
+	detail::io_fixture fx{"pipeline_depth"};
+	BOOST_TEST_MESSAGE("Working directory: " << fx.wd().path().string());
+	
+	static constexpr std::size_t no_of_steps = 5;
+	auto const series = write_series(fx.wd().path(), fx.prefix(), no_of_steps);
+	
+	// reading and writing ahead must neither change nor reorder the files written for each step
+	for(auto format : { vtk_file_format::xml_binary, vtk_file_format::xml_streamed }) {
+		std::vector<std::vector<fs::path>> outputs;
+		for(std::size_t pipeline_depth : { 0, 2 }) {
+			fs::path const folder =
+				fx.wd().path() / ("depth_" + boost::lexical_cast<std::string>(pipeline_depth));
+			fs::create_directories(folder);
+			convert_to_vtk(
+				series.first, series.second, folder, "converted", {}, {}, true, format, true, pipeline_depth,
+				vtk_xml_encoding{}, vtk_cell_selection{}
+			);
+			
+			outputs.emplace_back();
+			for(std::size_t j = 0; j < no_of_steps; ++j) {
+				fs::path const path = vtk_path{
+					folder, "converted.nr_" + boost::lexical_cast<std::string>(j), false, format
+				}.full_path();
+				check_vtu(path, j);
+				outputs.back().push_back(path);
+			}
+		}
+		
+		for(std::size_t j = 0; j < no_of_steps; ++j) {
+			BOOST_TEST(read_bytes(outputs[0][j]) == read_bytes(outputs[1][j]), tt::per_element());
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(pipeline_read_error,
+	* utf::precondition(hbrs::theta_utils::detail::mpi_world_size_condition{{1}})
+) {
+	using namespace hbrs::theta_utils;
+	
+	detail::io_fixture fx{"pipeline_read_error"};
+	BOOST_TEST_MESSAGE("Working directory: " << fx.wd().path().string());
+	
+	static constexpr std::size_t no_of_steps = 5;
+	static constexpr std::size_t broken_step = 3;
+	auto const series = write_series(fx.wd().path(), fx.prefix(), no_of_steps);
+	{
+		std::ofstream ofs{series.second[broken_step].full_path().string(), std::ios::binary | std::ios::trunc};
+		ofs << "not a netCDF file";
+	}
+	
+	for(auto format : { vtk_file_format::xml_binary, vtk_file_format::xml_streamed }) {
+		for(std::size_t pipeline_depth : { 0, 2 }) {
+			BOOST_TEST_MESSAGE("pipeline_depth := " << pipeline_depth);
+			fs::path const folder =
+				fx.wd().path() / ("depth_" + boost::lexical_cast<std::string>(pipeline_depth));
+			fs::create_directories(folder);
+			
+			// error of the reader job is rethrown on the calling thread
+			BOOST_CHECK_THROW(
+				convert_to_vtk(
+					series.first, series.second, folder, "converted", {}, {}, true, format, true, pipeline_depth,
+					vtk_xml_encoding{}, vtk_cell_selection{}
+				),
+				nc_exception
+			);
+			
+			// writes of all steps before the broken one have been finished before returning
+			for(std::size_t j = 0; j < broken_step; ++j) {
+				check_vtu(
+					vtk_path{folder, "converted.nr_" + boost::lexical_cast<std::string>(j), false, format}.full_path(),
+					j
+				);
+			}
+		}
+	}
+}
+
+#ifdef HBRS_THETA_UTILS_ENABLE_HDF5
+BOOST_AUTO_TEST_CASE(vtk_hdf,
+	* utf::precondition(hbrs::theta_utils::detail::mpi_world_size_condition{{1}})
+) {
+	using namespace hbrs::theta_utils;
+	
+	detail::io_fixture fx{"vtk_hdf"};
+	BOOST_TEST_MESSAGE("Working directory: " << fx.wd().path().string());
+	
+	static constexpr std::size_t no_of_steps = 2;
+	auto const series = write_series(fx.wd().path(), fx.prefix(), no_of_steps);
+	convert_to_vtk(
+		series.first, series.second, fx.wd().path(), "converted", {}, {}, false, vtk_file_format::hdf, false, 0,
+		vtk_xml_encoding{}, vtk_cell_selection{}
+	);
+	
+	// file is read with plain HDF5 calls, vtkHDFReader supports transient files since VTK 9.3 only
+	fs::path const path = vtk_path{fx.wd().path(), "converted", false, vtk_file_format::hdf}.full_path();
+	hid_t const file = H5Fopen(path.string().c_str(), H5F_ACC_RDONLY, H5P_DEFAULT);
+	BOOST_TEST_REQUIRE(file >= 0);
+	
+	auto const read = [file](char const * name, hid_t type, auto & values, std::vector<hsize_t> const& dims) {
+		hid_t const dset = H5Dopen2(file, name, H5P_DEFAULT);
+		BOOST_TEST_REQUIRE(dset >= 0);
+		hid_t const space = H5Dget_space(dset);
+		std::vector<hsize_t> got_dims(H5Sget_simple_extent_ndims(space));
+		H5Sget_simple_extent_dims(space, got_dims.data(), nullptr);
+		BOOST_TEST(got_dims == dims, tt::per_element());
+		values.resize(H5Sget_simple_extent_npoints(space));
+		BOOST_TEST(H5Dread(dset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, values.data()) >= 0);
+		H5Sclose(space);
+		H5Dclose(dset);
+	};
+	
+	std::vector<std::int64_t> ints;
+	std::vector<double> doubles;
+	std::vector<unsigned char> types;
+	
+	read("VTKHDF/NumberOfPoints", H5T_NATIVE_INT64, ints, { 1 });
+	BOOST_TEST(ints == std::vector<std::int64_t>({ series_no_of_points }), tt::per_element());
+	read("VTKHDF/NumberOfCells", H5T_NATIVE_INT64, ints, { 1 });
+	BOOST_TEST(ints == std::vector<std::int64_t>({ 2 }), tt::per_element());
+	read("VTKHDF/Types", H5T_NATIVE_UCHAR, types, { 2 });
+	BOOST_TEST(types == std::vector<unsigned char>({ VTK_TETRA, VTK_TRIANGLE }), tt::per_element());
+	
+	// each part has one offset more than cells
+	read("VTKHDF/Offsets", H5T_NATIVE_INT64, ints, { 3 });
+	BOOST_TEST(ints == std::vector<std::int64_t>({ 0, 4, 7 }), tt::per_element());
+	read("VTKHDF/Connectivity", H5T_NATIVE_INT64, ints, { 7 });
+	BOOST_TEST(ints == std::vector<std::int64_t>({ 0, 1, 2, 3, 0, 1, 2 }), tt::per_element());
+	
+	// timestamps of the time steps
+	read("VTKHDF/Steps/Values", H5T_NATIVE_DOUBLE, doubles, { no_of_steps });
+	BOOST_TEST(doubles == std::vector<double>({ 0., 1. }), tt::per_element());
+	
+	int nsteps = 0;
+	hid_t const steps = H5Gopen2(file, "VTKHDF/Steps", H5P_DEFAULT);
+	hid_t const attr = H5Aopen(steps, "NSteps", H5P_DEFAULT);
+	BOOST_TEST(H5Aread(attr, H5T_NATIVE_INT, &nsteps) >= 0);
+	BOOST_TEST(nsteps == (int)no_of_steps);
+	H5Aclose(attr);
+	H5Gclose(steps);
+	
+	// geometry of the first step is reused, point data of each step is appended
+	for(auto name : { "PointOffsets", "CellOffsets", "ConnectivityIdOffsets" }) {
+		read(("VTKHDF/Steps/" + std::string{name}).c_str(), H5T_NATIVE_INT64, ints, { no_of_steps });
+		BOOST_TEST(ints == std::vector<std::int64_t>({ 0, 0 }), tt::per_element());
+	}
+	for(auto name : { "density", "velocity" }) {
+		read(("VTKHDF/Steps/PointDataOffsets/" + std::string{name}).c_str(), H5T_NATIVE_INT64, ints, { no_of_steps });
+		BOOST_TEST(ints == std::vector<std::int64_t>({ 0, series_no_of_points }), tt::per_element());
+	}
+	
+	std::vector<double> densities, velocities;
+	for(std::size_t j = 0; j < no_of_steps; ++j) {
+		for(std::size_t i = 0; i < series_no_of_points; ++i) {
+			densities.push_back(density_of(j, i));
+			for(std::size_t c = 0; c < 3; ++c) {
+				velocities.push_back(velocity_of(j, i, c));
+			}
+		}
+	}
+	
+	read("VTKHDF/PointData/density", H5T_NATIVE_DOUBLE, doubles, { no_of_steps * series_no_of_points });
+	BOOST_TEST(doubles == densities, tt::per_element());
+	read("VTKHDF/PointData/velocity", H5T_NATIVE_DOUBLE, doubles, { no_of_steps * series_no_of_points, 3 });
+	BOOST_TEST(doubles == velocities, tt::per_element());
+	
+	H5Fclose(file);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
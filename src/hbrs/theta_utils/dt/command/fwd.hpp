@@ -27,6 +27,8 @@ struct HBRS_THETA_UTILS_API version_cmd;
 struct HBRS_THETA_UTILS_API help_cmd;
 struct HBRS_THETA_UTILS_API visualize_cmd;
 struct HBRS_THETA_UTILS_API pca_cmd;
+struct HBRS_THETA_UTILS_API reconstruct_cmd;
+struct HBRS_THETA_UTILS_API project_cmd;
 
 HBRS_THETA_UTILS_NAMESPACE_END
 
@@ -48,6 +48,20 @@ struct HBRS_THETA_UTILS_API pca_cmd {
 	pca_options pca_opts;
 };
 
+struct HBRS_THETA_UTILS_API reconstruct_cmd {
+	generic_options g_opts;
+	theta_input_options i_opts;
+	theta_output_options o_opts;
+	reconstruct_options r_opts;
+};
+
+struct HBRS_THETA_UTILS_API project_cmd {
+	generic_options g_opts;
+	theta_input_options i_opts;
+	theta_output_options o_opts;
+	project_options p_opts;
+};
+
 HBRS_THETA_UTILS_NAMESPACE_END
 
 #endif // !HBRS_THETA_UTILS_DT_COMMAND_IMPL_HPP
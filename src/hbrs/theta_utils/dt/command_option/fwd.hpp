@@ -25,7 +25,7 @@
 HBRS_THETA_UTILS_NAMESPACE_BEGIN
 namespace hana = boost::hana;
 
-enum class pca_backend { matlab_lapack, elemental_openmp, elemental_mpi };
+enum class pca_backend { matlab_lapack, elemental_openmp, elemental_mpi, randomized };
 template <pca_backend backend>
 using pca_backend_ = hana::integral_constant<pca_backend, backend>;
 template <pca_backend backend>
@@ -37,12 +37,16 @@ using elemental_openmp_backend = pca_backend_<pca_backend::elemental_openmp>;
 constexpr auto elemental_openmp_backend_c = elemental_openmp_backend{};
 using elemental_mpi_backend = pca_backend_<pca_backend::elemental_mpi>;
 constexpr auto elemental_mpi_backend_c = elemental_mpi_backend{};
+using randomized_backend = pca_backend_<pca_backend::randomized>;
+constexpr auto randomized_backend_c = randomized_backend{};
 
 struct HBRS_THETA_UTILS_API generic_options;
 struct HBRS_THETA_UTILS_API theta_input_options;
 struct HBRS_THETA_UTILS_API theta_output_options;
 struct HBRS_THETA_UTILS_API visualize_options;
 struct HBRS_THETA_UTILS_API pca_options;
+struct HBRS_THETA_UTILS_API reconstruct_options;
+struct HBRS_THETA_UTILS_API project_options;
 
 HBRS_THETA_UTILS_NAMESPACE_END
 
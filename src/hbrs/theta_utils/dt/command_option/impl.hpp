@@ -47,6 +47,12 @@ struct HBRS_THETA_UTILS_API visualize_options {
 	std::vector<std::string> excludes;
 	vtk_file_format format;
 	bool simple_numbering;
+	/* number of time steps read ahead and written in the background, zero disables the pipeline */
+	std::size_t pipeline_depth = 1;
+	vtk_xml_encoding encoding;
+	vtk_cell_selection selection;
+	/* print bytes written and seconds per step for each encoding instead of converting */
+	bool benchmark = false;
 };
 
 struct HBRS_THETA_UTILS_API pca_options {
@@ -55,6 +61,33 @@ struct HBRS_THETA_UTILS_API pca_options {
 	bool center;
 	bool normalize;
 	bool keep_centered;
+	bool streaming = false;
+	bool update = false;
+	/* write spatial modes, mean and temporal coefficients instead of pca-filtered theta fields */
+	bool modes = false;
+	/* write global_id once per domain to a topology file which is referenced by all pca-filtered time steps */
+	bool topology_file = false;
+	/* number of points per block if streaming, zero derives it from block_memory */
+	std::size_t block_size = 0;
+	/* approximate number of bytes of a block and its pca-filtered copies, independent of the number of time steps */
+	std::size_t block_memory = std::size_t{256} << 20;
+	/* number of process rows of the grid used for the svd by backend ELEMENTAL_MPI, zero selects a nearly square grid */
+	std::size_t grid_height = 0;
+	/* parameters of randomized backend */
+	std::size_t rank = 0;
+	std::size_t oversampling = 10;
+	std::size_t power_iterations = 2;
+};
+
+struct HBRS_THETA_UTILS_API reconstruct_options {
+	std::vector<std::string> pc_nr_seqs;
+	std::vector<std::string> step_nr_seqs;
+	bool keep_centered;
+};
+
+struct HBRS_THETA_UTILS_API project_options {
+	std::string model_path;
+	std::string model_prefix;
 };
 
 HBRS_THETA_UTILS_NAMESPACE_END
@@ -40,6 +40,8 @@ struct HBRS_THETA_UTILS_API ambiguous_grid_exception;
 struct HBRS_THETA_UTILS_API invalid_number_range_spec_exception;
 struct HBRS_THETA_UTILS_API invalid_grid_exception;
 struct HBRS_THETA_UTILS_API vtk_exception;
+struct HBRS_THETA_UTILS_API hdf5_exception;
+struct HBRS_THETA_UTILS_API incompatible_model_exception;
 
 typedef boost::error_info<struct errinfo_ambiguous_field_paths_, std::tuple<fs::path, fs::path> > errinfo_ambiguous_field_paths;
 struct HBRS_THETA_UTILS_API domain_num_mismatch_error_info;
@@ -47,6 +49,7 @@ typedef boost::error_info<struct errinfo_domain_num_mismatch_, domain_num_mismat
 typedef boost::error_info<struct errinfo_vtk_file_format_, vtk_file_format> errinfo_vtk_file_format;
 typedef boost::error_info<struct errinfo_number_range_spec_, std::string> errinfo_number_range_spec;
 typedef boost::error_info<struct errinfo_vtk_error_, std::string> errinfo_vtk_error;
+typedef boost::error_info<struct errinfo_hdf5_error_, std::string> errinfo_hdf5_error;
 typedef boost::error_info<struct errinfo_pca_backend_, pca_backend> errinfo_pca_backend;
 
 HBRS_THETA_UTILS_API
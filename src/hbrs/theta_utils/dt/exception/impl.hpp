@@ -38,6 +38,8 @@ struct HBRS_THETA_UTILS_API ambiguous_grid_exception : virtual mpl::exception {}
 struct HBRS_THETA_UTILS_API invalid_number_range_spec_exception : virtual mpl::exception {};
 struct HBRS_THETA_UTILS_API invalid_grid_exception : virtual mpl::exception {};
 struct HBRS_THETA_UTILS_API vtk_exception : virtual mpl::exception {};
+struct HBRS_THETA_UTILS_API hdf5_exception : virtual mpl::exception {};
+struct HBRS_THETA_UTILS_API incompatible_model_exception : virtual mpl::exception {};
 
 struct HBRS_THETA_UTILS_API domain_num_mismatch_error_info {
 	domain_num_mismatch_error_info(fs::path path, int expected, boost::optional<int> got);
@@ -18,6 +18,7 @@
 #define HBRS_THETA_UTILS_DT_NC_CNTR_FWD_HPP
 
 #include <hbrs/theta_utils/config.hpp>
+#include <hbrs/theta_utils/dt/nc_dimension/fwd.hpp>
 #include <boost/hana/fwd/core/make.hpp>
 #include <boost/hana/fwd/core/to.hpp>
 
@@ -32,6 +33,8 @@ struct nc_cntr_tag {};
 constexpr auto make_nc_cntr = hana::make<nc_cntr_tag>;
 constexpr auto to_nc_cntr = hana::to<nc_cntr_tag>;
 
+struct HBRS_THETA_UTILS_API nc_file;
+
 HBRS_THETA_UTILS_API
 nc_cntr
 read_nc_cntr(
@@ -40,6 +43,60 @@ read_nc_cntr(
 	std::vector<std::string> const& excludes = {} /*regex filter*/
 );
 
+/* Reads several groups of variables while opening the file just once. Each group is a list of regex filters like
+ * includes of read_nc_cntr() and yields its own container with all dimensions and attributes of the file but only
+ * the variables of that group. Groups may overlap.
+ */
+HBRS_THETA_UTILS_API
+std::vector<nc_cntr>
+read_nc_cntr_groups(
+	std::string const& path,
+	std::vector<std::vector<std::string>> const& includes_groups /*regex filters*/
+);
+
+/* Reads count elements beginning at start along the first dimension of each variable. Those dimensions are shortened
+ * accordingly in the returned container, i.e. it looks like a file with just this block of data.
+ */
+HBRS_THETA_UTILS_API
+nc_cntr
+read_nc_cntr_block(
+	std::string const& path,
+	std::size_t start,
+	std::size_t count,
+	std::vector<std::string> const& includes = {} /*regex filter*/,
+	std::vector<std::string> const& excludes = {} /*regex filter*/
+);
+
+HBRS_THETA_UTILS_API
+std::vector<nc_dimension>
+read_nc_dimensions(std::string const& path);
+
+/* Reads each variable names[i] straight into buffers[i], bypassing nc_cntr and its intermediate copies. Values are
+ * converted to double by netCDF. Each buffer must have room for size values and each variable must have exactly size
+ * values.
+ */
+HBRS_THETA_UTILS_API
+void
+read_nc_variables(
+	std::string const& path,
+	std::vector<std::string> const& names,
+	std::vector<double *> const& buffers,
+	std::size_t size
+);
+
+/* Like read_nc_variables() but reads values [start, start+count) of one-dimensional variables from a file which is
+ * kept open, e.g. to read one block after another without reopening the file for each block.
+ */
+HBRS_THETA_UTILS_API
+void
+read_nc_variables_block(
+	nc_file const& file,
+	std::vector<std::string> const& names,
+	std::vector<double *> const& buffers,
+	std::size_t start,
+	std::size_t count
+);
+
 HBRS_THETA_UTILS_API
 void
 write_nc_cntr(
@@ -48,6 +105,33 @@ write_nc_cntr(
 	bool overwrite = false
 );
 
+/* Creates a file with all dimensions, variables and attributes of cntr but does not write any variable data */
+HBRS_THETA_UTILS_API
+void
+define_nc_cntr(
+	nc_cntr const& cntr,
+	std::string const& path,
+	bool overwrite = false
+);
+
+/* Writes all variables of cntr to an existing file, beginning at start along the first dimension of each variable */
+HBRS_THETA_UTILS_API
+void
+write_nc_cntr_block(
+	nc_cntr const& cntr,
+	std::string const& path,
+	std::size_t start
+);
+
+/* Like write_nc_cntr_block() above but writes to a file which has been opened for writing and is kept open */
+HBRS_THETA_UTILS_API
+void
+write_nc_cntr_block(
+	nc_cntr const& cntr,
+	nc_file const& file,
+	std::size_t start
+);
+
 HBRS_THETA_UTILS_NAMESPACE_END
 
 #endif // !HBRS_THETA_UTILS_DT_NC_CNTR_FWD_HPP
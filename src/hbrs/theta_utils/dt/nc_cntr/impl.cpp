@@ -18,6 +18,7 @@
 
 #include <hbrs/theta_utils/dt/nc_exception.hpp>
 #include <boost/throw_exception.hpp>
+#include <boost/assert.hpp>
 
 #include <netcdf.h>
 #include <algorithm>
@@ -106,19 +107,31 @@ throw_if_error(int ncid, int status, std::string path, bool close_fd) {
 	}
 }
 
-/* unnamed namespace */ }
+/* block of a file along the first dimension of its variables */
+struct nc_block {
+	std::size_t start;
+	std::size_t count;
+};
 
-HBRS_THETA_UTILS_API
-nc_cntr
-read_nc_cntr(
+/* regex filters selecting a group of variables of a file */
+struct nc_filter {
+	std::vector<std::string> includes;
+	std::vector<std::string> excludes;
+};
+
+/* Opens path once and returns one container per filter group, each with all dimensions and attributes of the file
+ * but only the variables selected by its group. Variables selected by several groups are read just once.
+ */
+std::vector<nc_cntr>
+read_nc_cntr_impl(
 	std::string const& path,
-	std::vector<std::string> const& includes /*regex filter*/,
-	std::vector<std::string> const& excludes /*regex filter*/
+	std::vector<nc_filter> const& groups,
+	boost::optional<nc_block> const& block
 ) {
 	int ncid, ndims, nvars, ngatts, status;
 	
 	std::vector<nc_dimension> dimensions;
-	std::vector<nc_variable> variables;
+	std::vector<std::vector<nc_variable>> variables(groups.size());
 	std::vector<nc_attribute> attributes;
 	
 	struct var {
@@ -130,7 +143,8 @@ read_nc_cntr(
 	};
 	
 	std::vector<var> vars;
-	std::vector<bool> use_vars;
+	// use_vars[g][i] is true iff group g selects variable i
+	std::vector<std::vector<bool>> use_vars(groups.size());
 	
 	status = nc_open(path.data(), NC_NOWRITE, &ncid);
 	throw_if_error(ncid, status, path, false);
@@ -165,31 +179,73 @@ read_nc_cntr(
 		}
 	}
 	
-	if (includes.empty()) {
-		use_vars.resize(nvars, true);
-	} else {
-		use_vars.resize(nvars, false);
-		for(auto const& include : includes) {
-			std::regex regex{include};
-			for(int i = 0; i < nvars; ++i) {
-				if (use_vars[i] == false) {
-					use_vars[i] = std::regex_search(vars[i].name, regex);
+	for(std::size_t g = 0; g < groups.size(); ++g) {
+		auto const& includes = groups[g].includes;
+		auto const& excludes = groups[g].excludes;
+		auto & use = use_vars[g];
+		
+		if (includes.empty()) {
+			use.resize(nvars, true);
+		} else {
+			use.resize(nvars, false);
+			for(auto const& include : includes) {
+				std::regex regex{include};
+				for(int i = 0; i < nvars; ++i) {
+					if (use[i] == false) {
+						use[i] = std::regex_search(vars[i].name, regex);
+					}
+				}
+			}
+		}
+		
+		if (excludes.size()) {
+			for(auto const& exclude : excludes) {
+				std::regex regex{exclude};
+				for(int i = 0; i < nvars; ++i) {
+					if (use[i] == true) {
+						use[i] = !std::regex_search(vars[i].name, regex);
+					}
 				}
 			}
 		}
 	}
 	
-	if (excludes.size()) {
-		for(auto const& exclude : excludes) {
-			std::regex regex{exclude};
-			for(int i = 0; i < nvars; ++i) {
-				if (use_vars[i] == true) {
-					use_vars[i] = !std::regex_search(vars[i].name, regex);
-				}
+	auto const used = [&use_vars](int i) {
+		return std::any_of(use_vars.begin(), use_vars.end(), [i](auto const& use) { return use[i] == true; });
+	};
+	
+	// offsets of dimensions which are read partially
+	std::vector<std::size_t> offsets(ndims, 0);
+	std::vector<bool> blocked(ndims, false);
+	if (block) {
+		for(int i = 0; i < nvars; ++i) {
+			if (used(i) && !vars[i].dimids.empty()) {
+				blocked[vars[i].dimids[0]] = true;
 			}
 		}
+		
+		for(int dimid = 0; dimid < ndims; ++dimid) {
+			if (!blocked[dimid]) { continue; }
+			
+			nc_dimension & dim = dimensions[dimid];
+			offsets[dimid] = std::min(block->start, dim.length());
+			dim = nc_dimension{dim.name(), std::min(block->count, dim.length() - offsets[dimid])};
+		}
 	}
 	
+	auto const get_var = [&](var const& v, void * data) {
+		if (!block) {
+			return nc_get_var(ncid, v.id, data);
+		}
+		
+		std::vector<std::size_t> start, count;
+		for(int dimid : v.dimids) {
+			start.push_back(offsets[dimid]);
+			count.push_back(dimensions[dimid].length());
+		}
+		return nc_get_vara(ncid, v.id, start.data(), count.data(), data);
+	};
+	
 	auto const total = [&dimensions](std::vector<int> const& dimids) {
 		return std::accumulate(dimids.begin(), dimids.end(), 1, 
 			[&dimensions](std::size_t const& length, int const& dim) {
@@ -207,17 +263,24 @@ read_nc_cntr(
 		);
 	};
 	
-	variables.reserve(vars.size());
+	auto const add_var = [&](int i, nc_variable const& variable) {
+		for(std::size_t g = 0; g < groups.size(); ++g) {
+			if (use_vars[g][i]) {
+				variables[g].push_back(variable);
+			}
+		}
+	};
+	
 #define __nc_type_case(__nc_type, __type)                                                                              \
 	if (var.type == __nc_type) {                                                                                       \
 		std::vector<__type> data(total(var.dimids));                                                                   \
-		status = nc_get_var(ncid, var.id, data.data());                                                                \
+		status = get_var(var, data.data());                                                                            \
 		throw_if_error(ncid, status, path, true);                                                                      \
-		variables.push_back({var.name, get_dims(var.dimids), {data}});                                                 \
+		add_var(i, {var.name, get_dims(var.dimids), {data}});                                                          \
 	} else
 
 	for(int i = 0; i < nvars; ++i) {
-		if (!use_vars[i]) { continue; }
+		if (!used(i)) { continue; }
 		
 		auto const& var = vars[i];
 		
@@ -280,10 +343,196 @@ read_nc_cntr(
 	status = nc_close(ncid);
 	throw_if_error(ncid, status, path, false);
 	
+	std::vector<nc_cntr> cntrs;
+	cntrs.reserve(groups.size());
+	for(auto & group_variables : variables) {
+		cntrs.push_back(nc_cntr{dimensions, std::move(group_variables), attributes});
+	}
+	return cntrs;
+}
+
+/* unnamed namespace */ }
+
+HBRS_THETA_UTILS_API
+nc_cntr
+read_nc_cntr(
+	std::string const& path,
+	std::vector<std::string> const& includes /*regex filter*/,
+	std::vector<std::string> const& excludes /*regex filter*/
+) {
+	return read_nc_cntr_impl(path, {{includes, excludes}}, boost::none).at(0);
+}
+
+HBRS_THETA_UTILS_API
+std::vector<nc_cntr>
+read_nc_cntr_groups(
+	std::string const& path,
+	std::vector<std::vector<std::string>> const& includes_groups /*regex filters*/
+) {
+	std::vector<nc_filter> groups;
+	groups.reserve(includes_groups.size());
+	for(auto const& includes : includes_groups) {
+		groups.push_back({includes, {}});
+	}
+	return read_nc_cntr_impl(path, groups, boost::none);
+}
+
+HBRS_THETA_UTILS_API
+nc_cntr
+read_nc_cntr_block(
+	std::string const& path,
+	std::size_t start,
+	std::size_t count,
+	std::vector<std::string> const& includes /*regex filter*/,
+	std::vector<std::string> const& excludes /*regex filter*/
+) {
+	return read_nc_cntr_impl(path, {{includes, excludes}}, nc_block{start, count}).at(0);
+}
+
+HBRS_THETA_UTILS_API
+std::vector<nc_dimension>
+read_nc_dimensions(std::string const& path) {
+	int ncid, ndims, status;
+	
+	status = nc_open(path.data(), NC_NOWRITE, &ncid);
+	throw_if_error(ncid, status, path, false);
+	
+	status = nc_inq_ndims(ncid, &ndims);
+	throw_if_error(ncid, status, path, true);
+	
+	std::vector<nc_dimension> dimensions;
+	dimensions.reserve(ndims);
+	{
+		std::array<char, NC_MAX_NAME+1> name;
+		size_t length;
+		for(int dimid = 0; dimid < ndims; ++dimid) {
+			status = nc_inq_dim(ncid, dimid, name.data(), &length);
+			throw_if_error(ncid, status, path, true);
+			dimensions.push_back({name.data(), length});
+		}
+	}
+	
+	status = nc_close(ncid);
+	throw_if_error(ncid, status, path, false);
+	
+	return dimensions;
+}
+
+HBRS_THETA_UTILS_API
+void
+read_nc_variables(
+	std::string const& path,
+	std::vector<std::string> const& names,
+	std::vector<double *> const& buffers,
+	std::size_t size
+) {
+	BOOST_ASSERT(names.size() == buffers.size());
+	int ncid, status;
+	
+	status = nc_open(path.data(), NC_NOWRITE, &ncid);
+	throw_if_error(ncid, status, path, false);
+	
+	for(std::size_t i = 0; i < names.size(); ++i) {
+		int varid, ndims;
+		int dimids[NC_MAX_VAR_DIMS];
+		
+		status = nc_inq_varid(ncid, names[i].data(), &varid);
+		throw_if_error(ncid, status, path, true);
+		
+		status = nc_inq_var(ncid, varid, nullptr, nullptr, &ndims, dimids, nullptr);
+		throw_if_error(ncid, status, path, true);
+		
+		std::size_t total = 1;
+		for(int d = 0; d < ndims; ++d) {
+			std::size_t length;
+			status = nc_inq_dimlen(ncid, dimids[d], &length);
+			throw_if_error(ncid, status, path, true);
+			total *= length;
+		}
+		
+		if (total != size) {
+			throw_if_error(ncid, NC_EDIMSIZE, path, true);
+		}
+		
+		status = nc_get_var_double(ncid, varid, buffers[i]);
+		throw_if_error(ncid, status, path, true);
+	}
+	
+	status = nc_close(ncid);
+	throw_if_error(ncid, status, path, false);
+}
+
+nc_file::nc_file(std::string path, bool writable) : path_{std::move(path)}, ncid_{-1} {
+	int status = nc_open(path_.data(), writable ? NC_WRITE : NC_NOWRITE, &ncid_);
+	throw_if_error(ncid_, status, path_, false);
+}
+
+nc_file::nc_file(nc_file && other) noexcept : path_{std::move(other.path_)}, ncid_{other.ncid_} {
+	other.ncid_ = -1;
+}
+
+nc_file::~nc_file() {
+	if (ncid_ >= 0) {
+		nc_close(ncid_);
+	}
+}
+
+void
+nc_file::close() {
+	if (ncid_ < 0) {
+		return;
+	}
+	
+	int const ncid = ncid_;
+	ncid_ = -1;
+	int status = nc_close(ncid);
+	throw_if_error(ncid, status, path_, false);
+}
+
+std::string const&
+nc_file::path() const {
+	return path_;
+}
+
+int
+nc_file::ncid() const {
+	return ncid_;
+}
+
+HBRS_THETA_UTILS_API
+void
+read_nc_variables_block(
+	nc_file const& file,
+	std::vector<std::string> const& names,
+	std::vector<double *> const& buffers,
+	std::size_t start,
+	std::size_t count
+) {
+	BOOST_ASSERT(names.size() == buffers.size());
+	// errors must not close the file because it is owned by file
+	int const ncid = file.ncid();
+	int status;
 	
-	return nc_cntr{dimensions, variables, attributes};
+	for(std::size_t i = 0; i < names.size(); ++i) {
+		int varid, ndims;
+		
+		status = nc_inq_varid(ncid, names[i].data(), &varid);
+		throw_if_error(ncid, status, file.path(), false);
+		
+		status = nc_inq_varndims(ncid, varid, &ndims);
+		throw_if_error(ncid, status, file.path(), false);
+		
+		if (ndims != 1) {
+			throw_if_error(ncid, NC_EDIMSIZE, file.path(), false);
+		}
+		
+		status = nc_get_vara_double(ncid, varid, &start, &count, buffers[i]);
+		throw_if_error(ncid, status, file.path(), false);
+	}
 }
 
+namespace {
+
 struct nc_type_visitor : public boost::static_visitor<std::optional<nc_type>> {
 	#define __nc_type_case(__nc_type, __type)                                                                          \
 		std::optional<nc_type>                                                                                         \
@@ -325,17 +574,13 @@ struct array_size_visitor : public boost::static_visitor<std::size_t> {
 	}
 };
 
-HBRS_THETA_UTILS_API
 void
-write_nc_cntr(
+define_nc_cntr_impl(
+	int ncid,
 	nc_cntr const& cntr,
-	std::string const& path,
-	bool overwrite
+	std::string const& path
 ) {
-	int ncid, status, ndims = 0, nvars = 0;
-	
-	status = nc_create(path.data(), overwrite ? NC_CLOBBER : NC_NOCLOBBER, &ncid);
-	throw_if_error(ncid, status, path, false);
+	int status, ndims = 0, nvars = 0;
 	
 	for(nc_dimension const& dim : cntr.dimensions()) {
 		int dimid;
@@ -394,6 +639,23 @@ write_nc_cntr(
 	
 	status = nc_enddef(ncid);
 	throw_if_error(ncid, status, path, true);
+}
+
+/* unnamed namespace */ }
+
+HBRS_THETA_UTILS_API
+void
+write_nc_cntr(
+	nc_cntr const& cntr,
+	std::string const& path,
+	bool overwrite
+) {
+	int ncid, status;
+	
+	status = nc_create(path.data(), overwrite ? NC_CLOBBER : NC_NOCLOBBER, &ncid);
+	throw_if_error(ncid, status, path, false);
+	
+	define_nc_cntr_impl(ncid, cntr, path);
 	
 	for(std::size_t i = 0; i < cntr.variables().size(); ++i) {
 		status = nc_put_var(
@@ -408,4 +670,81 @@ write_nc_cntr(
 	throw_if_error(ncid, status, path, false);
 }
 
+HBRS_THETA_UTILS_API
+void
+define_nc_cntr(
+	nc_cntr const& cntr,
+	std::string const& path,
+	bool overwrite
+) {
+	int ncid, status, old_fill_mode;
+	
+	status = nc_create(path.data(), overwrite ? NC_CLOBBER : NC_NOCLOBBER, &ncid);
+	throw_if_error(ncid, status, path, false);
+	
+	// variables will be written completely by write_nc_cntr_block() later, so prefilling them would be wasted io
+	status = nc_set_fill(ncid, NC_NOFILL, &old_fill_mode);
+	throw_if_error(ncid, status, path, true);
+	
+	define_nc_cntr_impl(ncid, cntr, path);
+	
+	status = nc_close(ncid);
+	throw_if_error(ncid, status, path, false);
+}
+
+HBRS_THETA_UTILS_API
+void
+write_nc_cntr_block(
+	nc_cntr const& cntr,
+	std::string const& path,
+	std::size_t start
+) {
+	nc_file file{path, true};
+	write_nc_cntr_block(cntr, file, start);
+	file.close();
+}
+
+HBRS_THETA_UTILS_API
+void
+write_nc_cntr_block(
+	nc_cntr const& cntr,
+	nc_file const& file,
+	std::size_t start
+) {
+	// errors must not close the file because it is owned by file
+	int const ncid = file.ncid();
+	std::string const& path = file.path();
+	int status;
+	
+	// dimensions which are written partially
+	std::vector<std::string> blocked;
+	for(nc_variable const& var : cntr.variables()) {
+		if (!var.dimensions().empty()) {
+			blocked.push_back(var.dimensions()[0].name());
+		}
+	}
+	
+	for(nc_variable const& var : cntr.variables()) {
+		int varid;
+		status = nc_inq_varid(ncid, var.name().data(), &varid);
+		throw_if_error(ncid, status, path, false);
+		
+		std::vector<std::size_t> starts, counts;
+		for(nc_dimension const& dim : var.dimensions()) {
+			bool partial = std::find(blocked.begin(), blocked.end(), dim.name()) != blocked.end();
+			starts.push_back(partial ? start : 0);
+			counts.push_back(dim.length());
+		}
+		
+		status = nc_put_vara(
+			ncid,
+			varid,
+			starts.data(),
+			counts.data(),
+			boost::apply_visitor(array_ptr_visitor(), var.data())
+		);
+		throw_if_error(ncid, status, path, false);
+	}
+}
+
 HBRS_THETA_UTILS_NAMESPACE_END
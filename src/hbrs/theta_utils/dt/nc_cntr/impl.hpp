@@ -72,6 +72,38 @@ public:
 	HBRS_THETA_UTILS_DECLARE_ATTR(attributes, std::vector<nc_attribute>)
 };
 
+/* Handle of a netCDF file which stays open until close() or destruction, so that blocks of it can be read or written
+ * one after another without opening the file again for each block.
+ */
+struct HBRS_THETA_UTILS_API nc_file {
+public:
+	nc_file(std::string path, bool writable = false);
+	
+	nc_file(nc_file const&) = delete;
+	nc_file(nc_file && other) noexcept;
+	
+	nc_file&
+	operator=(nc_file const&) = delete;
+	nc_file&
+	operator=(nc_file &&) = delete;
+	
+	/* closing a file in the destructor ignores errors, so files which have been written should be closed explicitly */
+	~nc_file();
+	
+	void
+	close();
+	
+	std::string const&
+	path() const;
+	
+	int
+	ncid() const;
+	
+private:
+	std::string path_;
+	int ncid_;
+};
+
 HBRS_THETA_UTILS_NAMESPACE_END
 
 namespace boost { namespace hana {
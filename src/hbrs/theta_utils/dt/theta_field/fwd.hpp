@@ -18,10 +18,12 @@
 #define HBRS_THETA_UTILS_DT_THETA_FIELD_FWD_HPP
 
 #include <hbrs/theta_utils/config.hpp>
+#include <hbrs/theta_utils/dt/nc_cntr/fwd.hpp>
 #include <boost/hana/fwd/core/make.hpp>
 #include <boost/hana/fwd/core/to.hpp>
 #include <boost/filesystem.hpp>
 #include <boost/optional.hpp>
+#include <memory>
 #include <tuple>
 #include <string>
 #include <vector>
@@ -37,6 +39,19 @@ struct theta_field_tag {};
 constexpr auto make_theta_field = hana::make<theta_field_tag>;
 constexpr auto to_theta_field = hana::to<theta_field_tag>;
 
+/* Global ids of the points of a domain. They do not change between time steps, hence all fields of a series share a
+ * single immutable array. A null pointer or an empty array denotes a field which is not distributed.
+ */
+typedef std::shared_ptr<std::vector<int> const> shared_global_id;
+
+/* Parses filenames of both naming schemes, returns none if file_path is not a theta field with the given prefix */
+HBRS_THETA_UTILS_API
+boost::optional<theta_field_path>
+parse_theta_field_path(
+	fs::path const& file_path,
+	std::string const& prefix
+);
+
 HBRS_THETA_UTILS_API
 std::vector<theta_field_path>
 find_theta_fields(
@@ -51,14 +66,55 @@ filter_theta_fields_by_domain_num(
 	boost::optional<int> const& domain_num
 );
 
+/* Point data is allocated with room for at least capacity values per variable, see theta_field(nc_cntr, capacity) */
 HBRS_THETA_UTILS_API
 theta_field
 read_theta_field(
 	std::string const& file_path,
 	std::vector<std::string> const& includes = {} /*regex filter*/,
+	std::vector<std::string> const& excludes = {} /*regex filter*/,
+	std::size_t capacity = 0
+);
+
+/* Reads count points beginning at point start, see read_nc_cntr_block() */
+HBRS_THETA_UTILS_API
+theta_field
+read_theta_field_block(
+	std::string const& file_path,
+	std::size_t start,
+	std::size_t count,
+	std::vector<std::string> const& includes = {} /*regex filter*/,
 	std::vector<std::string> const& excludes = {} /*regex filter*/
 );
 
+HBRS_THETA_UTILS_API
+std::size_t
+read_theta_field_size(std::string const& file_path);
+
+/* Reads x-, y- and z-velocities of a field with no_of_points points straight into data, one after another like a
+ * column of a theta_field_matrix, e.g. into a column of the local matrix of a distributed data matrix
+ */
+HBRS_THETA_UTILS_API
+void
+read_theta_velocities(
+	std::string const& file_path,
+	double * data,
+	std::size_t no_of_points
+);
+
+/* Like read_theta_velocities() but reads points [start, start+count) of a file which is kept open, so that a series
+ * can be read block by block without reopening its files for each block. Velocities are stored like a column of a
+ * theta_field_matrix with count points.
+ */
+HBRS_THETA_UTILS_API
+void
+read_theta_velocities_block(
+	nc_file const& file,
+	double * data,
+	std::size_t start,
+	std::size_t count
+);
+
 HBRS_THETA_UTILS_API
 std::vector<theta_field>
 read_theta_fields(
@@ -67,19 +123,77 @@ read_theta_fields(
 	std::vector<std::string> const& excludes = {} /*regex filter*/
 );
 
+/* Like read_theta_fields() but reads variables matching series_includes, e.g. global_id which does not change between
+ * time steps, from the first file only and returns them separately. Each file is opened just once.
+ */
+HBRS_THETA_UTILS_API
+std::tuple<std::vector<theta_field>, boost::optional<theta_field>>
+read_theta_series(
+	std::vector<theta_field_path> const& paths,
+	std::vector<std::string> const& includes /*regex filter*/,
+	std::vector<std::string> const& series_includes /*regex filter*/
+);
+
+/* Returns path of the topology file of a domain, i.e. <folder>/<prefix>.topology[.domain_<domain_num>], which holds
+ * the global ids of its points once for all time steps of a series.
+ */
+HBRS_THETA_UTILS_API
+fs::path
+make_theta_topology_path(
+	fs::path const& folder,
+	std::string const& prefix,
+	boost::optional<int> const& domain_num
+);
+
+/* If topology is given, then global_id of field is not written. Instead the file references topology, a filename
+ * relative to the folder of file_path, from which read_theta_field() and friends will load global_id.
+ */
 HBRS_THETA_UTILS_API
 void
 write_theta_field(
 	theta_field field,
 	std::string const& file_path,
-	bool overwrite = false
+	bool overwrite = false,
+	boost::optional<std::string> const& topology = boost::none
+);
+
+/* Creates a file for a theta field with no_of_points points without writing any data. Variables and attributes are
+ * taken from the non-empty variables of prototype, e.g. the first block which will be written by
+ * write_theta_field_block(). See write_theta_field() for topology.
+ */
+HBRS_THETA_UTILS_API
+void
+define_theta_field(
+	theta_field const& prototype,
+	std::size_t no_of_points,
+	std::string const& file_path,
+	bool overwrite = false,
+	boost::optional<std::string> const& topology = boost::none
+);
+
+HBRS_THETA_UTILS_API
+void
+write_theta_field_block(
+	theta_field block,
+	std::string const& file_path,
+	std::size_t start
+);
+
+/* Like write_theta_field_block() above but writes to a file which has been opened for writing and is kept open */
+HBRS_THETA_UTILS_API
+void
+write_theta_field_block(
+	theta_field block,
+	nc_file const& file,
+	std::size_t start
 );
 
 HBRS_THETA_UTILS_API
 void
 write_theta_fields(
 	std::vector< std::tuple<theta_field, theta_field_path> > fields,
-	bool overwrite = false
+	bool overwrite = false,
+	boost::optional<std::string> const& topology = boost::none
 );
 
 HBRS_THETA_UTILS_NAMESPACE_END
@@ -31,14 +31,18 @@
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
 #include <boost/system/error_code.hpp>
+#include <boost/exception/errinfo_file_name.hpp>
 #include <boost/hana/fold.hpp>
 #include <boost/hana/tuple.hpp>
 #include <boost/hana/pair.hpp>
 #include <boost/hana/first.hpp>
 #include <boost/hana/second.hpp>
 #include <mpi.h>
+#include <algorithm>
 #include <iterator>
 #include <sstream>
+#include <regex>
+#include <map>
 
 HBRS_THETA_UTILS_NAMESPACE_BEGIN
 namespace ba = boost::algorithm;
@@ -127,7 +131,7 @@ theta_field::theta_field(
 	std::vector<double> z_velocity,
 	std::vector<double> pressure,
 	std::vector<double> residual,
-	std::vector<int> global_id,
+	shared_global_id global_id,
 	boost::optional<int> ndomains
 ) : density_{density},
 	x_velocity_{x_velocity},
@@ -162,7 +166,7 @@ operator!=(std::vector<nc_dimension> const& dims, std::vector<std::string> const
 
 /* unnamed namespace */ }
 
-theta_field::theta_field(nc_cntr cntr) {
+theta_field::theta_field(nc_cntr cntr, std::size_t capacity) {
 	#define __get(__name, __type)                                                                                      \
 		{                                                                                                              \
 			auto opt = cntr.variable(#__name);                                                                         \
@@ -170,7 +174,9 @@ theta_field::theta_field(nc_cntr cntr) {
 				if (opt->dimensions() != std::vector<std::string>{"no_of_points"}) {                                   \
 					BOOST_THROW_EXCEPTION(unsupported_format_exception{});                                             \
 				}                                                                                                      \
-				__name ## _ = boost::get< std::vector<__type> >( opt->data() );                                        \
+				auto const& data = boost::get< std::vector<__type> >( opt->data() );                                   \
+				__name ## _.reserve(std::max(capacity, data.size()));                                                  \
+				__name ## _.assign(data.begin(), data.end());                                                          \
 			}                                                                                                          \
 		}
 	
@@ -180,10 +186,20 @@ theta_field::theta_field(nc_cntr cntr) {
 	__get(z_velocity, double)
 	__get(pressure, double)
 	__get(residual, double)
-	__get(global_id, int)
 	
 	#undef __get
 	
+	{
+		auto opt = cntr.variable("global_id");
+		if (opt) {
+			if (opt->dimensions() != std::vector<std::string>{"no_of_points"}) {
+				BOOST_THROW_EXCEPTION(unsupported_format_exception{});
+			}
+			global_id_ = std::make_shared<std::vector<int>>(
+				boost::get< std::vector<int> >( std::move(opt->data()) ));
+		}
+	}
+	
 	{
 		auto opt = cntr.attribute("ndomains");
 		if (opt) {
@@ -200,28 +216,184 @@ HBRS_THETA_UTILS_DEFINE_ATTR(y_velocity, std::vector<double>, theta_field)
 HBRS_THETA_UTILS_DEFINE_ATTR(z_velocity, std::vector<double>, theta_field)
 HBRS_THETA_UTILS_DEFINE_ATTR(pressure, std::vector<double>, theta_field)
 HBRS_THETA_UTILS_DEFINE_ATTR(residual, std::vector<double>, theta_field)
-HBRS_THETA_UTILS_DEFINE_ATTR(global_id, std::vector<int>, theta_field)
+HBRS_THETA_UTILS_DEFINE_ATTR(global_id, shared_global_id, theta_field)
 HBRS_THETA_UTILS_DEFINE_ATTR(ndomains, boost::optional<int>, theta_field)
 
+namespace {
+
+/* maps paths of topology files to their global ids, so that all fields referencing a topology file share them */
+typedef std::map<fs::path, shared_global_id> topology_cache;
+
+/* Returns filename of the topology file referenced by cntr, see write_theta_field() */
+boost::optional<std::string>
+get_topology(nc_cntr const& cntr) {
+	auto opt = cntr.attribute("topology");
+	if (!opt) {
+		return boost::none;
+	}
+	
+	if (opt->value().type() != typeid(std::vector<char>)) {
+		BOOST_THROW_EXCEPTION(unsupported_format_exception{});
+	}
+	auto const& topology = boost::get<std::vector<char>>(opt->value());
+	return std::string{topology.begin(), std::find(topology.begin(), topology.end(), '\0')};
+}
+
+bool
+is_selected(
+	std::string const& name,
+	std::vector<std::string> const& includes /*regex filter*/,
+	std::vector<std::string> const& excludes /*regex filter*/
+) {
+	auto const matches = [&name](std::string const& filter) { return std::regex_search(name, std::regex{filter}); };
+	return (includes.empty() || std::any_of(includes.begin(), includes.end(), matches))
+		&& std::none_of(excludes.begin(), excludes.end(), matches);
+}
+
+/* Resolves global_id from the topology file referenced by cntr if it has been selected but is not stored in cntr */
+theta_field
+make_theta_field(
+	nc_cntr cntr,
+	std::string const& file_path,
+	std::vector<std::string> const& includes /*regex filter*/,
+	std::vector<std::string> const& excludes /*regex filter*/,
+	topology_cache & cache,
+	std::size_t capacity = 0
+) {
+	boost::optional<std::string> topology = get_topology(cntr);
+	theta_field field{std::move(cntr), capacity};
+	
+	if (!topology || field.global_id() || !is_selected("global_id", includes, excludes)) {
+		return field;
+	}
+	
+	fs::path topology_path = fs::path{file_path}.parent_path() / *topology;
+	auto it = cache.find(topology_path);
+	if (it == cache.end()) {
+		theta_field topology_field{ read_nc_cntr(topology_path.string(), {"global_id"}) };
+		if (!topology_field.global_id()) {
+			BOOST_THROW_EXCEPTION(unsupported_format_exception{} << boost::errinfo_file_name(topology_path.string()));
+		}
+		it = cache.emplace(topology_path, topology_field.global_id()).first;
+	}
+	
+	field.global_id() = it->second;
+	return field;
+}
+
+std::vector<std::string>
+default_includes() {
+	// only include currently supported:
+	return { "density", ".*_velocity", "pressure", "residual", /*".*_old",*/ "global_id" };
+}
+
+theta_field
+read_theta_field(
+	std::string const& file_path,
+	std::vector<std::string> const& includes /*regex filter*/,
+	std::vector<std::string> const& excludes /*regex filter*/,
+	topology_cache & cache,
+	std::size_t capacity = 0
+) {
+	if (includes.empty() && excludes.empty()) {
+		std::vector<std::string> const includes_ = default_includes();
+		return make_theta_field(read_nc_cntr(file_path, includes_), file_path, includes_, {}, cache, capacity);
+	} else {
+		return make_theta_field(
+			read_nc_cntr(file_path, includes, excludes), file_path, includes, excludes, cache, capacity);
+	}
+}
+
+/* unnamed namespace */ }
+
 HBRS_THETA_UTILS_API
 theta_field
 read_theta_field(
 	std::string const& file_path,
 	std::vector<std::string> const& includes,
+	std::vector<std::string> const& excludes,
+	std::size_t capacity
+) {
+	topology_cache cache;
+	return read_theta_field(file_path, includes, excludes, cache, capacity);
+}
+
+HBRS_THETA_UTILS_API
+theta_field
+read_theta_field_block(
+	std::string const& file_path,
+	std::size_t start,
+	std::size_t count,
+	std::vector<std::string> const& includes,
 	std::vector<std::string> const& excludes
 ) {
-	if (includes.empty() && excludes.empty()) {
-		// only include currently supported:
-		return { read_nc_cntr(file_path, { "density", ".*_velocity", "pressure", "residual", /*".*_old",*/ "global_id" }) };
-	} else {
-		return { read_nc_cntr(file_path, includes, excludes) };
+	std::vector<std::string> const& includes_ = includes.empty() && excludes.empty() ? default_includes() : includes;
+	nc_cntr cntr = read_nc_cntr_block(file_path, start, count, includes_, excludes);
+	
+	boost::optional<std::string> topology = get_topology(cntr);
+	theta_field field{std::move(cntr)};
+	
+	if (topology && !field.global_id() && is_selected("global_id", includes_, excludes)) {
+		fs::path topology_path = fs::path{file_path}.parent_path() / *topology;
+		field.global_id() = theta_field{
+			read_nc_cntr_block(topology_path.string(), start, count, {"global_id"})
+		}.global_id();
+	}
+	
+	return field;
+}
+
+HBRS_THETA_UTILS_API
+std::size_t
+read_theta_field_size(std::string const& file_path) {
+	std::vector<nc_dimension> dims = read_nc_dimensions(file_path);
+	auto dim_it = std::find_if(
+		dims.begin(),
+		dims.end(),
+		[](auto const& dim) { return dim.name() == "no_of_points"; }
+	);
+	if (dim_it == dims.end()) {
+		BOOST_THROW_EXCEPTION(unsupported_format_exception{} << boost::errinfo_file_name(file_path));
 	}
+	return dim_it->length();
+}
+
+HBRS_THETA_UTILS_API
+void
+read_theta_velocities(
+	std::string const& file_path,
+	double * data,
+	std::size_t no_of_points
+) {
+	read_nc_variables(
+		file_path,
+		{ "x_velocity", "y_velocity", "z_velocity" },
+		{ data, data + no_of_points, data + 2 * no_of_points },
+		no_of_points
+	);
+}
+
+HBRS_THETA_UTILS_API
+void
+read_theta_velocities_block(
+	nc_file const& file,
+	double * data,
+	std::size_t start,
+	std::size_t count
+) {
+	read_nc_variables_block(
+		file,
+		{ "x_velocity", "y_velocity", "z_velocity" },
+		{ data, data + count, data + 2 * count },
+		start,
+		count
+	);
 }
 
 namespace {
 
 boost::optional<theta_field_path>
-parse_theta_field_path(fs::path file_path, std::string const& input_prefix) {
+parse_theta_scheme_path(fs::path file_path, std::string const& input_prefix) {
 	namespace qi = boost::spirit::qi;
 	namespace spirit = boost::spirit;
 	namespace phoenix = boost::phoenix;
@@ -272,7 +444,7 @@ parse_theta_field_path(fs::path file_path, std::string const& input_prefix) {
 }
 
 boost::optional<theta_field_path>
-parse_tau_field_path(fs::path file_path, std::string const& input_prefix) {
+parse_tau_scheme_path(fs::path file_path, std::string const& input_prefix) {
 	namespace qi = boost::spirit::qi;
 	namespace spirit = boost::spirit;
 	namespace phoenix = boost::phoenix;
@@ -323,6 +495,21 @@ parse_tau_field_path(fs::path file_path, std::string const& input_prefix) {
 
 /* unnamed namespace */ }
 
+HBRS_THETA_UTILS_API
+boost::optional<theta_field_path>
+parse_theta_field_path(
+	fs::path const& file_path,
+	std::string const& prefix
+) {
+	auto field_path = parse_theta_scheme_path(file_path, prefix);
+	
+	if (!field_path) {
+		field_path = parse_tau_scheme_path(file_path, prefix);
+	}
+	
+	return field_path;
+}
+
 HBRS_THETA_UTILS_API
 std::vector<theta_field_path>
 find_theta_fields(
@@ -335,11 +522,6 @@ find_theta_fields(
 	std::vector<theta_field_path> field_files;
 	for(auto && path : all_files) {
 		auto field_path = parse_theta_field_path(path, prefix);
-		
-		if (!field_path) {
-			field_path = parse_tau_field_path(path, prefix);
-		}
-		
 		if (!field_path) {
 			continue;
 		}
@@ -413,26 +595,59 @@ read_theta_fields(
 	std::vector<theta_field> fields;
 	fields.reserve(paths.size());
 	
+	topology_cache cache;
 	for(auto && path : paths) {
 		fields.push_back(
-			read_theta_field(path.full_path().string(), includes, excludes)
+			read_theta_field(path.full_path().string(), includes, excludes, cache)
 		);
 	}
 	
 	return fields;
 }
 
+HBRS_THETA_UTILS_API
+std::tuple<std::vector<theta_field>, boost::optional<theta_field>>
+read_theta_series(
+	std::vector<theta_field_path> const& paths,
+	std::vector<std::string> const& includes,
+	std::vector<std::string> const& series_includes
+) {
+	std::vector<theta_field> fields;
+	boost::optional<theta_field> series;
+	fields.reserve(paths.size());
+	
+	topology_cache cache;
+	for(auto && path : paths) {
+		std::string const file_path = path.full_path().string();
+		if (series) {
+			fields.push_back(make_theta_field(read_nc_cntr(file_path, includes), file_path, includes, {}, cache));
+		} else {
+			auto cntrs = read_nc_cntr_groups(file_path, { includes, series_includes });
+			fields.push_back(make_theta_field(std::move(cntrs.at(0)), file_path, includes, {}, cache));
+			series = make_theta_field(std::move(cntrs.at(1)), file_path, series_includes, {}, cache);
+		}
+	}
+	
+	return { fields, series };
+}
+
 namespace {
 
 nc_cntr
-gen_nc_cntr(theta_field field) {
+gen_nc_cntr(theta_field field, boost::optional<std::string> const& topology) {
 	std::vector<nc_dimension> dims;
 	std::vector<nc_variable> vars;
 	std::vector<nc_attribute> atts;
 	
-	#define __add(__name)                                                                                              \
+	// global_id is shared among time steps, so it has to be copied
+	std::vector<int> global_id;
+	if (field.global_id() && !topology) {
+		global_id = *field.global_id();
+	}
+	
+	#define __add(__name, __vec)                                                                                       \
 		{                                                                                                              \
-			auto vec = std::move(field.__name());                                                                      \
+			auto vec = std::move(__vec);                                                                               \
 			if (!vec.empty()) {                                                                                        \
 				auto dim_it = std::find_if(                                                                            \
 					dims.begin(),                                                                                      \
@@ -452,13 +667,13 @@ gen_nc_cntr(theta_field field) {
 			}                                                                                                          \
 		}
 	
-	__add(density)
-	__add(x_velocity)
-	__add(y_velocity)
-	__add(z_velocity)
-	__add(pressure)
-	__add(residual)
-	__add(global_id)
+	__add(density, field.density())
+	__add(x_velocity, field.x_velocity())
+	__add(y_velocity, field.y_velocity())
+	__add(z_velocity, field.z_velocity())
+	__add(pressure, field.pressure())
+	__add(residual, field.residual())
+	__add(global_id, global_id)
 	
 	#undef __add
 	
@@ -469,6 +684,13 @@ gen_nc_cntr(theta_field field) {
 				std::vector<int>{ *field.ndomains() }
 			});
 		}
+		
+		if (topology) {
+			atts.push_back({
+				"topology",
+				std::vector<char>(topology->begin(), topology->end())
+			});
+		}
 	}
 	
 	return {dims, vars, atts};
@@ -476,26 +698,90 @@ gen_nc_cntr(theta_field field) {
 
 /* unnamed namespace */ }
 
+HBRS_THETA_UTILS_API
+fs::path
+make_theta_topology_path(
+	fs::path const& folder,
+	std::string const& prefix,
+	boost::optional<int> const& domain_num
+) {
+	return 
+		folder / 
+			(prefix + ".topology" + 
+				(domain_num ? std::string{".domain_"} + boost::lexical_cast<std::string>(*domain_num) : "") 
+			);
+}
+
 HBRS_THETA_UTILS_API
 void
 write_theta_field(
 	theta_field field,
 	std::string const& file_path,
-	bool overwrite
+	bool overwrite,
+	boost::optional<std::string> const& topology
+) {
+	write_nc_cntr(gen_nc_cntr(std::move(field), topology), file_path, overwrite);
+}
+
+HBRS_THETA_UTILS_API
+void
+define_theta_field(
+	theta_field const& prototype,
+	std::size_t no_of_points,
+	std::string const& file_path,
+	bool overwrite,
+	boost::optional<std::string> const& topology
+) {
+	nc_cntr cntr = gen_nc_cntr(prototype, topology);
+	
+	nc_dimension const points{"no_of_points", no_of_points};
+	for(nc_dimension & dim : cntr.dimensions()) {
+		if (dim.name() == points.name()) {
+			dim = points;
+		}
+	}
+	for(nc_variable & var : cntr.variables()) {
+		for(nc_dimension & dim : var.dimensions()) {
+			if (dim.name() == points.name()) {
+				dim = points;
+			}
+		}
+	}
+	
+	define_nc_cntr(cntr, file_path, overwrite);
+}
+
+HBRS_THETA_UTILS_API
+void
+write_theta_field_block(
+	theta_field block,
+	std::string const& file_path,
+	std::size_t start
+) {
+	write_nc_cntr_block(gen_nc_cntr(std::move(block), boost::none), file_path, start);
+}
+
+HBRS_THETA_UTILS_API
+void
+write_theta_field_block(
+	theta_field block,
+	nc_file const& file,
+	std::size_t start
 ) {
-	write_nc_cntr(gen_nc_cntr(std::move(field)), file_path, overwrite);
+	write_nc_cntr_block(gen_nc_cntr(std::move(block), boost::none), file, start);
 }
 
 HBRS_THETA_UTILS_API
 void
 write_theta_fields(
 	std::vector< std::tuple<theta_field, theta_field_path> > fields,
-	bool overwrite
+	bool overwrite,
+	boost::optional<std::string> const& topology
 ) {
 	for(auto & pack : fields) {
 		auto & [field, path] = pack;
 		auto file_path = (path.folder() / path.filename()).string();
-		write_theta_field(std::move(field), file_path, overwrite);
+		write_theta_field(std::move(field), file_path, overwrite, topology);
 	}
 }
 
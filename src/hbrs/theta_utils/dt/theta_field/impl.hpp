@@ -98,11 +98,13 @@ public:
 		std::vector<double> z_velocity,
 		std::vector<double> pressure,
 		std::vector<double> residual,
-		std::vector<int> global_id,
+		shared_global_id global_id,
 		boost::optional<int> ndomains
 	);
 	
-	theta_field(nc_cntr cntr);
+	/* Point data is allocated with room for at least capacity values per variable, so values can be appended later
+	 * without reallocation, e.g. those of boundary points, see make_vtk_unstructured_grid() */
+	theta_field(nc_cntr cntr, std::size_t capacity = 0);
 	
 	theta_field(theta_field const&) = default;
 	theta_field(theta_field &&) = default;
@@ -118,7 +120,7 @@ public:
 	HBRS_THETA_UTILS_DECLARE_ATTR(z_velocity, std::vector<double>)
 	HBRS_THETA_UTILS_DECLARE_ATTR(pressure, std::vector<double>)
 	HBRS_THETA_UTILS_DECLARE_ATTR(residual, std::vector<double>)
-	HBRS_THETA_UTILS_DECLARE_ATTR(global_id, std::vector<int>)
+	HBRS_THETA_UTILS_DECLARE_ATTR(global_id, shared_global_id)
 	HBRS_THETA_UTILS_DECLARE_ATTR(ndomains, boost::optional<int>)
 };
 
@@ -26,8 +26,11 @@
 #include <hbrs/theta_utils/dt/theta_field.hpp>
 
 #include <array>
+#include <memory>
+#include <numeric>
 
 namespace utf = boost::unit_test;
+namespace tt = boost::test_tools;
 using namespace hbrs::theta_utils;
 
 namespace {
@@ -183,6 +186,91 @@ BOOST_AUTO_TEST_CASE(read, * utf::precondition(detail::mpi_world_size_condition{
 }
 
 
+BOOST_AUTO_TEST_CASE(read_series, * utf::precondition(detail::mpi_world_size_condition{{0,4}}) ) {
+	detail::io_fixture fx{"read_series"};
+	BOOST_TEST_MESSAGE("Working directory: " << fx.wd().path().string());
+	
+	auto paths = detail::make_theta_field_paths(
+		fx.wd().path(), fx.prefix(), fields0, theta_field_path::naming_scheme::theta
+	);
+	
+	std::vector< std::tuple<theta_field, theta_field_path> > fields;
+	fields.reserve(paths.size());
+	for(std::size_t j = 0; j < paths.size(); ++j) {
+		fields.push_back({fields0.data().at(j), paths.at(j)});
+	}
+	write_theta_fields(fields, false);
+	
+	auto [got, series] = read_theta_series(paths, {".*_velocity"}, {"global_id"});
+	BOOST_TEST_REQUIRE(got.size() == paths.size());
+	BOOST_TEST_REQUIRE(series.has_value());
+	BOOST_TEST(!series->global_id() == !fields0.data().at(0).global_id());
+	BOOST_TEST(series->x_velocity().empty());
+	
+	for(std::size_t j = 0; j < paths.size(); ++j) {
+		theta_field const& ref = fields0.data().at(j);
+		BOOST_TEST(got.at(j).x_velocity() == ref.x_velocity(), tt::per_element());
+		BOOST_TEST(got.at(j).y_velocity() == ref.y_velocity(), tt::per_element());
+		BOOST_TEST(got.at(j).z_velocity() == ref.z_velocity(), tt::per_element());
+		BOOST_TEST(!got.at(j).global_id());
+	}
+}
+
+BOOST_AUTO_TEST_CASE(write_read_topology, * utf::precondition(detail::mpi_world_size_condition{{0,4}}) ) {
+	detail::io_fixture fx{"write_read_topology"};
+	BOOST_TEST_MESSAGE("Working directory: " << fx.wd().path().string());
+	
+	auto paths = detail::make_theta_field_paths(
+		fx.wd().path(), fx.prefix(), fields0, theta_field_path::naming_scheme::theta
+	);
+	
+	std::size_t const no_of_points = fields0.size().m()/3;
+	std::vector<int> ref_global_id(no_of_points);
+	std::iota(ref_global_id.begin(), ref_global_id.end(), 10);
+	auto const global_id = std::make_shared<std::vector<int>>(ref_global_id);
+	
+	fs::path const topology_path = make_theta_topology_path(fx.wd().path(), fx.prefix(), paths.at(0).domain_num());
+	write_theta_field(
+		theta_field{ {}, {}, {}, {}, {}, {}, global_id, fields0.data().at(0).ndomains() },
+		topology_path.string()
+	);
+	
+	std::vector< std::tuple<theta_field, theta_field_path> > fields;
+	fields.reserve(paths.size());
+	for(std::size_t j = 0; j < paths.size(); ++j) {
+		theta_field field = fields0.data().at(j);
+		field.global_id() = global_id;
+		fields.push_back({field, paths.at(j)});
+	}
+	write_theta_fields(fields, false, topology_path.filename().string());
+	
+	// time steps reference the topology file instead of storing global_id themselves
+	nc_cntr const first = read_nc_cntr(paths.at(0).full_path().string());
+	BOOST_TEST(!first.variable("global_id"));
+	BOOST_TEST(first.attribute("topology").has_value());
+	
+	auto got = read_theta_fields(paths);
+	BOOST_TEST_REQUIRE(got.size() == paths.size());
+	for(std::size_t j = 0; j < paths.size(); ++j) {
+		BOOST_TEST_REQUIRE(got.at(j).global_id());
+		BOOST_TEST(*got.at(j).global_id() == ref_global_id, tt::per_element());
+		// all time steps share a single array
+		BOOST_TEST(got.at(j).global_id() == got.at(0).global_id());
+		BOOST_TEST(got.at(j).x_velocity() == fields0.data().at(j).x_velocity(), tt::per_element());
+	}
+	
+	auto [velocities, series] = read_theta_series(paths, {".*_velocity"}, {"global_id"});
+	BOOST_TEST_REQUIRE(series.has_value());
+	BOOST_TEST_REQUIRE(series->global_id());
+	BOOST_TEST(*series->global_id() == ref_global_id, tt::per_element());
+	BOOST_TEST(!velocities.at(0).global_id());
+	
+	// last block is truncated
+	theta_field block = read_theta_field_block(paths.at(0).full_path().string(), no_of_points-1, 2, {"global_id"});
+	BOOST_TEST_REQUIRE(block.global_id());
+	BOOST_TEST(*block.global_id() == std::vector<int>{ref_global_id.back()}, tt::per_element());
+}
+
 BOOST_AUTO_TEST_CASE(write, * utf::precondition(detail::mpi_world_size_condition{{0,4}}) ) {
 	for(auto scheme: { theta_field_path::naming_scheme::theta, theta_field_path::naming_scheme::tau_unsteady }) {
 		detail::io_fixture fx{"write"};
@@ -220,4 +308,74 @@ BOOST_AUTO_TEST_CASE(write, * utf::precondition(detail::mpi_world_size_condition
 	}
 }
 
+BOOST_AUTO_TEST_CASE(write_read_block, * utf::precondition(detail::mpi_world_size_condition{{0,4}}) ) {
+	for(auto scheme: { theta_field_path::naming_scheme::theta, theta_field_path::naming_scheme::tau_unsteady }) {
+		detail::io_fixture fx{"write_read_block"};
+		BOOST_TEST_MESSAGE("Working directory: " << fx.wd().path().string());
+		
+		auto paths = detail::make_theta_field_paths(
+			fx.wd().path(), fx.prefix(), fields0, scheme
+		);
+		
+		std::size_t const no_of_points = fields0.size().m()/3;
+		
+		// write test data point by point
+		for(std::size_t j = 0; j < paths.size(); ++j) {
+			theta_field const& field = fields0.data().at(j);
+			auto file_path = paths.at(j).full_path().string();
+			
+			for(std::size_t i = 0; i < no_of_points; ++i) {
+				theta_field block{
+					{},
+					{ field.x_velocity().at(i) },
+					{ field.y_velocity().at(i) },
+					{ field.z_velocity().at(i) },
+					{}, {}, {}, field.ndomains()
+				};
+				
+				if (i == 0) {
+					define_theta_field(block, no_of_points, file_path, false);
+				}
+				write_theta_field_block(block, file_path, i);
+			}
+		}
+		
+		//compare to reference data
+		for(std::size_t j = 0; j < paths.size(); ++j) {
+			BOOST_TEST_MESSAGE("timestep := " << j);
+			auto file_path = paths.at(j).full_path().string();
+			
+			std::ifstream got_ifs{file_path, std::ios::binary};
+			got_ifs >> std::noskipws;
+			std::istream_iterator<unsigned char> got_begin{got_ifs}, got_end;
+			BOOST_CHECK_EQUAL_COLLECTIONS(
+				std::get<0>(fields0_bytes.at(j)), std::get<1>(fields0_bytes.at(j)), got_begin, got_end);
+			
+			BOOST_TEST(read_theta_field_size(file_path) == no_of_points);
+			
+			// read test data point by point, last block is truncated
+			theta_field const& ref = fields0.data().at(j);
+			for(std::size_t i = 0; i < no_of_points; ++i) {
+				theta_field got = read_theta_field_block(file_path, i, 2);
+				BOOST_TEST(got.x_velocity().size() == std::min<std::size_t>(2, no_of_points - i));
+				BOOST_TEST(got.x_velocity().at(0) == ref.x_velocity().at(i));
+				BOOST_TEST(got.y_velocity().at(0) == ref.y_velocity().at(i));
+				BOOST_TEST(got.z_velocity().at(0) == ref.z_velocity().at(i));
+			}
+			
+			// read velocities in blocks of two points from a file which is kept open
+			nc_file file{file_path};
+			for(std::size_t i = 0; i + 2 <= no_of_points; i += 2) {
+				std::vector<double> got(6);
+				read_theta_velocities_block(file, got.data(), i, 2);
+				for(std::size_t k = 0; k < 2; ++k) {
+					BOOST_TEST(got.at(k) == ref.x_velocity().at(i+k));
+					BOOST_TEST(got.at(2+k) == ref.y_velocity().at(i+k));
+					BOOST_TEST(got.at(4+k) == ref.z_velocity().at(i+k));
+				}
+			}
+		}
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -23,6 +23,7 @@
 #include <boost/filesystem.hpp>
 #include <boost/optional.hpp>
 #include <string>
+#include <vector>
 
 HBRS_THETA_UTILS_NAMESPACE_BEGIN
 namespace hana = boost::hana;
@@ -46,6 +47,18 @@ HBRS_THETA_UTILS_API
 theta_grid
 read_theta_grid(theta_grid_path const& path);
 
+/* Reads only those parts of the grid which are required for the points with the given global ids, i.e. all cells which
+ * contain at least one of these points and all points of these cells. Cells keep referring to global ids of points.
+ * Variables are read in chunks of at most chunk_rows rows, which bounds the memory required for reading.
+ */
+HBRS_THETA_UTILS_API
+theta_grid
+read_theta_grid(
+	theta_grid_path const& path,
+	std::vector<int> const& global_ids,
+	std::size_t chunk_rows = std::size_t{1} << 20
+);
+
 HBRS_THETA_UTILS_NAMESPACE_END
 
 #endif // !HBRS_THETA_UTILS_DT_THETA_GRID_FWD_HPP
@@ -17,9 +17,15 @@
 #include "impl.hpp"
 
 #include <hbrs/theta_utils/dt/exception.hpp>
+#include <hbrs/theta_utils/dt/nc_exception.hpp>
 #include <boost/numeric/conversion/cast.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/exception/errinfo_file_name.hpp>
+#include <boost/assert.hpp>
 #include <netcdf.h>
+#include <algorithm>
 #include <stdexcept>
+#include <type_traits>
 
 HBRS_THETA_UTILS_NAMESPACE_BEGIN
 
@@ -77,9 +83,55 @@ theta_grid::theta_grid(
 	points_of_surfacequadrilaterals_{points_of_surfacequadrilaterals},
 	boundarymarker_of_surfaces_{boundarymarker_of_surfaces},
 	
-	points_{points}
+	points_{points},
+	point_ids_{},
+	no_of_points_{boost::numeric_cast<int>(points_.size())}
 	{}
 
+theta_grid::theta_grid(
+	boost::optional<int> points_per_tetraeder,
+	boost::optional<int> points_per_prism,
+	boost::optional<int> points_per_hexaeder,
+	boost::optional<int> points_per_pyramid,
+	boost::optional<int> points_per_surfacetriangle,
+	boost::optional<int> points_per_surfacequadrilateral,
+	
+	std::vector<tetraeder> points_of_tetraeders,
+	std::vector<prism> points_of_prisms,
+	std::vector<hexaeder> points_of_hexaeders,
+	std::vector<pyramid> points_of_pyramids,
+	std::vector<surfacetriangle> points_of_surfacetriangles,
+	std::vector<surfacequadrilateral> points_of_surfacequadrilaterals,
+	std::vector<int> boundarymarker_of_surfaces,
+	
+	std::vector<point> points,
+	std::vector<int> point_ids,
+	int no_of_points
+) :
+	points_per_tetraeder_{points_per_tetraeder},
+	points_per_prism_{points_per_prism},
+	points_per_hexaeder_{points_per_hexaeder},
+	points_per_pyramid_{points_per_pyramid},
+	points_per_surfacetriangle_{points_per_surfacetriangle},
+	points_per_surfacequadrilateral_{points_per_surfacequadrilateral},
+
+	points_of_tetraeders_{points_of_tetraeders},
+	points_of_prisms_{points_of_prisms},
+	points_of_hexaeders_{points_of_hexaeders},
+	points_of_pyramids_{points_of_pyramids},
+	points_of_surfacetriangles_{points_of_surfacetriangles},
+	points_of_surfacequadrilaterals_{points_of_surfacequadrilaterals},
+	boundarymarker_of_surfaces_{boundarymarker_of_surfaces},
+	
+	points_{points},
+	point_ids_{point_ids},
+	no_of_points_{no_of_points}
+	{
+	if (point_ids_.size() != points_.size() || !std::is_sorted(point_ids_.begin(), point_ids_.end())) {
+		BOOST_THROW_EXCEPTION(invalid_grid_exception{});
+	}
+}
+
 theta_grid::theta_grid(nc_cntr cntr) {
 #define __check(x)                                                                                                     \
 	if (!(x)) { BOOST_THROW_EXCEPTION(invalid_grid_exception{}); }
@@ -175,6 +227,7 @@ theta_grid::theta_grid(nc_cntr cntr) {
 	__check(no_of_surfaceelements == (no_of_surfacetriangles + no_of_surfacequadrilaterals));
 	__check(no_of_elements == (no_of_tetraeders + no_of_prisms + no_of_hexaeders + no_of_pyramids));
 	__check(points_.size() == (unsigned)no_of_points);
+	no_of_points_ = no_of_points;
 }
 
 HBRS_THETA_UTILS_DEFINE_ATTR(points_per_tetraeder, boost::optional<int>, theta_grid)
@@ -191,8 +244,9 @@ HBRS_THETA_UTILS_DEFINE_ATTR(points_of_surfacetriangles, std::vector<theta_grid:
 HBRS_THETA_UTILS_DEFINE_ATTR(points_of_surfacequadrilaterals, std::vector<theta_grid::surfacequadrilateral>, theta_grid)
 HBRS_THETA_UTILS_DEFINE_ATTR(boundarymarker_of_surfaces, std::vector<int>, theta_grid)
 HBRS_THETA_UTILS_DEFINE_ATTR(points, std::vector<theta_grid::point>, theta_grid)
+HBRS_THETA_UTILS_DEFINE_ATTR(point_ids, std::vector<int>, theta_grid)
 
-int theta_grid::no_of_points() const { return points_.size(); }
+int theta_grid::no_of_points() const { return no_of_points_; }
 int theta_grid::no_of_tetraeders() const { return points_of_tetraeders_.size(); }
 int theta_grid::no_of_prisms() const { return points_of_prisms_.size(); }
 int theta_grid::no_of_hexaeders() const { return points_of_hexaeders_.size(); }
@@ -209,6 +263,20 @@ int theta_grid::no_of_surfaceelements() const {
 	return points_of_surfacetriangles_.size() + points_of_surfacequadrilaterals_.size(); 
 }
 
+theta_grid::point const&
+theta_grid::point_of(int global_id) const {
+	if (point_ids_.empty()) {
+		BOOST_ASSERT(global_id >= 0 && (std::size_t)global_id < points_.size());
+		return points_[global_id];
+	}
+	
+	auto it = std::lower_bound(point_ids_.begin(), point_ids_.end(), global_id);
+	if (it == point_ids_.end() || *it != global_id) {
+		BOOST_THROW_EXCEPTION(std::out_of_range{"point has not been read from grid"});
+	}
+	return points_[std::distance(point_ids_.begin(), it)];
+}
+
 HBRS_THETA_UTILS_API
 boost::optional<theta_grid_path>
 find_theta_grid(
@@ -229,4 +297,242 @@ read_theta_grid(theta_grid_path const& path) {
 	return { read_nc_cntr(path.full_path().string()) };
 }
 
+namespace {
+
+void
+throw_if_error(int status, std::string const& path) {
+	if(status != NC_NOERR) {
+		BOOST_THROW_EXCEPTION(
+			nc_exception{}
+			<< errinfo_nc_status(status)
+			<< boost::errinfo_file_name(path)
+		);
+	}
+}
+
+boost::optional<int>
+read_opt_dimension(nc_file const& file, char const* name) {
+	int dimid;
+	if (nc_inq_dimid(file.ncid(), name, &dimid) != NC_NOERR) {
+		return boost::none;
+	}
+	
+	std::size_t length;
+	throw_if_error(nc_inq_dimlen(file.ncid(), dimid, &length), file.path());
+	return boost::numeric_cast<int>(length);
+}
+
+template<typename T>
+int
+get_vara(int ncid, int varid, std::size_t const* start, std::size_t const* count, T * data) {
+	if constexpr (std::is_same_v<T, double>) {
+		return nc_get_vara_double(ncid, varid, start, count, data);
+	} else {
+		static_assert(std::is_same_v<T, int>);
+		return nc_get_vara_int(ncid, varid, start, count, data);
+	}
+}
+
+/* Reads cells of variable name in chunks of chunk_rows cells and keeps those which contain at least one of the selected
+ * points. Indices of kept cells are appended to indices, the number of all cells is stored in total.
+ */
+template<typename Cell>
+std::vector<Cell>
+read_cells(
+	nc_file const& file,
+	char const* name,
+	std::vector<bool> const& selected,
+	std::size_t chunk_rows,
+	std::vector<std::size_t> & indices,
+	std::size_t & total
+) {
+	static constexpr std::size_t cell_size = std::tuple_size<Cell>::value;
+	std::vector<Cell> cells;
+	total = 0;
+	
+	int const ncid = file.ncid();
+	int varid, ndims;
+	if (nc_inq_varid(ncid, name, &varid) != NC_NOERR) {
+		return cells;
+	}
+	
+	int dimids[NC_MAX_VAR_DIMS];
+	throw_if_error(nc_inq_var(ncid, varid, nullptr, nullptr, &ndims, dimids, nullptr), file.path());
+	
+	std::size_t size = 0;
+	if (ndims == 2) {
+		throw_if_error(nc_inq_dimlen(ncid, dimids[0], &total), file.path());
+		throw_if_error(nc_inq_dimlen(ncid, dimids[1], &size), file.path());
+	}
+	if (size != cell_size) {
+		BOOST_THROW_EXCEPTION(invalid_grid_exception{});
+	}
+	
+	std::vector<int> chunk;
+	for(std::size_t first = 0; first < total; first += chunk_rows) {
+		std::size_t const start[2] = { first, 0 };
+		std::size_t const count[2] = { std::min(chunk_rows, total - first), cell_size };
+		chunk.resize(count[0] * cell_size);
+		throw_if_error(get_vara(ncid, varid, start, count, chunk.data()), file.path());
+		
+		for(std::size_t i = 0; i < count[0]; ++i) {
+			Cell cell;
+			bool touches = false;
+			for(std::size_t j = 0; j < cell_size; ++j) {
+				int const global_id = chunk[i*cell_size + j];
+				if (global_id < 0 || (std::size_t)global_id >= selected.size()) {
+					BOOST_THROW_EXCEPTION(invalid_grid_exception{});
+				}
+				cell[j] = global_id;
+				touches = touches || selected[global_id];
+			}
+			
+			if (touches) {
+				cells.push_back(cell);
+				indices.push_back(first + i);
+			}
+		}
+	}
+	return cells;
+}
+
+/* Reads values of a one-dimensional variable at the ascending indices ids. Only chunks of at most chunk_rows values
+ * which contain any of these indices are read, each one from its first up to its last required index.
+ */
+template<typename T>
+std::vector<T>
+read_values(
+	nc_file const& file,
+	char const* name,
+	std::vector<std::size_t> const& ids,
+	std::size_t chunk_rows
+) {
+	int varid;
+	throw_if_error(nc_inq_varid(file.ncid(), name, &varid), file.path());
+	
+	std::vector<T> values(ids.size());
+	std::vector<T> chunk;
+	for(std::size_t i = 0; i < ids.size();) {
+		std::size_t j = i;
+		while(j < ids.size() && ids[j] < ids[i] + chunk_rows) {
+			++j;
+		}
+		
+		std::size_t const start = ids[i];
+		std::size_t const count = ids[j-1] - start + 1;
+		chunk.resize(count);
+		throw_if_error(get_vara(file.ncid(), varid, &start, &count, chunk.data()), file.path());
+		
+		for(std::size_t k = i; k < j; ++k) {
+			values[k] = chunk[ids[k] - start];
+		}
+		i = j;
+	}
+	return values;
+}
+
+/* unnamed namespace */ }
+
+HBRS_THETA_UTILS_API
+theta_grid
+read_theta_grid(theta_grid_path const& path, std::vector<int> const& global_ids, std::size_t chunk_rows) {
+	if (chunk_rows == 0) {
+		BOOST_THROW_EXCEPTION(std::invalid_argument{"chunk_rows must be positive"});
+	}
+	
+	// file is closed on errors, too
+	nc_file file{path.full_path().string()};
+	
+	int dimid;
+	std::size_t no_of_points;
+	throw_if_error(nc_inq_dimid(file.ncid(), "no_of_points", &dimid), file.path());
+	throw_if_error(nc_inq_dimlen(file.ncid(), dimid, &no_of_points), file.path());
+	
+	// cells are selected by the given points only, but points of these cells are required as well
+	std::vector<bool> selected(no_of_points, false);
+	for(int global_id : global_ids) {
+		if (global_id < 0 || (std::size_t)global_id >= no_of_points) {
+			BOOST_THROW_EXCEPTION(invalid_grid_exception{});
+		}
+		selected[global_id] = true;
+	}
+	std::vector<bool> required = selected;
+	
+	std::vector<std::size_t> surfacetriangle_indices, surfacequadrilateral_indices, indices;
+	std::size_t no_of_surfacetriangles = 0, total = 0;
+	
+	auto const require_points = [&required](auto const& cells) {
+		for(auto const& cell : cells) {
+			for(int global_id : cell) {
+				required[global_id] = true;
+			}
+		}
+	};
+	
+#define __read_cells(__var, __indices, __total)                                                                        \
+	std::vector<theta_grid::__var> points_of_ ## __var ## s = read_cells<theta_grid::__var>(                           \
+		file, "points_of_" #__var "s", selected, chunk_rows, __indices, __total);                                      \
+	require_points(points_of_ ## __var ## s);
+	
+	__read_cells(tetraeder, indices, total)
+	__read_cells(prism, indices, total)
+	__read_cells(hexaeder, indices, total)
+	__read_cells(pyramid, indices, total)
+	__read_cells(surfacetriangle, surfacetriangle_indices, no_of_surfacetriangles)
+	__read_cells(surfacequadrilateral, surfacequadrilateral_indices, total)
+	
+#undef __read_cells
+	
+	std::vector<std::size_t> point_indices;
+	std::vector<int> point_ids;
+	for(std::size_t i = 0; i < no_of_points; ++i) {
+		if (required[i]) {
+			point_indices.push_back(i);
+			point_ids.push_back(boost::numeric_cast<int>(i));
+		}
+	}
+	
+	std::vector<double> points_xc = read_values<double>(file, "points_xc", point_indices, chunk_rows);
+	std::vector<double> points_yc = read_values<double>(file, "points_yc", point_indices, chunk_rows);
+	std::vector<double> points_zc = read_values<double>(file, "points_zc", point_indices, chunk_rows);
+	
+	std::vector<theta_grid::point> points;
+	points.reserve(point_indices.size());
+	for(std::size_t i = 0; i < point_indices.size(); ++i) {
+		points.push_back({points_xc[i], points_yc[i], points_zc[i]});
+	}
+	
+	// boundary markers of surface triangles precede those of surface quadrilaterals
+	std::vector<std::size_t> surface_indices = surfacetriangle_indices;
+	for(std::size_t i : surfacequadrilateral_indices) {
+		surface_indices.push_back(no_of_surfacetriangles + i);
+	}
+	std::vector<int> boundarymarker_of_surfaces =
+		read_values<int>(file, "boundarymarker_of_surfaces", surface_indices, chunk_rows);
+	
+	theta_grid grid{
+		read_opt_dimension(file, "points_per_tetraeder"),
+		read_opt_dimension(file, "points_per_prism"),
+		read_opt_dimension(file, "points_per_hexaeder"),
+		read_opt_dimension(file, "points_per_pyramid"),
+		read_opt_dimension(file, "points_per_surfacetriangle"),
+		read_opt_dimension(file, "points_per_surfacequadrilateral"),
+		
+		std::move(points_of_tetraeders),
+		std::move(points_of_prisms),
+		std::move(points_of_hexaeders),
+		std::move(points_of_pyramids),
+		std::move(points_of_surfacetriangles),
+		std::move(points_of_surfacequadrilaterals),
+		std::move(boundarymarker_of_surfaces),
+		
+		std::move(points),
+		std::move(point_ids),
+		boost::numeric_cast<int>(no_of_points)
+	};
+	
+	file.close();
+	return grid;
+}
+
 HBRS_THETA_UTILS_NAMESPACE_END
@@ -83,6 +83,28 @@ public:
 		std::vector<point> points
 	);
 	
+	/* Partially read grid which has only the points with the given global ids, see read_theta_grid() */
+	theta_grid(
+		boost::optional<int> points_per_tetraeder,
+		boost::optional<int> points_per_prism,
+		boost::optional<int> points_per_hexaeder,
+		boost::optional<int> points_per_pyramid,
+		boost::optional<int> points_per_surfacetriangle,
+		boost::optional<int> points_per_surfacequadrilateral,
+
+		std::vector<tetraeder> points_of_tetraeders,
+		std::vector<prism> points_of_prisms,
+		std::vector<hexaeder> points_of_hexaeders,
+		std::vector<pyramid> points_of_pyramids,
+		std::vector<surfacetriangle> points_of_surfacetriangles,
+		std::vector<surfacequadrilateral> points_of_surfacequadrilaterals,
+		std::vector<int> boundarymarker_of_surfaces,
+		
+		std::vector<point> points,
+		std::vector<int> point_ids,
+		int no_of_points
+	);
+	
 	theta_grid(nc_cntr cntr);
 	
 	theta_grid(theta_grid const&) = default;
@@ -93,6 +115,7 @@ public:
 	theta_grid&
 	operator=(theta_grid &&) = default;
 	
+	/* number of points of the whole grid, even if it has been read partially */
 	int no_of_points() const;
 	/* no_of_elements = no_of_tetraeders + no_of_prisms + no_of_hexaeders + no_of_pyramids */ 
 	int no_of_elements() const;
@@ -106,6 +129,10 @@ public:
 	int no_of_surfacetriangles() const;
 	int no_of_surfacequadrilaterals() const;
 	
+	/* Point with the given global id, which is an index into points() unless grid has been read partially */
+	point const&
+	point_of(int global_id) const;
+	
 	HBRS_THETA_UTILS_DECLARE_ATTR(points_per_tetraeder, boost::optional<int>)
 	HBRS_THETA_UTILS_DECLARE_ATTR(points_per_prism, boost::optional<int>)
 	HBRS_THETA_UTILS_DECLARE_ATTR(points_per_hexaeder, boost::optional<int>)
@@ -120,6 +147,11 @@ public:
 	HBRS_THETA_UTILS_DECLARE_ATTR(points_of_surfacequadrilaterals, std::vector<surfacequadrilateral>)
 	HBRS_THETA_UTILS_DECLARE_ATTR(boundarymarker_of_surfaces, std::vector<int>)
 	HBRS_THETA_UTILS_DECLARE_ATTR(points, std::vector<point>)
+	/* ascending global ids of points() if grid has been read partially, empty otherwise */
+	HBRS_THETA_UTILS_DECLARE_ATTR(point_ids, std::vector<int>)
+	
+private:
+	int no_of_points_;
 };
 
 HBRS_THETA_UTILS_NAMESPACE_END
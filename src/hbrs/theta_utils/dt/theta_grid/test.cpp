@@ -0,0 +1,205 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE dt_theta_grid_test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <hbrs/mpl/detail/test.hpp>
+#include <hbrs/theta_utils/detail/test.hpp>
+#include <hbrs/theta_utils/dt/exception.hpp>
+#include <hbrs/theta_utils/dt/nc_cntr.hpp>
+#include <hbrs/theta_utils/dt/theta_grid.hpp>
+
+#include <algorithm>
+#include <type_traits>
+#include <vector>
+
+namespace utf = boost::unit_test;
+namespace tt = boost::test_tools;
+using namespace hbrs::theta_utils;
+
+namespace {
+
+/* test data: points on a line, cells are chosen such that they are spread over several chunks if chunks are small */
+inline static std::vector<theta_grid::tetraeder> const
+tetraeders = { {0, 1, 2, 3}, {4, 5, 6, 7}, {2, 3, 4, 5}, {0, 1, 6, 7} };
+
+inline static std::vector<theta_grid::surfacetriangle> const
+surfacetriangles = { {0, 1, 2}, {5, 6, 7}, {1, 2, 3} };
+
+inline static std::vector<theta_grid::surfacequadrilateral> const
+surfacequadrilaterals = { {0, 1, 2, 3}, {4, 5, 6, 7} };
+
+// boundary markers of surface triangles precede those of surface quadrilaterals
+inline static std::vector<int> const
+boundarymarker_of_surfaces = { 1, 2, 3, 4, 5 };
+
+inline static constexpr int
+no_of_points = 8;
+
+void
+write_grid(theta_grid_path const& path) {
+	std::vector<double> xc, yc, zc;
+	for(int i = 0; i < no_of_points; ++i) {
+		xc.push_back(i);
+		yc.push_back(2.*i);
+		zc.push_back(3.*i);
+	}
+	
+	nc_dimension const points{"no_of_points", no_of_points};
+	nc_dimension const elements{"no_of_elements", tetraeders.size()};
+	nc_dimension const surfaceelements{"no_of_surfaceelements", boundarymarker_of_surfaces.size()};
+	nc_dimension const triangles{"no_of_surfacetriangles", surfacetriangles.size()};
+	nc_dimension const quadrilaterals{"no_of_surfacequadrilaterals", surfacequadrilaterals.size()};
+	nc_dimension const per_tetraeder{"points_per_tetraeder", 4};
+	nc_dimension const per_triangle{"points_per_surfacetriangle", 3};
+	nc_dimension const per_quadrilateral{"points_per_surfacequadrilateral", 4};
+	
+	auto const flatten = [](auto const& cells) {
+		std::vector<int> data;
+		for(auto const& cell : cells) {
+			data.insert(data.end(), cell.begin(), cell.end());
+		}
+		return data;
+	};
+	
+	write_nc_cntr(
+		nc_cntr{
+			{ points, elements, surfaceelements, triangles, quadrilaterals, per_tetraeder, per_triangle,
+				per_quadrilateral },
+			{
+				{ "points_xc", { points }, { xc } },
+				{ "points_yc", { points }, { yc } },
+				{ "points_zc", { points }, { zc } },
+				{ "points_of_tetraeders", { elements, per_tetraeder }, { flatten(tetraeders) } },
+				{ "points_of_surfacetriangles", { triangles, per_triangle }, { flatten(surfacetriangles) } },
+				{ "points_of_surfacequadrilaterals", { quadrilaterals, per_quadrilateral },
+					{ flatten(surfacequadrilaterals) } },
+				{ "boundarymarker_of_surfaces", { surfaceelements }, { boundarymarker_of_surfaces } }
+			},
+			{}
+		},
+		path.full_path().string()
+	);
+}
+
+/* unnamed namespace */ }
+
+BOOST_AUTO_TEST_SUITE(dt_theta_grid_test)
+
+using hbrs::mpl::detail::environment_fixture;
+BOOST_TEST_GLOBAL_FIXTURE(environment_fixture);
+
+BOOST_AUTO_TEST_CASE(read_partially, * utf::precondition(detail::mpi_world_size_condition{{0,4}}) ) {
+	detail::io_fixture fx{"read_partially"};
+	BOOST_TEST_MESSAGE("Working directory: " << fx.wd().path().string());
+	
+	theta_grid_path const path{fx.wd().path(), fx.prefix()};
+	write_grid(path);
+	
+	theta_grid const full = read_theta_grid(path);
+	BOOST_TEST_REQUIRE(full.no_of_points() == no_of_points);
+	BOOST_TEST_REQUIRE(full.boundarymarker_of_surfaces() == boundarymarker_of_surfaces, tt::per_element());
+	
+	// cells of the whole grid which contain any of the given points
+	auto const touching = [](auto const& cells, std::vector<int> const& global_ids, std::vector<bool> & kept) {
+		std::remove_cv_t<std::remove_reference_t<decltype(cells)>> touched;
+		kept.clear();
+		for(auto const& cell : cells) {
+			bool touches = std::any_of(cell.begin(), cell.end(), [&global_ids](int id) {
+				return std::find(global_ids.begin(), global_ids.end(), id) != global_ids.end();
+			});
+			kept.push_back(touches);
+			if (touches) {
+				touched.push_back(cell);
+			}
+		}
+		return touched;
+	};
+	
+	auto const compare_cells = [](auto const& got, auto const& expected) {
+		BOOST_TEST_REQUIRE(got.size() == expected.size());
+		for(std::size_t i = 0; i < got.size(); ++i) {
+			BOOST_TEST(got[i] == expected[i], tt::per_element());
+		}
+	};
+	
+	std::vector<std::vector<int>> const selections = {
+		{}, {0}, {7}, {0, 7}, {3}, {1, 6}, {0, 1, 2, 3, 4, 5, 6, 7}
+	};
+	
+	// chunks of 1, 2 and 3 rows let cells and points of a selection be spread across chunk boundaries
+	for(std::size_t chunk_rows : { std::size_t{1}, std::size_t{2}, std::size_t{3}, std::size_t{1} << 20 }) {
+		for(auto const& global_ids : selections) {
+			BOOST_TEST_MESSAGE("chunk_rows := " << chunk_rows << ", no_of_global_ids := " << global_ids.size());
+			theta_grid const got = read_theta_grid(path, global_ids, chunk_rows);
+			
+			std::vector<bool> kept_triangles, kept_quadrilaterals, kept_tetraeders;
+			auto const expected_tetraeders = touching(tetraeders, global_ids, kept_tetraeders);
+			auto const expected_triangles = touching(surfacetriangles, global_ids, kept_triangles);
+			auto const expected_quadrilaterals = touching(surfacequadrilaterals, global_ids, kept_quadrilaterals);
+			
+			compare_cells(got.points_of_tetraeders(), expected_tetraeders);
+			compare_cells(got.points_of_surfacetriangles(), expected_triangles);
+			compare_cells(got.points_of_surfacequadrilaterals(), expected_quadrilaterals);
+			BOOST_TEST(got.points_of_prisms().empty());
+			
+			// markers of kept triangles followed by markers of kept quadrilaterals
+			std::vector<int> expected_markers;
+			for(std::size_t i = 0; i < kept_triangles.size(); ++i) {
+				if (kept_triangles[i]) {
+					expected_markers.push_back(boundarymarker_of_surfaces[i]);
+				}
+			}
+			for(std::size_t i = 0; i < kept_quadrilaterals.size(); ++i) {
+				if (kept_quadrilaterals[i]) {
+					expected_markers.push_back(boundarymarker_of_surfaces[surfacetriangles.size() + i]);
+				}
+			}
+			BOOST_TEST(got.boundarymarker_of_surfaces() == expected_markers, tt::per_element());
+			
+			// selected points and all points of kept cells, in ascending order of their global ids
+			std::vector<int> expected_ids = global_ids;
+			auto const add_points = [&expected_ids](auto const& cells) {
+				for(auto const& cell : cells) {
+					expected_ids.insert(expected_ids.end(), cell.begin(), cell.end());
+				}
+			};
+			add_points(expected_tetraeders);
+			add_points(expected_triangles);
+			add_points(expected_quadrilaterals);
+			std::sort(expected_ids.begin(), expected_ids.end());
+			expected_ids.erase(std::unique(expected_ids.begin(), expected_ids.end()), expected_ids.end());
+			
+			BOOST_TEST(got.no_of_points() == no_of_points);
+			BOOST_TEST_REQUIRE(got.point_ids() == expected_ids, tt::per_element());
+			for(int global_id : expected_ids) {
+				theta_grid::point const& point = got.point_of(global_id);
+				theta_grid::point const& expected = full.point_of(global_id);
+				BOOST_TEST(point.x == expected.x);
+				BOOST_TEST(point.y == expected.y);
+				BOOST_TEST(point.z == expected.z);
+			}
+		}
+	}
+	
+	BOOST_CHECK_THROW(read_theta_grid(path, {no_of_points}), invalid_grid_exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,59 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HBRS_THETA_UTILS_DT_THETA_MODES_FWD_HPP
+#define HBRS_THETA_UTILS_DT_THETA_MODES_FWD_HPP
+
+#include <hbrs/theta_utils/config.hpp>
+#include <boost/hana/fwd/core/make.hpp>
+#include <boost/hana/fwd/core/to.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/optional.hpp>
+#include <string>
+
+HBRS_THETA_UTILS_NAMESPACE_BEGIN
+namespace hana = boost::hana;
+namespace fs = boost::filesystem;
+
+struct HBRS_THETA_UTILS_API theta_modes;
+struct theta_modes_tag {};
+constexpr auto make_theta_modes = hana::make<theta_modes_tag>;
+constexpr auto to_theta_modes = hana::to<theta_modes_tag>;
+
+/* Path of the modes file of a (domain of a) pca, e.g. karman.modes.domain_1 */
+HBRS_THETA_UTILS_API
+fs::path
+make_theta_modes_path(
+	fs::path const& folder,
+	std::string const& prefix,
+	boost::optional<int> const& domain_num
+);
+
+HBRS_THETA_UTILS_API
+theta_modes
+read_theta_modes(std::string const& file_path);
+
+HBRS_THETA_UTILS_API
+void
+write_theta_modes(
+	theta_modes const& modes,
+	std::string const& file_path,
+	bool overwrite = false
+);
+
+HBRS_THETA_UTILS_NAMESPACE_END
+
+#endif // !HBRS_THETA_UTILS_DT_THETA_MODES_FWD_HPP
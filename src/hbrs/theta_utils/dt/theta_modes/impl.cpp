@@ -0,0 +1,286 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "impl.hpp"
+
+#include <hbrs/theta_utils/dt/exception.hpp>
+#include <boost/exception/errinfo_file_name.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/assert.hpp>
+#include <algorithm>
+#include <typeinfo>
+
+HBRS_THETA_UTILS_NAMESPACE_BEGIN
+
+theta_modes::theta_modes(
+	std::vector<theta_field> modes,
+	theta_field mean,
+	theta_field scale,
+	std::vector<std::vector<double>> coefficients,
+	std::vector<double> latent,
+	std::vector<std::string> snapshots,
+	std::string prefix,
+	std::vector<int> global_id,
+	boost::optional<int> ndomains
+) : modes_{modes},
+	mean_{mean},
+	scale_{scale},
+	coefficients_{coefficients},
+	latent_{latent},
+	snapshots_{snapshots},
+	prefix_{prefix},
+	global_id_{global_id},
+	ndomains_{ndomains}
+	{}
+
+namespace {
+
+template<typename T>
+std::vector<T>
+get_data(nc_cntr const& cntr, std::string const& name, std::vector<std::string> const& dim_names) {
+	auto opt = cntr.variable(name);
+	if (!opt || opt->data().type() != typeid(std::vector<T>) || opt->dimensions().size() != dim_names.size()) {
+		BOOST_THROW_EXCEPTION(unsupported_format_exception{});
+	}
+	
+	for(std::size_t i = 0; i < dim_names.size(); ++i) {
+		if (opt->dimensions()[i].name() != dim_names[i]) {
+			BOOST_THROW_EXCEPTION(unsupported_format_exception{});
+		}
+	}
+	
+	return boost::get<std::vector<T>>(opt->data());
+}
+
+std::size_t
+get_length(nc_cntr const& cntr, std::string const& name) {
+	auto opt = cntr.dimension(name);
+	return opt ? opt->length() : 0;
+}
+
+/* splits a row-major no_of_rows x row_size matrix into its rows */
+template<typename T>
+std::vector<std::vector<T>>
+split_rows(std::vector<T> const& data, std::size_t no_of_rows, std::size_t row_size) {
+	if (data.size() != no_of_rows * row_size) {
+		BOOST_THROW_EXCEPTION(unsupported_format_exception{});
+	}
+	
+	std::vector<std::vector<T>> rows;
+	rows.reserve(no_of_rows);
+	for(std::size_t i = 0; i < no_of_rows; ++i) {
+		rows.emplace_back(data.begin() + i*row_size, data.begin() + (i+1)*row_size);
+	}
+	return rows;
+}
+
+template<typename T>
+std::vector<T>
+join_rows(std::vector<std::vector<T>> const& rows, std::size_t row_size) {
+	std::vector<T> data;
+	data.reserve(rows.size() * row_size);
+	for(auto const& row : rows) {
+		BOOST_ASSERT(row.size() == row_size);
+		data.insert(data.end(), row.begin(), row.end());
+	}
+	return data;
+}
+
+/* unnamed namespace */ }
+
+theta_modes::theta_modes(nc_cntr cntr)
+: mean_{
+	{},
+	get_data<double>(cntr, "x_velocity_mean", { "no_of_points" }),
+	get_data<double>(cntr, "y_velocity_mean", { "no_of_points" }),
+	get_data<double>(cntr, "z_velocity_mean", { "no_of_points" }),
+	{}, {}, {}, {}
+}, scale_{
+	{},
+	get_data<double>(cntr, "x_velocity_scale", { "no_of_points" }),
+	get_data<double>(cntr, "y_velocity_scale", { "no_of_points" }),
+	get_data<double>(cntr, "z_velocity_scale", { "no_of_points" }),
+	{}, {}, {}, {}
+} {
+	std::size_t const no_of_points = get_length(cntr, "no_of_points");
+	std::size_t const no_of_modes = get_length(cntr, "no_of_modes");
+	std::size_t const no_of_snapshots = get_length(cntr, "no_of_snapshots");
+	std::size_t const name_length = get_length(cntr, "snapshot_name_length");
+	
+	if (no_of_modes > 0) {
+		auto x_modes = split_rows(
+			get_data<double>(cntr, "x_velocity_modes", { "no_of_modes", "no_of_points" }), no_of_modes, no_of_points);
+		auto y_modes = split_rows(
+			get_data<double>(cntr, "y_velocity_modes", { "no_of_modes", "no_of_points" }), no_of_modes, no_of_points);
+		auto z_modes = split_rows(
+			get_data<double>(cntr, "z_velocity_modes", { "no_of_modes", "no_of_points" }), no_of_modes, no_of_points);
+		
+		modes_.reserve(no_of_modes);
+		for(std::size_t i = 0; i < no_of_modes; ++i) {
+			modes_.push_back({
+				{}, std::move(x_modes[i]), std::move(y_modes[i]), std::move(z_modes[i]), {}, {}, {}, {}
+			});
+		}
+		
+		coefficients_ = split_rows(
+			get_data<double>(cntr, "coefficients", { "no_of_modes", "no_of_snapshots" }), no_of_modes, no_of_snapshots);
+	}
+	
+	latent_ = get_data<double>(cntr, "latent", { "no_of_components" });
+	
+	for(auto & name : split_rows(
+		get_data<char>(cntr, "snapshots", { "no_of_snapshots", "snapshot_name_length" }), no_of_snapshots, name_length)
+	) {
+		// netCDF pads strings with null characters
+		snapshots_.emplace_back(name.begin(), std::find(name.begin(), name.end(), '\0'));
+	}
+	
+	if (cntr.variable("global_id")) {
+		global_id_ = get_data<int>(cntr, "global_id", { "no_of_points" });
+	}
+	
+	{
+		auto opt = cntr.attribute("prefix");
+		if (!opt || opt->value().type() != typeid(std::vector<char>)) {
+			BOOST_THROW_EXCEPTION(unsupported_format_exception{});
+		}
+		auto const& prefix = boost::get<std::vector<char>>(opt->value());
+		prefix_ = std::string{prefix.begin(), std::find(prefix.begin(), prefix.end(), '\0')};
+	}
+	
+	{
+		auto opt = cntr.attribute("ndomains");
+		if (opt) {
+			std::vector<int> ndomains = boost::get<std::vector<int>>(opt->value());
+			BOOST_ASSERT(ndomains.size() == 1);
+			ndomains_ = ndomains[0];
+		}
+	}
+}
+
+HBRS_THETA_UTILS_DEFINE_ATTR(modes, std::vector<theta_field>, theta_modes)
+HBRS_THETA_UTILS_DEFINE_ATTR(mean, theta_field, theta_modes)
+HBRS_THETA_UTILS_DEFINE_ATTR(scale, theta_field, theta_modes)
+HBRS_THETA_UTILS_DEFINE_ATTR(coefficients, std::vector<std::vector<double>>, theta_modes)
+HBRS_THETA_UTILS_DEFINE_ATTR(latent, std::vector<double>, theta_modes)
+HBRS_THETA_UTILS_DEFINE_ATTR(snapshots, std::vector<std::string>, theta_modes)
+HBRS_THETA_UTILS_DEFINE_ATTR(prefix, std::string, theta_modes)
+HBRS_THETA_UTILS_DEFINE_ATTR(global_id, std::vector<int>, theta_modes)
+HBRS_THETA_UTILS_DEFINE_ATTR(ndomains, boost::optional<int>, theta_modes)
+
+HBRS_THETA_UTILS_API
+fs::path
+make_theta_modes_path(
+	fs::path const& folder,
+	std::string const& prefix,
+	boost::optional<int> const& domain_num
+) {
+	return 
+		folder /
+			(prefix + ".modes" + 
+				(domain_num ? std::string{".domain_"} + boost::lexical_cast<std::string>(*domain_num) : "") 
+			);
+}
+
+HBRS_THETA_UTILS_API
+theta_modes
+read_theta_modes(std::string const& file_path) {
+	try {
+		return { read_nc_cntr(file_path) };
+	} catch (unsupported_format_exception & ex) {
+		ex << boost::errinfo_file_name(file_path);
+		throw;
+	}
+}
+
+HBRS_THETA_UTILS_API
+void
+write_theta_modes(
+	theta_modes const& modes,
+	std::string const& file_path,
+	bool overwrite
+) {
+	std::size_t const no_of_points = modes.mean().x_velocity().size();
+	std::size_t const no_of_modes = modes.modes().size();
+	std::size_t const no_of_snapshots = modes.snapshots().size();
+	std::size_t name_length = 1;
+	for(auto const& name : modes.snapshots()) {
+		name_length = std::max(name_length, name.size());
+	}
+	
+	BOOST_ASSERT(modes.coefficients().size() == no_of_modes);
+	BOOST_ASSERT(modes.mean().y_velocity().size() == no_of_points);
+	BOOST_ASSERT(modes.mean().z_velocity().size() == no_of_points);
+	BOOST_ASSERT(modes.scale().x_velocity().size() == no_of_points);
+	BOOST_ASSERT(modes.scale().y_velocity().size() == no_of_points);
+	BOOST_ASSERT(modes.scale().z_velocity().size() == no_of_points);
+	
+	// a dimension of length zero would be unlimited, hence a file without modes has no no_of_modes dimension
+	nc_dimension const points_dim{"no_of_points", no_of_points};
+	nc_dimension const modes_dim{"no_of_modes", no_of_modes};
+	nc_dimension const snapshots_dim{"no_of_snapshots", no_of_snapshots};
+	nc_dimension const components_dim{"no_of_components", modes.latent().size()};
+	nc_dimension const name_length_dim{"snapshot_name_length", name_length};
+	
+	std::vector<char> snapshots(no_of_snapshots * name_length, '\0');
+	for(std::size_t j = 0; j < no_of_snapshots; ++j) {
+		auto const& name = modes.snapshots()[j];
+		std::copy(name.begin(), name.end(), snapshots.begin() + j*name_length);
+	}
+	
+	std::vector<nc_dimension> dims { points_dim, snapshots_dim, components_dim, name_length_dim };
+	std::vector<nc_variable> vars {
+		{ "x_velocity_mean", { points_dim }, modes.mean().x_velocity() },
+		{ "y_velocity_mean", { points_dim }, modes.mean().y_velocity() },
+		{ "z_velocity_mean", { points_dim }, modes.mean().z_velocity() },
+		{ "x_velocity_scale", { points_dim }, modes.scale().x_velocity() },
+		{ "y_velocity_scale", { points_dim }, modes.scale().y_velocity() },
+		{ "z_velocity_scale", { points_dim }, modes.scale().z_velocity() },
+		{ "latent", { components_dim }, modes.latent() },
+		{ "snapshots", { snapshots_dim, name_length_dim }, snapshots }
+	};
+	
+	if (no_of_modes > 0) {
+		std::vector<std::vector<double>> x_modes, y_modes, z_modes;
+		for(theta_field const& mode : modes.modes()) {
+			x_modes.push_back(mode.x_velocity());
+			y_modes.push_back(mode.y_velocity());
+			z_modes.push_back(mode.z_velocity());
+		}
+		
+		dims.push_back(modes_dim);
+		vars.push_back({ "x_velocity_modes", { modes_dim, points_dim }, join_rows(x_modes, no_of_points) });
+		vars.push_back({ "y_velocity_modes", { modes_dim, points_dim }, join_rows(y_modes, no_of_points) });
+		vars.push_back({ "z_velocity_modes", { modes_dim, points_dim }, join_rows(z_modes, no_of_points) });
+		vars.push_back({ "coefficients", { modes_dim, snapshots_dim }, join_rows(modes.coefficients(), no_of_snapshots) });
+	}
+	
+	if (!modes.global_id().empty()) {
+		BOOST_ASSERT(modes.global_id().size() == no_of_points);
+		vars.push_back({ "global_id", { points_dim }, modes.global_id() });
+	}
+	
+	std::vector<nc_attribute> atts {
+		{ "prefix", std::vector<char>(modes.prefix().begin(), modes.prefix().end()) }
+	};
+	if (modes.ndomains()) {
+		atts.push_back({ "ndomains", std::vector<int>{ *modes.ndomains() } });
+	}
+	
+	write_nc_cntr({dims, vars, atts}, file_path, overwrite);
+}
+
+HBRS_THETA_UTILS_NAMESPACE_END
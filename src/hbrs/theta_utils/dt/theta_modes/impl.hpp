@@ -0,0 +1,100 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#ifndef HBRS_THETA_UTILS_DT_THETA_MODES_IMPL_HPP
+#define HBRS_THETA_UTILS_DT_THETA_MODES_IMPL_HPP
+
+#include "fwd.hpp"
+
+#include <hbrs/theta_utils/config.hpp>
+#include <hbrs/theta_utils/dt/nc_cntr.hpp>
+#include <hbrs/theta_utils/dt/theta_field.hpp>
+#include <hbrs/theta_utils/core/preprocessor.hpp>
+#include <boost/hana/core.hpp>
+#include <boost/optional.hpp>
+#include <vector>
+#include <string>
+
+HBRS_THETA_UTILS_NAMESPACE_BEGIN
+namespace hana = boost::hana;
+
+/* Compact result of a pca of theta fields: Instead of one pca-filtered field per time step only the leading principal
+ * components (spatial modes) of a domain, the row means and the temporal coefficients are stored. A time step filtered
+ * with any selection of the stored modes is mean + sum_i coefficients[i][j] * modes[i]. Together with the scales it
+ * serves as a model which new time steps can be projected onto.
+ */
+struct HBRS_THETA_UTILS_API theta_modes {
+public:
+	theta_modes(
+		std::vector<theta_field> modes,
+		theta_field mean,
+		theta_field scale,
+		std::vector<std::vector<double>> coefficients,
+		std::vector<double> latent,
+		std::vector<std::string> snapshots,
+		std::string prefix,
+		std::vector<int> global_id,
+		boost::optional<int> ndomains
+	);
+	
+	theta_modes(nc_cntr cntr);
+	
+	theta_modes(theta_modes const&) = default;
+	theta_modes(theta_modes &&) = default;
+	
+	theta_modes&
+	operator=(theta_modes const&) = default;
+	theta_modes&
+	operator=(theta_modes &&) = default;
+	
+	/* velocities of the principal components, scaled by the row standard deviations if data has been normalized */
+	HBRS_THETA_UTILS_DECLARE_ATTR(modes, std::vector<theta_field>)
+	/* mean velocities, zero if data has not been centered */
+	HBRS_THETA_UTILS_DECLARE_ATTR(mean, theta_field)
+	/* standard deviations of velocities, one if data has not been normalized */
+	HBRS_THETA_UTILS_DECLARE_ATTR(scale, theta_field)
+	/* scores of the time steps, one vector per mode */
+	HBRS_THETA_UTILS_DECLARE_ATTR(coefficients, std::vector<std::vector<double>>)
+	/* variances of all principal components, including those whose modes have not been stored */
+	HBRS_THETA_UTILS_DECLARE_ATTR(latent, std::vector<double>)
+	/* filenames of the decomposed theta fields, in order of the coefficients */
+	HBRS_THETA_UTILS_DECLARE_ATTR(snapshots, std::vector<std::string>)
+	/* prefix of the decomposed theta fields, required to parse the snapshot filenames */
+	HBRS_THETA_UTILS_DECLARE_ATTR(prefix, std::string)
+	HBRS_THETA_UTILS_DECLARE_ATTR(global_id, std::vector<int>)
+	HBRS_THETA_UTILS_DECLARE_ATTR(ndomains, boost::optional<int>)
+};
+
+HBRS_THETA_UTILS_NAMESPACE_END
+
+namespace boost { namespace hana {
+
+template<>
+struct tag_of< hbrs::theta_utils::theta_modes > {
+	using type = hbrs::theta_utils::theta_modes_tag;
+};
+
+template <>
+struct make_impl<hbrs::theta_utils::theta_modes_tag> {
+	static hbrs::theta_utils::theta_modes
+	apply(hbrs::theta_utils::nc_cntr cntr) {
+		return {cntr};
+	}
+};
+
+/* namespace hana */ } /* namespace boost */ }
+
+#endif // !HBRS_THETA_UTILS_DT_THETA_MODES_IMPL_HPP
@@ -0,0 +1,90 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#define BOOST_TEST_MODULE dt_theta_modes_test
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MAIN
+
+#include <boost/test/unit_test.hpp>
+
+#include <hbrs/mpl/detail/test.hpp>
+#include <hbrs/theta_utils/detail/test.hpp>
+#include <hbrs/theta_utils/dt/theta_modes.hpp>
+
+namespace utf = boost::unit_test;
+using namespace hbrs::theta_utils;
+
+BOOST_AUTO_TEST_SUITE(dt_theta_modes_test)
+
+using hbrs::mpl::detail::environment_fixture;
+BOOST_TEST_GLOBAL_FIXTURE(environment_fixture);
+
+BOOST_AUTO_TEST_CASE(write_read, * utf::precondition(detail::mpi_world_size_condition{{0,4}}) ) {
+	detail::io_fixture fx{"write_read"};
+	BOOST_TEST_MESSAGE("Working directory: " << fx.wd().path().string());
+	
+	for(std::size_t no_of_modes : { 0u, 2u }) {
+		BOOST_TEST_MESSAGE("no_of_modes := " << no_of_modes);
+		
+		std::vector<theta_field> modes{
+			{ {}, { 1., 2. }, { 3., 4. }, { 5., 6. }, {}, {}, {}, {} },
+			{ {}, { -1., -2. }, { -3., -4. }, { -5., -6. }, {}, {}, {}, {} }
+		};
+		std::vector<std::vector<double>> coefficients{ { .1, .2, .3 }, { -.1, -.2, -.3 } };
+		modes.resize(no_of_modes);
+		coefficients.resize(no_of_modes);
+		
+		theta_modes const ref{
+			modes,
+			{ {}, { 7., 8. }, { 9., 10. }, { 11., 12. }, {}, {}, {}, {} },
+			{ {}, { 1., .5 }, { 2., 1. }, { .25, 4. }, {}, {}, {}, {} },
+			coefficients,
+			{ 3., 2., 1. },
+			{ "karman.pval.t1_000e-02.1", "karman.pval.t2_000e-02.2", "karman.pval.t1_000e-01.10" },
+			"karman",
+			{ 4, 2 },
+			{ 2 }
+		};
+		
+		auto file_path = make_theta_modes_path(fx.wd().path(), fx.prefix(), { 1 });
+		BOOST_TEST(file_path.filename().string() == fx.prefix() + ".modes.domain_1");
+		
+		write_theta_modes(ref, file_path.string(), true);
+		theta_modes const got = read_theta_modes(file_path.string());
+		
+		BOOST_TEST_REQUIRE(got.modes().size() == no_of_modes);
+		for(std::size_t i = 0; i < no_of_modes; ++i) {
+			BOOST_TEST(got.modes()[i].x_velocity() == ref.modes()[i].x_velocity());
+			BOOST_TEST(got.modes()[i].y_velocity() == ref.modes()[i].y_velocity());
+			BOOST_TEST(got.modes()[i].z_velocity() == ref.modes()[i].z_velocity());
+			BOOST_TEST(got.coefficients()[i] == ref.coefficients()[i]);
+		}
+		
+		BOOST_TEST(got.mean().x_velocity() == ref.mean().x_velocity());
+		BOOST_TEST(got.mean().y_velocity() == ref.mean().y_velocity());
+		BOOST_TEST(got.mean().z_velocity() == ref.mean().z_velocity());
+		BOOST_TEST(got.scale().x_velocity() == ref.scale().x_velocity());
+		BOOST_TEST(got.scale().y_velocity() == ref.scale().y_velocity());
+		BOOST_TEST(got.scale().z_velocity() == ref.scale().z_velocity());
+		BOOST_TEST(got.latent() == ref.latent());
+		BOOST_TEST(got.snapshots() == ref.snapshots());
+		BOOST_TEST(got.prefix() == ref.prefix());
+		BOOST_TEST(got.global_id() == ref.global_id());
+		BOOST_TEST((got.ndomains() == ref.ndomains()));
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -40,6 +40,14 @@ HBRS_THETA_UTILS_API
 void
 execute(pca_cmd cmd);
 
+HBRS_THETA_UTILS_API
+void
+execute(reconstruct_cmd cmd);
+
+HBRS_THETA_UTILS_API
+void
+execute(project_cmd cmd);
+
 HBRS_THETA_UTILS_NAMESPACE_END
 
 #endif // !HBRS_THETA_UTILS_FN_EXECUTE_FWD_HPP
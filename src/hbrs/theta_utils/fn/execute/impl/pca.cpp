@@ -20,10 +20,13 @@
 #include <hbrs/theta_utils/dt/command_option.hpp>
 #include <hbrs/theta_utils/dt/theta_field.hpp>
 #include <hbrs/theta_utils/dt/theta_field_matrix.hpp>
+#include <hbrs/theta_utils/dt/theta_modes.hpp>
+#include <hbrs/theta_utils/dt/nc_cntr.hpp>
 #include <hbrs/theta_utils/detail/int_ranges.hpp>
 #include <hbrs/theta_utils/detail/matrix.hpp>
 #include <hbrs/theta_utils/detail/scatter.hpp>
 #include <hbrs/theta_utils/detail/gather.hpp>
+#include <hbrs/theta_utils/detail/pca.hpp>
 #include <hbrs/mpl/dt/pca_control.hpp>
 #include <hbrs/mpl/dt/pca_filter_control.hpp>
 #include <hbrs/mpl/dt/pca_filter_result.hpp>
@@ -36,6 +39,11 @@
 #include <hbrs/mpl/fn/n.hpp>
 #include <hbrs/mpl/fn/contains.hpp>
 
+#include <hbrs/mpl/config.hpp>
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+    #include <hbrs/mpl/dt/el_matrix.hpp>
+#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+
 #include <hbrs/mpl/detail/mpi.hpp>
 #include <hbrs/mpl/detail/log.hpp>
 #include <hbrs/theta_utils/dt/exception.hpp>
@@ -51,10 +59,16 @@
 #include <boost/iostreams/device/file.hpp>
 #include <boost/optional.hpp>
 #include <boost/filesystem.hpp>
+#include <boost/exception/errinfo_file_name.hpp>
+#include <boost/hana/type.hpp>
 
 #include <sstream>
+#include <memory>
+#include <functional>
 #include <limits>
+#include <list>
 #include <algorithm>
+#include <typeinfo>
 
 HBRS_THETA_UTILS_NAMESPACE_BEGIN
 namespace mpl = hbrs::mpl;
@@ -77,53 +91,9 @@ make_stats_output_path(
 			);
 }
 
-typedef boost::integer_range<std::size_t> number_range;
-typedef std::vector<number_range> number_ranges;
+typedef detail::int_ranges<std::size_t> number_ranges;
 typedef std::vector<number_ranges> number_ranges_sequence;
 
-number_ranges_sequence
-parse_nr_sequences(std::vector<std::string> const& rngs_seq) {
-	static constexpr auto min = 0;
-	/* number ranges are half-open ranges and thus max-1 is the maximum value of numbers */
-	static constexpr auto max = std::numeric_limits<std::size_t>::max()-1;
-	
-	if (rngs_seq.empty()) {
-		return { number_ranges{ number_range{min, max} } };
-	}
-
-	number_ranges_sequence nr_rngs_seq;
-	nr_rngs_seq.reserve(rngs_seq.size());
-	
-	for(auto rngs : rngs_seq) {
-		if (boost::equals(rngs, "none")) {
-			nr_rngs_seq.push_back(number_ranges{ number_range{0, 0} });
-			continue;
-		}
-
-		boost::replace_all(rngs, "first", boost::lexical_cast<std::string>(min));
-		boost::replace_all(rngs, "last", boost::lexical_cast<std::string>(max));
-		number_ranges nr_rngs;
-		bool valid = detail::parse_int_ranges(rngs.begin(), rngs.end(), nr_rngs);
-		
-		if (valid) {
-			for(auto & nr_rng : nr_rngs) {
-				if (nr_rng.empty() || (nr_rng.front() < min)) {
-					valid = false;
-					break;
-				}
-			}
-		}
-		
-		if (!valid) {
-			BOOST_THROW_EXCEPTION(invalid_number_range_spec_exception{} << errinfo_number_range_spec{rngs});
-		}
-		
-		nr_rngs_seq.push_back(nr_rngs);
-	}
-	
-	return nr_rngs_seq;
-}
-
 void
 write_stats(
 	std::vector<double> const& latent,
@@ -181,17 +151,18 @@ struct tag_of< hbrs::theta_utils::matlab_lapack_backend > {
 
 #ifdef HBRS_MPL_ENABLE_ELEMENTAL
 template<>
-struct tag_of< elemental_openmp_backend > {
-	using type = hbrs::mpl::el_matrix_tag;
+struct tag_of< elemental_mpi_backend > {
+	using type = hbrs::mpl::el_dist_matrix_tag;
 };
 
 template<>
-struct tag_of< elemental_mpi_backend > {
+struct tag_of< randomized_backend > {
 	using type = hbrs::mpl::el_dist_matrix_tag;
 };
 #endif // !HBRS_MPL_ENABLE_ELEMENTAL
 
-#if defined(HBRS_MPL_ENABLE_MATLAB) || defined(HBRS_MPL_ENABLE_ELEMENTAL)
+#ifdef HBRS_MPL_ENABLE_MATLAB
+/* NOTE: Elemental backends do not transpose the data matrix at all, see detail::pca_decompose(). */
 template<typename Matrix>
 decltype(auto)
 transpose_reduce_transpose(
@@ -209,82 +180,176 @@ transpose_reduce_transpose(
 		HBRS_MPL_FWD(r).latent()
 	);
 }
-#endif // !( defined(HBRS_MPL_ENABLE_MATLAB) || defined(HBRS_MPL_ENABLE_ELEMENTAL) )
+#endif // !HBRS_MPL_ENABLE_MATLAB
+
+typedef mpl::pca_filter_result<
+	theta_field_matrix /* data */,
+	std::vector<double> /* latent*/
+> pca_filter_result;
+
+/* Applies a pca filter to the series for the given selection of principal components */
+typedef std::function<pca_filter_result(detail::int_ranges<std::size_t> const&)> pca_filter_function;
 
 #ifdef HBRS_MPL_ENABLE_ELEMENTAL
+/* Decomposition of the distributed data matrix. Rows of results, e.g. of principal components, are distributed like rows
+ * of the data matrix, so they have to be gathered with the distribution which has been used to scatter the data.
+ */
+struct distributed_pca {
+	// process grid which distributed matrices of the decomposition refer to, hence it must outlive them
+	std::shared_ptr<El::Grid const> grid;
+	detail::pca_decomposition decomposition;
+	std::function<theta_field_matrix(
+		mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT> const&,
+		mpl::matrix_size<std::size_t, std::size_t> const&
+	)> gather;
+};
+
 template<
 	typename Backend,
 	typename std::enable_if_t<
-		std::is_same_v< Backend, elemental_mpi_backend >
+		std::is_same_v< Backend, elemental_openmp_backend > ||
+		std::is_same_v< Backend, elemental_mpi_backend > ||
+		std::is_same_v< Backend, randomized_backend >
 	>* = nullptr
 >
-mpl::pca_filter_result<
-	theta_field_matrix /* data */,
-	std::vector<double> /* latent*/
->
-distributed_reduce(
-	theta_field_matrix series,
+distributed_pca
+distributed_decompose(
+	std::vector<theta_field_path> const& paths,
+	mpl::matrix_size<std::size_t, std::size_t> const& series_sz,
 	Backend,
-	std::function<bool(std::size_t)> keep,
-	mpl::pca_filter_control<mpl::pca_control<bool,bool,bool>,bool> ctrl
+	mpl::pca_control<bool,bool,bool> const& ctrl,
+	detail::randomized_svd_control const& rnd_ctrl,
+	std::size_t grid_height
 ) {
-	HBRS_MPL_LOG_TRIVIAL(debug) << "distributed_reduce:begin";
-	auto series_sz = series.size();
-	
-	HBRS_MPL_LOG_TRIVIAL(debug) << "distributed_reduce:scatter";
-	auto distributed = scatter(
-		std::move(series),
-		detail::scatter_control<detail::theta_field_distribution_2>{{}}
-	);
-	
-	HBRS_MPL_LOG_TRIVIAL(debug) << "distributed_reduce:transpose_reduce_transpose";
-	auto filtered = transpose_reduce_transpose(std::move(distributed), keep, ctrl);
+	// Velocities are read straight into the local matrix of the distributed data matrix, without building theta
+	// fields and a theta_field_matrix first.
+	if constexpr (!std::is_same_v< Backend, elemental_mpi_backend >) {
+		// Sketches are local products of [VC,STAR] distributed matrices. Rows are distributed evenly without zero
+		// padding, so domains of different sizes do not add zero rows to the data matrix. With a single process, the
+		// local matrix is the whole data matrix and hence it is decomposed without any redistribution.
+		auto dist = detail::make_theta_field_distribution_3(series_sz);
+		
+		HBRS_MPL_LOG_TRIVIAL(debug) << "distributed_decompose:scatter";
+		auto distributed = scatter(paths, detail::scatter_control<detail::theta_field_distribution_3>{dist});
+		
+		HBRS_MPL_LOG_TRIVIAL(debug) << "distributed_decompose:pca_decompose";
+		auto decomposition = [&]() {
+			if constexpr (std::is_same_v< Backend, randomized_backend >) {
+				return detail::pca_decompose_randomized(std::move(distributed), ctrl, rnd_ctrl);
+			} else {
+				BOOST_ASSERT(mpi::comm_size() == 1);
+				return detail::pca_decompose(std::move(distributed), ctrl);
+			}
+		}();
+		
+		return {
+			nullptr,
+			std::move(decomposition),
+			[dist](auto const& from, auto const& lcl_sz) {
+				return detail::gather(
+					from,
+					detail::gather_control<
+						detail::theta_field_distribution_3,
+						mpl::matrix_size<std::size_t, std::size_t>
+					>{dist, lcl_sz}
+				);
+			}
+		};
+	} else {
+		// The svd works on a 2d process grid, so data is scattered to the grid directly
+		auto grid = detail::make_process_grid(grid_height);
+		HBRS_MPL_LOG_TRIVIAL(debug) << "distributed_decompose:process_grid:" << grid->Height() << "x" << grid->Width();
+		
+		HBRS_MPL_LOG_TRIVIAL(debug) << "distributed_decompose:scatter";
+		auto distributed = scatter(paths, detail::scatter_control<detail::theta_field_distribution_4>{{grid}});
+		
+		HBRS_MPL_LOG_TRIVIAL(debug) << "distributed_decompose:pca_decompose";
+		return {
+			grid,
+			detail::pca_decompose(std::move(distributed), ctrl),
+			[](auto const& from, auto const& lcl_sz) {
+				return detail::gather(
+					from,
+					detail::gather_control<
+						detail::theta_field_distribution_1,
+						mpl::matrix_size<std::size_t, std::size_t>
+					>{{}, lcl_sz}
+				);
+			}
+		};
+	}
+}
+
+template<
+	typename Backend,
+	typename std::enable_if_t<
+		std::is_same_v< Backend, elemental_openmp_backend > ||
+		std::is_same_v< Backend, elemental_mpi_backend > ||
+		std::is_same_v< Backend, randomized_backend >
+	>* = nullptr
+>
+pca_filter_function
+make_distributed_reduce(
+	std::vector<theta_field_path> const& paths,
+	Backend backend,
+	mpl::pca_control<bool,bool,bool> ctrl,
+	detail::randomized_svd_control rnd_ctrl,
+	bool keep_centered,
+	std::size_t grid_height
+) {
+	HBRS_MPL_LOG_TRIVIAL(debug) << "make_distributed_reduce:begin";
+	mpl::matrix_size<std::size_t, std::size_t> const series_sz {
+		3 * read_theta_field_size(paths.at(0).full_path().string()), paths.size()
+	};
 	
-	HBRS_MPL_LOG_TRIVIAL(debug) << "distributed_reduce:gather";
-	auto data = gather(
-		std::move(filtered.data()),
-		detail::gather_control<
-			detail::theta_field_distribution_2,
-			mpl::matrix_size<std::size_t, std::size_t>
-		>{{}, series_sz}
+	// Decomposition is independent of the selected principal components, so it is computed just once and
+	// each selection is only a (local) matrix product of the selected components followed by a gather.
+	HBRS_MPL_LOG_TRIVIAL(debug) << "make_distributed_reduce:distributed_decompose";
+	auto pca = std::make_shared<distributed_pca const>(
+		distributed_decompose(paths, series_sz, backend, ctrl, rnd_ctrl, grid_height)
 	);
-	BOOST_ASSERT(data.size() == series_sz);
-	
-	HBRS_MPL_LOG_TRIVIAL(debug) << "distributed_reduce:to_std_vector";
-	auto latent = hana::to<hana::ext::std::vector_tag>(std::move(filtered.latent()));
 	
 	#if !defined(NDEBUG)
-	{
-		auto latent_sz = (*mpl::size)(latent);
-		auto data_sz = detail::distributed_size(data, detail::theta_field_distribution_2{});
-		std::size_t data_m = (*mpl::m)(data_sz);
-		std::size_t data_n = (*mpl::n)(data_sz);
-		//NOTE: pca was applied to transposed data matrix
-		auto DOF = data_n - (ctrl.pca_control().center() ? 1 : 0);
+	if constexpr (!std::is_same_v< Backend, randomized_backend >) {
+		auto latent_sz = pca->decomposition.latent().size();
+		std::size_t data_m = boost::numeric_cast<std::size_t>(pca->decomposition.coeff().Height());
+		std::size_t data_n = boost::numeric_cast<std::size_t>(pca->decomposition.score().Height());
+		auto DOF = data_n - (ctrl.center() ? 1 : 0);
 		
-		if (DOF < data_m) {
-			if (ctrl.pca_control().economy()) {
-				BOOST_ASSERT(latent_sz == DOF);
-			} else {
-				BOOST_ASSERT(latent_sz == data_m);
-			}
+		if (ctrl.economy()) {
+			BOOST_ASSERT(latent_sz == std::min({data_m, data_n, DOF}));
 		} else {
-			BOOST_ASSERT(latent_sz == std::min(data_m, DOF));
+			BOOST_ASSERT(latent_sz == std::min(data_m, data_n));
 		}
 	}
 	#endif
 	
-	HBRS_MPL_LOG_TRIVIAL(debug) << "distributed_reduce:end";
-	return {data, latent};
+	HBRS_MPL_LOG_TRIVIAL(debug) << "make_distributed_reduce:end";
+	return [pca, series_sz, keep_centered](detail::int_ranges<std::size_t> const& includes) {
+		HBRS_MPL_LOG_TRIVIAL(debug) << "distributed_reduce:begin";
+		
+		std::function<bool(std::size_t)> keep = [&includes](std::size_t i) {
+			return detail::in_int_ranges(includes, i); 
+		};
+		
+		HBRS_MPL_LOG_TRIVIAL(debug) << "distributed_reduce:pca_reconstruct";
+		auto filtered = detail::pca_reconstruct(pca->decomposition, keep, keep_centered);
+		
+		HBRS_MPL_LOG_TRIVIAL(debug) << "distributed_reduce:gather";
+		auto data = pca->gather(filtered, series_sz);
+		BOOST_ASSERT(data.size() == series_sz);
+		
+		HBRS_MPL_LOG_TRIVIAL(debug) << "distributed_reduce:end";
+		return pca_filter_result{data, pca->decomposition.latent()};
+	};
 }
 #endif //! HBRS_MPL_ENABLE_ELEMENTAL
 
-#if defined(HBRS_MPL_ENABLE_MATLAB) || defined(HBRS_MPL_ENABLE_ELEMENTAL)
+#ifdef HBRS_MPL_ENABLE_MATLAB
 template<
 	typename Backend,
 	typename std::enable_if_t<
-		std::is_same_v< Backend, matlab_lapack_backend > ||
-		std::is_same_v< Backend, elemental_openmp_backend >
+		std::is_same_v< Backend, matlab_lapack_backend >
 	>* = nullptr
 >
 auto
@@ -322,66 +387,807 @@ reduce(
 	HBRS_MPL_LOG_TRIVIAL(debug) << "reduce:end";
 	return HBRS_MPL_FWD(reduced);
 }
-#endif // !( defined(HBRS_MPL_ENABLE_MATLAB) || defined(HBRS_MPL_ENABLE_ELEMENTAL) )
+#endif // !HBRS_MPL_ENABLE_MATLAB
 
-auto
-decompose_with_pca(
-	std::vector<theta_field> const& series,
-	detail::int_ranges<std::size_t> const& includes,
-	pca_backend const& backend,
-	bool center,
-	bool normalize,
-	bool keep_centered
+/* Besides the pca filter, first is assigned the variables of the first time step which do not change between time
+ * steps, i.e. global_id. The serial backend reads them in the same pass as the velocities.
+ */
+pca_filter_function
+make_pca_filter(
+	std::vector<theta_field_path> const& paths,
+	pca_options const& opts,
+	boost::optional<theta_field> & first
 ) {
-	HBRS_MPL_LOG_TRIVIAL(debug) << "decompose_with_pca:begin";
+	HBRS_MPL_LOG_TRIVIAL(debug) << "make_pca_filter:begin";
+	pca_backend const backend = opts.backend;
 	
-	if ((mpi::comm_size() > 1) && (backend != pca_backend::elemental_mpi)) {
+	if ((mpi::comm_size() > 1) && (backend != pca_backend::elemental_mpi) && (backend != pca_backend::randomized)) {
 		BOOST_THROW_EXCEPTION(invalid_backend_exception{} << errinfo_pca_backend{backend});
 	}
 	
-	std::function<bool(std::size_t)> keep = [&includes](std::size_t i) {
-		return detail::in_int_ranges(includes, i); 
-	};
-	
 	mpl::pca_filter_control<
 		mpl::pca_control<bool,bool,bool>,
 		bool
 	> ctrl {
 		{
 			true /* economy */,
-			center,
-			normalize
+			opts.center,
+			opts.normalize
 		},
-		keep_centered
+		opts.keep_centered
 	};
 	
-	mpl::pca_filter_result<
-		theta_field_matrix,
-		std::vector<double>
-	> reduced;
+	[[maybe_unused]] auto make_reduce = [&paths, &ctrl, &first](auto backend_c) -> pca_filter_function {
+		HBRS_MPL_LOG_TRIVIAL(debug) << "make_pca_filter:read_theta_series:*_velocity:global_id";
+		auto [fields, first_] = read_theta_series(paths, {".*_velocity"}, {"global_id"});
+		first = std::move(first_);
+		theta_field_matrix series{ std::move(fields) };
+		
+		// backend MATLAB_LAPACK is serial and reduces via hbrs::mpl::pca_filter, which decomposes per selection
+		return [series = std::move(series), ctrl, backend_c](detail::int_ranges<std::size_t> const& includes) {
+			std::function<bool(std::size_t)> keep = [&includes](std::size_t i) {
+				return detail::in_int_ranges(includes, i); 
+			};
+			return pca_filter_result{reduce(series, backend_c, keep, ctrl)};
+		};
+	};
+	
+	pca_filter_function filter;
 	
 	switch (backend) {
 		#ifdef HBRS_MPL_ENABLE_MATLAB
 		case pca_backend::matlab_lapack:
-			reduced = reduce({series}, matlab_lapack_backend_c, keep, ctrl);
+			filter = make_reduce(matlab_lapack_backend_c);
 			break;
 		#endif // !HBRS_MPL_ENABLE_MATLAB
 		#ifdef HBRS_MPL_ENABLE_ELEMENTAL
 		case pca_backend::elemental_openmp:
-			reduced = reduce({series}, elemental_openmp_backend_c, keep, ctrl);
+			filter = make_distributed_reduce(
+				paths, elemental_openmp_backend_c, ctrl.pca_control(), {0, 0, 0}, opts.keep_centered, 0);
 			break;
 		case pca_backend::elemental_mpi:
-			reduced = distributed_reduce({series}, elemental_mpi_backend_c, keep, ctrl);
+			filter = make_distributed_reduce(
+				paths, elemental_mpi_backend_c, ctrl.pca_control(), {0, 0, 0}, opts.keep_centered, opts.grid_height);
+			break;
+		case pca_backend::randomized:
+			filter = make_distributed_reduce(
+				paths,
+				randomized_backend_c,
+				ctrl.pca_control(),
+				{ opts.rank, opts.oversampling, opts.power_iterations },
+				opts.keep_centered,
+				opts.grid_height
+			);
 			break;
 		#endif // !HBRS_MPL_ENABLE_ELEMENTAL
 		default:
 			BOOST_THROW_EXCEPTION(invalid_backend_exception{} << errinfo_pca_backend{backend});
 	};
 	
-	HBRS_MPL_LOG_TRIVIAL(debug) << "decompose_with_pca:end";
-	return reduced;
+	// distributed backends read velocities straight into the data matrix, hence global_id is read on its own
+	if (!first) {
+		HBRS_MPL_LOG_TRIVIAL(debug) << "make_pca_filter:read_theta_field:global_id";
+		first = read_theta_field(paths.at(0).full_path().string(), {"global_id"});
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "make_pca_filter:end";
+	return filter;
+}
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+/* Instead of materializing pca-filtered theta fields for all time steps, only the leading no_of_modes principal
+ * components are written as spatial modes of this domain along with row means, scales and temporal coefficients. Any
+ * selection of those components can be reconstructed later for any time step with command reconstruct, and new time
+ * steps can be projected onto the modes with command project.
+ */
+void
+modal_pca(
+	std::vector<theta_field_path> const& paths,
+	std::vector<int> const& global_id,
+	std::size_t no_of_modes,
+	pca_options const& opts,
+	fs::path const& modes_path,
+	fs::path const& stats_path,
+	bool overwrite
+) {
+	HBRS_MPL_LOG_TRIVIAL(debug) << "modal_pca:begin";
+	mpl::matrix_size<std::size_t, std::size_t> const series_sz {
+		3 * read_theta_field_size(paths.at(0).full_path().string()), paths.size()
+	};
+	
+	mpl::pca_control<bool,bool,bool> ctrl {
+		true /* economy */,
+		opts.center,
+		opts.normalize
+	};
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "modal_pca:distributed_decompose";
+	distributed_pca pca = [&]() {
+		switch (opts.backend) {
+			case pca_backend::elemental_mpi:
+				return distributed_decompose(
+					paths, series_sz, elemental_mpi_backend_c, ctrl, {0, 0, 0}, opts.grid_height);
+			case pca_backend::randomized:
+				return distributed_decompose(
+					paths,
+					series_sz,
+					randomized_backend_c,
+					ctrl,
+					{ opts.rank, opts.oversampling, opts.power_iterations },
+					opts.grid_height
+				);
+			default:
+				BOOST_THROW_EXCEPTION(invalid_backend_exception{} << errinfo_pca_backend{opts.backend});
+		};
+	}();
+	detail::pca_decomposition const& dec = pca.decomposition;
+	
+	El::Matrix<double> const& coeff_lcl = dec.coeff().LockedMatrix();
+	El::Matrix<double> const& score_lcl = dec.score().LockedMatrix();
+	El::Int const m = dec.coeff().Height();
+	El::Int const n = dec.score().Height();
+	El::Int const lcl_m = coeff_lcl.Height();
+	El::Int const k = boost::numeric_cast<El::Int>(
+		std::min(no_of_modes, boost::numeric_cast<std::size_t>(dec.coeff().Width())));
+	
+	std::vector<theta_field> modes;
+	std::vector<std::vector<double>> coefficients;
+	if (k > 0) {
+		HBRS_MPL_LOG_TRIVIAL(debug) << "modal_pca:scale";
+		// modes are stored in physical units, i.e. principal components are scaled by row standard deviations
+		mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT> scaled{dec.coeff().Grid(), m, k};
+		El::Matrix<double> & scaled_lcl = scaled.data().Matrix();
+		BOOST_ASSERT(scaled.data().ColAlign() == dec.coeff().ColAlign());
+		BOOST_ASSERT(scaled_lcl.Height() == lcl_m);
+		El::Copy(coeff_lcl(El::ALL, El::IR(0, k)), scaled_lcl);
+		El::DiagonalScale(El::LEFT, El::NORMAL, dec.scale().LockedMatrix(), scaled_lcl);
+		
+		HBRS_MPL_LOG_TRIVIAL(debug) << "modal_pca:gather:modes";
+		modes = pca.gather(scaled, { series_sz.m(), boost::numeric_cast<std::size_t>(k) }).data();
+		
+		for(El::Int i = 0; i < k; ++i) {
+			coefficients.emplace_back(score_lcl.LockedBuffer(0, i), score_lcl.LockedBuffer(0, i) + n);
+		}
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "modal_pca:gather:mean";
+	theta_field mean = pca.gather(
+		mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT>{dec.mean()},
+		{ series_sz.m(), 1u }
+	).data().at(0);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "modal_pca:gather:scale";
+	theta_field scale = pca.gather(
+		mpl::el_dist_matrix<double, El::VC, El::STAR, El::ELEMENT>{dec.scale()},
+		{ series_sz.m(), 1u }
+	).data().at(0);
+	
+	std::vector<std::string> snapshots;
+	for(auto const& path : paths) {
+		snapshots.push_back(path.filename().string());
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "modal_pca:write_theta_modes";
+	write_theta_modes(
+		{
+			std::move(modes),
+			std::move(mean),
+			std::move(scale),
+			std::move(coefficients),
+			dec.latent(),
+			std::move(snapshots),
+			paths.at(0).prefix(),
+			global_id,
+			mpi::comm_size()
+		},
+		modes_path.string(),
+		overwrite
+	);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "modal_pca:write_stats";
+	write_stats(dec.latent(), stats_path);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "modal_pca:end";
+}
+#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+
+struct pca_paths {
+	std::vector<theta_field_path> series;
+	fs::path stats;
+};
+
+#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+/* Keeps at most capacity files open, closing the least recently used file when another one has to be opened. Series
+ * of up to capacity files are opened just once, longer series are reopened for each block instead of exhausting the
+ * file descriptors of a process.
+ */
+struct nc_file_cache {
+public:
+	nc_file_cache(std::size_t capacity, bool writable) : capacity_{capacity}, writable_{writable} {
+		BOOST_ASSERT(capacity_ > 0);
+	}
+	
+	nc_file const&
+	get(std::string const& path) {
+		auto it = std::find_if(files_.begin(), files_.end(), [&path](nc_file const& file) {
+			return file.path() == path;
+		});
+		
+		if (it != files_.end()) {
+			files_.splice(files_.begin(), files_, it);
+		} else {
+			if (files_.size() >= capacity_) {
+				files_.back().close();
+				files_.pop_back();
+			}
+			files_.emplace_front(path, writable_);
+		}
+		return files_.front();
+	}
+	
+	/* closes all files, reporting errors unlike the destructor of nc_file */
+	void
+	close() {
+		while (!files_.empty()) {
+			files_.front().close();
+			files_.pop_front();
+		}
+	}
+	
+private:
+	std::size_t capacity_;
+	bool writable_;
+	// most recently used first
+	std::list<nc_file> files_;
+};
+
+/* Number of files which are kept open for reading resp. writing by streaming_pca(), far below common limits of open
+ * file descriptors per process such as 1024
+ */
+constexpr std::size_t max_open_files = 64;
+
+/* Reads velocities of points [start, start+count) from all files straight into a matrix, one column per file */
+El::Matrix<double>
+read_velocity_block(
+	std::vector<theta_field_path> const& paths,
+	nc_file_cache & files,
+	std::size_t start,
+	std::size_t count
+) {
+	El::Matrix<double> block{
+		boost::numeric_cast<El::Int>(3 * count),
+		boost::numeric_cast<El::Int>(paths.size())
+	};
+	for(std::size_t j = 0; j < paths.size(); ++j) {
+		read_theta_velocities_block(
+			files.get(paths[j].full_path().string()),
+			block.Buffer(0, (El::Int)j),
+			start,
+			count
+		);
+	}
+	return block;
+}
+
+/* Returns the velocities of points [start, start+count) for all time steps, one column per time step */
+typedef std::function<El::Matrix<double>(std::size_t /* start */, std::size_t /* count */)> velocity_block_reader;
+/* Returns the global ids of points [start, start+count), null if not distributed */
+typedef std::function<shared_global_id(std::size_t /* start */, std::size_t /* count */)> global_id_block_reader;
+
+/* Method of snapshots: Instead of loading the complete series, the gram matrix of the (standardized) data matrix is
+ * accumulated block by block of points, followed by a second pass over all blocks to compute the pca-filtered data.
+ * Each block contains all time steps of its points, hence it can be centered and normalized on its own. Memory usage
+ * is bound by the n x n gram matrix and a single block of points for all n time steps.
+ */
+void
+filter_blocks(
+	velocity_block_reader const& read_velocities,
+	global_id_block_reader const& read_global_ids,
+	std::size_t no_of_points,
+	std::size_t no_of_steps,
+	number_ranges_sequence const& includes_seqs,
+	std::vector<pca_paths> const& output_paths_set,
+	boost::optional<fs::path> const& topology_path,
+	pca_options const& opts,
+	bool overwrite
+) {
+	HBRS_MPL_LOG_TRIVIAL(debug) << "filter_blocks:begin";
+	BOOST_ASSERT(opts.block_size > 0 || opts.block_memory > 0);
+	BOOST_ASSERT(includes_seqs.size() == output_paths_set.size());
+	
+	// a block, its pca-filtered copy and the theta fields built from that copy hold 3 velocities per point and step
+	std::size_t const bytes_per_point = 3 * 3 * std::max<std::size_t>(no_of_steps, 1) * sizeof(double);
+	std::size_t const block_size = opts.block_size > 0
+		? opts.block_size
+		: std::max<std::size_t>(1, opts.block_memory / bytes_per_point);
+	
+	mpl::pca_control<bool,bool,bool> ctrl {
+		true /* economy */,
+		opts.center,
+		opts.normalize
+	};
+	
+	El::Int const n = boost::numeric_cast<El::Int>(no_of_steps);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "filter_blocks:accumulate_gram";
+	El::Matrix<double> gram{n, n};
+	El::Zero(gram);
+	for(std::size_t start = 0; start < no_of_points; start += block_size) {
+		std::size_t count = std::min(block_size, no_of_points - start);
+		El::Matrix<double> block = read_velocities(start, count);
+		BOOST_ASSERT(block.Width() == n);
+		
+		El::Matrix<double> mean, scale;
+		detail::standardize_rows(block, ctrl, mean, scale);
+		El::Gemm(El::TRANSPOSE, El::NORMAL, 1., block, block, 1., gram);
+	}
+	
+	std::size_t lcl_m = 3 * no_of_points;
+	std::size_t gbl_m;
+	mpi::allreduce(&lcl_m, &gbl_m, 1, MPI_SUM, MPI_COMM_WORLD);
+	
+	El::Matrix<double> gbl_gram{n, n};
+	mpi::allreduce(gram.LockedBuffer(), gbl_gram.Buffer(), n*n, MPI_SUM, MPI_COMM_WORLD);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "filter_blocks:pca_decompose_gram";
+	detail::pca_gram_decomposition const decomposition = detail::pca_decompose_gram(std::move(gbl_gram), gbl_m, ctrl);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "filter_blocks:pca_gram_projector";
+	std::vector<El::Matrix<double>> projectors;
+	projectors.reserve(includes_seqs.size());
+	for(auto const& includes : includes_seqs) {
+		projectors.push_back(detail::pca_gram_projector(
+			decomposition,
+			[&includes](std::size_t i) { return detail::in_int_ranges(includes, i); }
+		));
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "filter_blocks:filter";
+	// output files are defined with the first block, then a bounded number of them is kept open across blocks
+	boost::optional<nc_file> topology_file;
+	nc_file_cache output_files{max_open_files, true};
+	for(std::size_t start = 0; start < no_of_points; start += block_size) {
+		std::size_t count = std::min(block_size, no_of_points - start);
+		El::Matrix<double> block = read_velocities(start, count);
+		
+		El::Matrix<double> mean, scale;
+		detail::standardize_rows(block, ctrl, mean, scale);
+		
+		// we need global_id field if distributed, e.g. for visualization
+		shared_global_id const global_id = read_global_ids(start, count);
+		
+		boost::optional<std::string> topology;
+		if (topology_path && global_id) {
+			theta_field block{ {}, {}, {}, {}, {}, {}, global_id, mpi::comm_size() };
+			if (start == 0) {
+				define_theta_field(block, no_of_points, topology_path->string(), overwrite);
+				topology_file.emplace(topology_path->string(), true);
+			}
+			write_theta_field_block(std::move(block), *topology_file, start);
+			topology = topology_path->filename().string();
+		}
+		
+		for(std::size_t t = 0; t < projectors.size(); ++t) {
+			El::Matrix<double> filtered{block.Height(), n};
+			El::Gemm(El::NORMAL, El::NORMAL, 1., block, projectors[t], 0., filtered);
+			detail::destandardize_rows(filtered, mean, scale, !opts.keep_centered);
+			
+			theta_field_matrix reduced{{3*count, no_of_steps}};
+			detail::copy_matrix(mpl::el_matrix<double>{filtered}, reduced);
+			
+			auto const& output_paths = output_paths_set[t].series;
+			BOOST_ASSERT(output_paths.size() == reduced.data().size());
+			for(std::size_t j = 0; j < output_paths.size(); ++j) {
+				theta_field & field = reduced.data()[j];
+				field.ndomains() = mpi::comm_size();
+				field.global_id() = topology ? shared_global_id{} : global_id;
+				
+				std::string file_path = output_paths[j].full_path().string();
+				if (start == 0) {
+					define_theta_field(field, no_of_points, file_path, overwrite, topology);
+				}
+				write_theta_field_block(std::move(field), output_files.get(file_path), start);
+			}
+		}
+	}
+	
+	if (topology_file) {
+		topology_file->close();
+	}
+	output_files.close();
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "filter_blocks:write_stats";
+	for(auto const& output_paths : output_paths_set) {
+		write_stats(decomposition.latent(), output_paths.stats);
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "filter_blocks:end";
+}
+
+void
+streaming_pca(
+	std::vector<theta_field_path> const& paths,
+	number_ranges_sequence const& includes_seqs,
+	std::vector<pca_paths> const& output_paths_set,
+	boost::optional<fs::path> const& topology_path,
+	pca_options const& opts,
+	bool overwrite
+) {
+	HBRS_MPL_LOG_TRIVIAL(debug) << "streaming_pca:begin";
+	bool const distributed = mpi::comm_size() > 1;
+	
+	// files are read block by block in both passes of filter_blocks(), a bounded number of them is kept open
+	nc_file_cache files{max_open_files, false};
+	
+	filter_blocks(
+		[&paths, &files](std::size_t start, std::size_t count) {
+			return read_velocity_block(paths, files, start, count);
+		},
+		[&paths, distributed](std::size_t start, std::size_t count) {
+			return distributed
+				? read_theta_field_block(paths.at(0).full_path().string(), start, count, {"global_id"}).global_id()
+				: shared_global_id{};
+		},
+		read_theta_field_size(paths.at(0).full_path().string()),
+		paths.size(),
+		includes_seqs,
+		output_paths_set,
+		topology_path,
+		opts,
+		overwrite
+	);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "streaming_pca:end";
+}
+
+fs::path
+make_state_output_path(
+	fs::path const& output_folder,
+	std::string const& output_prefix,
+	boost::optional<int> const& domain_num
+) {
+	return 
+		output_folder /
+			(output_prefix + ".pca_state" + 
+				(domain_num ? std::string{".domain_"} + boost::lexical_cast<std::string>(*domain_num) : "") 
+			);
+}
+
+/* Svd of the standardized data of all time steps processed so far and its row moments, see incremental_pca() */
+struct pca_state {
+	detail::incremental_svd svd;
+	detail::row_moments moments;
+	/* time steps in the order they have been folded into the svd */
+	std::vector<int> steps;
+	std::vector<int> global_id;
+};
+
+std::vector<double>
+flatten(El::Matrix<double> const& matrix) {
+	std::size_t const m = boost::numeric_cast<std::size_t>(matrix.Height());
+	std::vector<double> flat(m * boost::numeric_cast<std::size_t>(matrix.Width()));
+	for(El::Int j = 0; j < matrix.Width(); ++j) {
+		std::copy_n(matrix.LockedBuffer(0, j), m, flat.data() + j*m);
+	}
+	return flat;
+}
+
+El::Matrix<double>
+unflatten(std::vector<double> const& flat, std::size_t m, std::size_t n) {
+	BOOST_ASSERT(flat.size() == m*n);
+	El::Matrix<double> matrix{boost::numeric_cast<El::Int>(m), boost::numeric_cast<El::Int>(n)};
+	for(std::size_t j = 0; j < n; ++j) {
+		std::copy_n(flat.data() + j*m, m, matrix.Buffer(0, boost::numeric_cast<El::Int>(j)));
+	}
+	return matrix;
+}
+
+void
+write_pca_state(
+	pca_state const& state,
+	mpl::pca_control<bool,bool,bool> const& ctrl,
+	fs::path const& file_path
+) {
+	detail::incremental_svd const& svd = state.svd;
+	std::size_t const m = boost::numeric_cast<std::size_t>(state.moments.sums().Height());
+	std::size_t const k = boost::numeric_cast<std::size_t>(svd.singular_values().Height());
+	std::size_t const n = state.steps.size();
+	BOOST_ASSERT(state.moments.count() == n);
+	BOOST_ASSERT(svd.left().Height() == state.moments.sums().Height());
+	
+	nc_dimension const rows_dim{"no_of_rows", m};
+	nc_dimension const components_dim{"no_of_components", k};
+	nc_dimension const snapshots_dim{"no_of_snapshots", n};
+	nc_dimension const points_dim{"no_of_points", m/3};
+	
+	// El::Matrix is column-major while netCDF is row-major, hence dimensions are listed in reverse order
+	std::vector<nc_dimension> dims { rows_dim, components_dim, snapshots_dim };
+	std::vector<nc_variable> vars {
+		{ "left_singular_vectors", { components_dim, rows_dim }, flatten(svd.left()) },
+		{ "singular_values", { components_dim }, flatten(svd.singular_values()) },
+		{ "row_sums", { rows_dim }, flatten(state.moments.sums()) },
+		{ "row_squares", { rows_dim }, flatten(state.moments.squares()) },
+		{ "steps", { snapshots_dim }, state.steps }
+	};
+	
+	if (!state.global_id.empty()) {
+		BOOST_ASSERT(state.global_id.size() == m/3);
+		dims.push_back(points_dim);
+		vars.push_back({ "global_id", { points_dim }, state.global_id });
+	}
+	
+	write_nc_cntr(
+		{
+			dims,
+			vars,
+			{
+				{ "ndomains", std::vector<int>{ mpi::comm_size() } },
+				{ "center", std::vector<int>{ ctrl.center() ? 1 : 0 } },
+				{ "normalize", std::vector<int>{ ctrl.normalize() ? 1 : 0 } }
+			}
+		},
+		file_path.string(),
+		true
+	);
 }
 
+/* Throws if the state has been computed with other options for centering and normalizing than given in ctrl */
+pca_state
+read_pca_state(
+	fs::path const& file_path,
+	mpl::pca_control<bool,bool,bool> const& ctrl
+) {
+	nc_cntr cntr = read_nc_cntr(file_path.string());
+	
+	auto length = [&](std::string const& name) {
+		auto dim = cntr.dimension(name);
+		if (!dim) {
+			BOOST_THROW_EXCEPTION(unsupported_format_exception{} << boost::errinfo_file_name(file_path.string()));
+		}
+		return dim->length();
+	};
+	
+	auto data = [&](std::string const& name, auto type) {
+		typedef typename decltype(type)::type T;
+		auto var = cntr.variable(name);
+		if (!var || var->data().type() != typeid(std::vector<T>)) {
+			BOOST_THROW_EXCEPTION(unsupported_format_exception{} << boost::errinfo_file_name(file_path.string()));
+		}
+		return boost::get<std::vector<T>>(var->data());
+	};
+	
+	auto flag = [&](std::string const& name) {
+		auto attr = cntr.attribute(name);
+		if (!attr || attr->value().type() != typeid(std::vector<int>)
+			|| boost::get<std::vector<int>>(attr->value()).size() != 1) {
+			BOOST_THROW_EXCEPTION(unsupported_format_exception{} << boost::errinfo_file_name(file_path.string()));
+		}
+		return boost::get<std::vector<int>>(attr->value())[0];
+	};
+	
+	if (flag("ndomains") != mpi::comm_size() ||
+		(flag("center") != 0) != ctrl.center() ||
+		(flag("normalize") != 0) != ctrl.normalize()
+	) {
+		BOOST_THROW_EXCEPTION(incompatible_model_exception{} << boost::errinfo_file_name(file_path.string()));
+	}
+	
+	std::size_t const m = length("no_of_rows");
+	std::size_t const k = length("no_of_components");
+	std::size_t const n = length("no_of_snapshots");
+	
+	pca_state state {
+		{
+			unflatten(data("left_singular_vectors", hana::type_c<double>), m, k),
+			unflatten(data("singular_values", hana::type_c<double>), k, 1),
+			El::Matrix<double>{0, boost::numeric_cast<El::Int>(k)}
+		},
+		{
+			n,
+			unflatten(data("row_sums", hana::type_c<double>), m, 1),
+			unflatten(data("row_squares", hana::type_c<double>), m, 1)
+		},
+		data("steps", hana::type_c<int>),
+		cntr.variable("global_id") ? data("global_id", hana::type_c<int>) : std::vector<int>{}
+	};
+	
+	if (state.steps.size() != n) {
+		BOOST_THROW_EXCEPTION(unsupported_format_exception{} << boost::errinfo_file_name(file_path.string()));
+	}
+	
+	return state;
+}
+
+/* Incremental pca: The svd of the standardized data of all time steps processed so far and its row sums and sums of
+ * squares, from which row means and standard deviations follow, are persisted in the output folder. Only new time
+ * steps are read, folded into that state and written pca-filtered, i.e. projected onto the selected principal
+ * components of all time steps processed so far. Files of previous runs are neither read nor rewritten, stats are.
+ * Pca-filtered files of new time steps must not exist unless overwrite is given.
+ */
+void
+incremental_pca(
+	std::vector<theta_field_path> const& paths,
+	number_ranges_sequence const& includes_seqs,
+	std::vector<pca_paths> const& output_paths_set,
+	fs::path const& state_path,
+	boost::optional<fs::path> const& topology_path,
+	pca_options const& opts,
+	bool overwrite
+) {
+	HBRS_MPL_LOG_TRIVIAL(debug) << "incremental_pca:begin";
+	BOOST_ASSERT(includes_seqs.size() == output_paths_set.size());
+	bool const distributed = mpi::comm_size() > 1;
+	
+	mpl::pca_control<bool,bool,bool> ctrl {
+		true /* economy */,
+		opts.center,
+		opts.normalize
+	};
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "incremental_pca:read_pca_state";
+	bool const resumed = fs::exists(state_path);
+	pca_state state = resumed
+		? read_pca_state(state_path, ctrl)
+		: pca_state{ { {}, {}, {} }, { 0, {}, {} }, {}, {} };
+	
+	std::vector<std::size_t> new_indices;
+	for(std::size_t i = 0; i < paths.size(); ++i) {
+		if (!mpl::contains(state.steps, paths[i].step())) {
+			new_indices.push_back(i);
+		}
+	}
+	
+	// all processes must fold the same number of time steps, else the collective operations below would not match up
+	std::size_t const lcl_c = new_indices.size();
+	std::size_t min_c, max_c;
+	mpi::allreduce(&lcl_c, &min_c, 1, MPI_MIN, MPI_COMM_WORLD);
+	mpi::allreduce(&lcl_c, &max_c, 1, MPI_MAX, MPI_COMM_WORLD);
+	if (min_c != max_c) {
+		BOOST_THROW_EXCEPTION(incompatible_model_exception{} << boost::errinfo_file_name(state_path.string()));
+	}
+	
+	if (new_indices.empty()) {
+		HBRS_MPL_LOG_TRIVIAL(debug) << "incremental_pca:end";
+		return;
+	}
+	
+	// output files of previous time steps have not been checked by execute(pca_cmd) because they are kept
+	if (!overwrite) {
+		for(auto const& output_paths : output_paths_set) {
+			for(std::size_t i : new_indices) {
+				fs::path const path = output_paths.series.at(i).full_path();
+				if (fs::exists(path)) {
+					BOOST_THROW_EXCEPTION((
+						fs::filesystem_error{
+							(boost::format("output file %s already exists in folder %s")
+								% path.filename().string()
+								% path.parent_path().string()).str(),
+							make_error_code(boost::system::errc::file_exists)
+						}
+					));
+				}
+			}
+		}
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "incremental_pca:check_compatibility";
+	// points of new time steps must match those of the state, which is decided by all processes together because a
+	// single process throwing would leave the others waiting in the collective operations below
+	std::size_t const no_of_points = state.moments.count() > 0
+		? boost::numeric_cast<std::size_t>(state.moments.sums().Height()) / 3
+		: read_theta_field_size(paths[new_indices[0]].full_path().string());
+	
+	boost::optional<fs::path> incompatible;
+	for(std::size_t i : new_indices) {
+		std::string const file_path = paths[i].full_path().string();
+		if (read_theta_field_size(file_path) != no_of_points) {
+			incompatible = paths[i].full_path();
+			break;
+		}
+		
+		// we need global_id field if distributed, e.g. for visualization
+		if (distributed) {
+			shared_global_id global_id = read_theta_field(file_path, {"global_id"}).global_id();
+			if (state.global_id.empty() && state.steps.empty() && global_id) {
+				state.global_id = *global_id;
+			}
+			if (!global_id || *global_id != state.global_id) {
+				incompatible = paths[i].full_path();
+				break;
+			}
+		}
+	}
+	
+	int const lcl_compatible = incompatible ? 0 : 1;
+	int gbl_compatible;
+	mpi::allreduce(&lcl_compatible, &gbl_compatible, 1, MPI_MIN, MPI_COMM_WORLD);
+	if (gbl_compatible == 0) {
+		BOOST_THROW_EXCEPTION((
+			incompatible_model_exception{}
+			<< boost::errinfo_file_name(incompatible ? incompatible->string() : state_path.string())
+		));
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "incremental_pca:read_theta_velocities";
+	// velocities are read straight into the columns which are folded into the svd state
+	El::Int const c = boost::numeric_cast<El::Int>(new_indices.size());
+	El::Matrix<double> columns{boost::numeric_cast<El::Int>(3 * no_of_points), c};
+	for(El::Int j = 0; j < c; ++j) {
+		read_theta_velocities(paths[new_indices[j]].full_path().string(), columns.Buffer(0, j), no_of_points);
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "incremental_pca:update_incremental_pca";
+	// columns are standardized with the updated row means and standard deviations afterwards
+	detail::update_incremental_pca(columns, ctrl, opts.rank, state.svd, state.moments);
+	for(std::size_t i : new_indices) {
+		state.steps.push_back(paths[i].step());
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "incremental_pca:write_pca_state";
+	write_pca_state(state, ctrl, state_path);
+	
+	El::Matrix<double> mean, scale;
+	detail::standardization_of(state.moments, ctrl, mean, scale);
+	
+	El::Matrix<double> const& s = state.svd.singular_values();
+	El::Int const DOF = boost::numeric_cast<El::Int>(state.steps.size()) - (ctrl.center() ? 1 : 0);
+	std::vector<double> latent;
+	for(El::Int i = 0; i < s.Height(); ++i) {
+		latent.push_back(DOF > 0 ? s.Get(i, 0) * s.Get(i, 0) / DOF : 0.);
+	}
+	
+	shared_global_id const global_id = distributed
+		? std::make_shared<std::vector<int>>(state.global_id)
+		: shared_global_id{};
+	
+	boost::optional<std::string> topology;
+	if (topology_path && global_id) {
+		// global ids equal those of the state, so a topology file of a previous run is kept
+		if (!resumed || !fs::exists(*topology_path)) {
+			HBRS_MPL_LOG_TRIVIAL(debug) << "incremental_pca:write_topology";
+			write_theta_field(
+				{ {}, {}, {}, {}, {}, {}, global_id, mpi::comm_size() },
+				topology_path->string(),
+				overwrite
+			);
+		}
+		topology = topology_path->filename().string();
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "incremental_pca:filter";
+	for(std::size_t t = 0; t < includes_seqs.size(); ++t) {
+		auto const& includes = includes_seqs[t];
+		El::Matrix<double> filtered = detail::incremental_svd_filter(
+			state.svd,
+			columns,
+			[&includes](std::size_t i) { return detail::in_int_ranges(includes, i); }
+		);
+		detail::destandardize_rows(filtered, mean, scale, !opts.keep_centered);
+		
+		theta_field_matrix reduced{{3*no_of_points, new_indices.size()}};
+		detail::copy_matrix(mpl::el_matrix<double>{filtered}, reduced);
+		
+		auto const& output_paths = output_paths_set[t].series;
+		BOOST_ASSERT(output_paths.size() == paths.size());
+		for(std::size_t j = 0; j < new_indices.size(); ++j) {
+			theta_field & field = reduced.data()[j];
+			field.ndomains() = mpi::comm_size();
+			field.global_id() = topology ? shared_global_id{} : global_id;
+			write_theta_field(
+				std::move(field),
+				output_paths[new_indices[j]].full_path().string(),
+				overwrite,
+				topology
+			);
+		}
+		
+		write_stats(latent, output_paths_set[t].stats);
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "incremental_pca:end";
+}
+#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+
 /* unnamed namespace */ }
 
 HBRS_THETA_UTILS_API
@@ -418,10 +1224,12 @@ execute(pca_cmd cmd) {
 		}
 	}
 	
-	auto includes_seqs = parse_nr_sequences(cmd.pca_opts.pc_nr_seqs);
+	auto includes_seqs = detail::parse_int_ranges_sequence<std::size_t>(cmd.pca_opts.pc_nr_seqs);
 	auto tags = cmd.pca_opts.pc_nr_seqs.empty() == false ? cmd.pca_opts.pc_nr_seqs : std::vector<std::string>{"all"};
 	BOOST_ASSERT(includes_seqs.size() == tags.size());
 	
+	bool const overwrite = cmd.o_opts.overwrite;
+	
 	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(pca_cmd):list_output_folder";
 	// Listing folders might be slow for remote storage, e.g. NFS shares.
 	// This applies to e.g. exist(), operator==(path,path) and equivalent() in namespace boost::filesystem.
@@ -431,13 +1239,61 @@ execute(pca_cmd cmd) {
 		output_folder_contents.push_back(x.path().filename().string());
 	}
 	
+	// An update replaces state and stats of previous runs, while it keeps their pca-filtered files and topology file.
+	// Files of new time steps are checked by incremental_pca() because new time steps are known from the state only.
+	boost::optional<fs::path> state_path;
+	bool resumed = false;
+	if (cmd.pca_opts.update) {
+		state_path = make_state_output_path({ cmd.o_opts.path }, cmd.o_opts.prefix, paths[0].domain_num());
+		resumed = mpl::contains(output_folder_contents, state_path->filename().string());
+	}
+	
+	if (cmd.pca_opts.modes) {
+		#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+			auto modes_path = make_theta_modes_path({ cmd.o_opts.path }, cmd.o_opts.prefix, paths[0].domain_num());
+			auto stats_path = make_stats_output_path({ cmd.o_opts.path }, cmd.o_opts.prefix, "modes", paths[0].domain_num());
+			for(auto const& path : { modes_path, stats_path }) {
+				if (mpl::contains(output_folder_contents, path.filename().string()) && !overwrite) {
+					BOOST_THROW_EXCEPTION((
+						fs::filesystem_error{
+							(boost::format("output file %s already exists in folder %s")
+								% path.filename().string()
+								% path.parent_path().string()).str(),
+							make_error_code(boost::system::errc::file_exists)
+						}
+					));
+				}
+			}
+			
+			// only the leading principal components up to the highest selected one are stored
+			std::size_t no_of_modes = 0;
+			for(auto const& includes : includes_seqs) {
+				for(auto const& rng : includes) {
+					if (!rng.empty()) {
+						no_of_modes = std::max(no_of_modes, rng.back() + 1);
+					}
+				}
+			}
+			
+			// velocities are read by modal_pca() straight into the data matrix, global_id just once per series
+			HBRS_MPL_LOG_TRIVIAL(debug) << "execute(pca_cmd):read_theta_field:global_id";
+			shared_global_id const series_global_id = mpi::comm_size() > 1
+				? read_theta_field(paths[0].full_path().string(), {"global_id"}).global_id()
+				: shared_global_id{};
+			
+			// we need global_id field if distributed, e.g. for visualization
+			std::vector<int> const global_id = series_global_id ? *series_global_id : std::vector<int>{};
+			
+			modal_pca(paths, global_id, no_of_modes, cmd.pca_opts, modes_path, stats_path, overwrite);
+			HBRS_MPL_LOG_TRIVIAL(debug) << "execute(pca_cmd):end";
+			return;
+		#else
+			BOOST_THROW_EXCEPTION(invalid_backend_exception{} << errinfo_pca_backend{cmd.pca_opts.backend});
+		#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+	}
+	
 	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(pca_cmd):generate_output_paths";
 	// Generate output paths and test for existance before calling read_theta_fields which is slow
-	struct pca_paths {
-		std::vector<theta_field_path> series;
-		fs::path stats;
-	};
-	
 	std::vector<pca_paths> output_paths_set;
 	for(auto && tag : tags) {
 		HBRS_MPL_LOG_TRIVIAL(debug) << "execute(pca_cmd):output_paths:tag=" << tag;
@@ -450,7 +1306,9 @@ execute(pca_cmd cmd) {
 			path.folder() = { cmd.o_opts.path };
 			path.prefix() = cmd.o_opts.prefix + '_' + tag;
 			
-			if (mpl::contains(output_folder_contents, path.full_path().filename().string()) && !cmd.o_opts.overwrite) {
+			if (mpl::contains(output_folder_contents, path.full_path().filename().string()) && !overwrite &&
+				!cmd.pca_opts.update
+			) {
 				BOOST_THROW_EXCEPTION((
 					fs::filesystem_error{
 						(boost::format("output file %s already exists in folder %s") 
@@ -463,7 +1321,9 @@ execute(pca_cmd cmd) {
 		}
 		
 		auto stats_path = make_stats_output_path({ cmd.o_opts.path }, cmd.o_opts.prefix, tag, paths[0].domain_num());
-		if (mpl::contains(output_folder_contents, stats_path.filename().string()) && !cmd.o_opts.overwrite) {
+		if (mpl::contains(output_folder_contents, stats_path.filename().string()) && !overwrite &&
+			!cmd.pca_opts.update
+		) {
 			BOOST_THROW_EXCEPTION((
 				fs::filesystem_error{
 					(boost::format("stats file %s already exists in folder %s")
@@ -483,56 +1343,105 @@ execute(pca_cmd cmd) {
 		output_folder_contents.push_back(stats_path.filename().string());
 	}
 	
-	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(pca_cmd):read_theta_fields:*_velocity";
-	std::vector<theta_field> const series = read_theta_fields(paths, {".*_velocity"});
-	BOOST_ASSERT(series.at(0).ndomains() == mpi::comm_size()); //TODO: Turn assertion into exception?
+	// global ids are written just once per domain if requested, they are not needed if not distributed
+	boost::optional<fs::path> topology_path;
+	if (cmd.pca_opts.topology_file && mpi::comm_size() > 1) {
+		topology_path = make_theta_topology_path({ cmd.o_opts.path }, cmd.o_opts.prefix, paths[0].domain_num());
+		if (mpl::contains(output_folder_contents, topology_path->filename().string()) && !overwrite && !resumed) {
+			BOOST_THROW_EXCEPTION((
+				fs::filesystem_error{
+					(boost::format("topology file %s already exists in folder %s")
+						% topology_path->filename().string()
+						% topology_path->parent_path().string()).str(),
+					make_error_code(boost::system::errc::file_exists)
+				}
+			));
+		}
+	}
+	
+	if (cmd.pca_opts.streaming) {
+		#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+			streaming_pca(paths, includes_seqs, output_paths_set, topology_path, cmd.pca_opts, overwrite);
+			HBRS_MPL_LOG_TRIVIAL(debug) << "execute(pca_cmd):end";
+			return;
+		#else
+			BOOST_THROW_EXCEPTION(invalid_backend_exception{} << errinfo_pca_backend{cmd.pca_opts.backend});
+		#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+	}
+	
+	if (cmd.pca_opts.update) {
+		#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+			incremental_pca(
+				paths,
+				includes_seqs,
+				output_paths_set,
+				*state_path,
+				topology_path,
+				cmd.pca_opts,
+				overwrite
+			);
+			HBRS_MPL_LOG_TRIVIAL(debug) << "execute(pca_cmd):end";
+			return;
+		#else
+			BOOST_THROW_EXCEPTION(invalid_backend_exception{} << errinfo_pca_backend{cmd.pca_opts.backend});
+		#endif // !HBRS_MPL_ENABLE_ELEMENTAL
+	}
+	
+	// global_id is identical for all time steps, so it is read by the pca filter from the first file only, along with
+	// the velocities of that file for the serial backend
+	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(pca_cmd):make_pca_filter";
+	boost::optional<theta_field> first;
+	pca_filter_function filter = make_pca_filter(paths, cmd.pca_opts, first);
+	BOOST_ASSERT(first);
+	BOOST_ASSERT(first->ndomains() == mpi::comm_size()); //TODO: Turn assertion into exception?
 	// TODO: Warn user that his theta_field was computed with n domains but his current number of mpi processes is different!
 	
-	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(pca_cmd):read_theta_fields:global_id";
 	// we need global_id field if distributed, e.g. for visualization
-	std::vector<theta_field> const global_ids = read_theta_fields(paths, {"global_id"});
+	shared_global_id const global_id = first->global_id();
 	BOOST_ASSERT(mpi::comm_size() > 1
-		? global_ids[0].global_id().size() > 0
-		: global_ids[0].global_id().size() == 0
+		? global_id && global_id->size() > 0
+		: !global_id || global_id->size() == 0
 	);
 	
+	boost::optional<std::string> topology;
+	if (topology_path && global_id) {
+		HBRS_MPL_LOG_TRIVIAL(debug) << "execute(pca_cmd):write_topology";
+		write_theta_field(
+			{ {}, {}, {}, {}, {}, {}, global_id, mpi::comm_size() },
+			topology_path->string(),
+			overwrite
+		);
+		topology = topology_path->filename().string();
+	}
+	
 	for(auto && [ includes, output_paths ] :
 		mpl::detail::zip_impl_std_tuple_vector{}(std::move(includes_seqs), std::move(output_paths_set))
 	) {
-		HBRS_MPL_LOG_TRIVIAL(debug) << "execute(pca_cmd):decompose_with_pca";
-		mpl::pca_filter_result<
-			theta_field_matrix,
-			std::vector<double>
-		> reduced = decompose_with_pca(
-			series,
-			HBRS_MPL_FWD(includes),
-			cmd.pca_opts.backend,
-			cmd.pca_opts.center,
-			cmd.pca_opts.normalize,
-            cmd.pca_opts.keep_centered
-		);
+		HBRS_MPL_LOG_TRIVIAL(debug) << "execute(pca_cmd):pca_filter";
+		pca_filter_result reduced = filter(includes);
 		
 		HBRS_MPL_LOG_TRIVIAL(debug) << "execute(pca_cmd):assign_global_id";
 		{
-			BOOST_ASSERT(reduced.data().size().n() == global_ids.size());
+			BOOST_ASSERT(reduced.data().size().n() == paths.size());
 			
 			for(std::size_t i = 0; i < reduced.data().size().n(); ++i) {
-				auto const& src = global_ids[i].global_id();
 				auto & tgt = reduced.data().data()[i].global_id();
 				
 				BOOST_ASSERT(mpi::comm_size() > 1
-					? src.size() == reduced.data().data()[i].x_velocity().size() /* distributed */
-					: src.size() == 0
+					? global_id->size() == reduced.data().data()[i].x_velocity().size() /* distributed */
+					: !global_id || global_id->size() == 0
 				);
 				
-				tgt = src;
+				// all time steps share a single array of global ids
+				tgt = global_id;
 			}
 		}
 		
 		HBRS_MPL_LOG_TRIVIAL(debug) << "execute(pca_cmd):write_theta_fields";
 		write_theta_fields(
 			mpl::detail::zip_impl_std_tuple_vector{}(std::move(reduced.data().data()), std::move(output_paths.series)),
-			cmd.o_opts.overwrite
+			cmd.o_opts.overwrite,
+			topology
 		);
 		
 		HBRS_MPL_LOG_TRIVIAL(debug) << "execute(pca_cmd):write_stats";
@@ -0,0 +1,208 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../impl.hpp"
+
+#include <hbrs/theta_utils/dt/command.hpp>
+#include <hbrs/theta_utils/dt/command_option.hpp>
+#include <hbrs/theta_utils/dt/theta_field.hpp>
+#include <hbrs/theta_utils/dt/theta_modes.hpp>
+#include <hbrs/theta_utils/dt/exception.hpp>
+
+#include <hbrs/mpl/detail/mpi.hpp>
+#include <hbrs/mpl/detail/log.hpp>
+
+#include <boost/throw_exception.hpp>
+#include <boost/format.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/assert.hpp>
+#include <boost/optional.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/exception/errinfo_file_name.hpp>
+
+#include <vector>
+#include <string>
+
+HBRS_THETA_UTILS_NAMESPACE_BEGIN
+namespace mpi = hbrs::mpl::detail::mpi;
+
+namespace {
+
+/* x, y and z velocities of all points one after another, i.e. a column of a theta_field_matrix */
+std::vector<double>
+velocities(theta_field const& field) {
+	std::vector<double> flat;
+	flat.reserve(field.x_velocity().size() + field.y_velocity().size() + field.z_velocity().size());
+	for(auto const* values : { &field.x_velocity(), &field.y_velocity(), &field.z_velocity() }) {
+		flat.insert(flat.end(), values->begin(), values->end());
+	}
+	return flat;
+}
+
+/* local part of the inner product of a mode and a flattened field, see velocities() */
+double
+dot(theta_field const& mode, std::vector<double> const& flat) {
+	double sum = 0.;
+	std::size_t p = 0;
+	for(auto const* values : { &mode.x_velocity(), &mode.y_velocity(), &mode.z_velocity() }) {
+		BOOST_ASSERT(p + values->size() <= flat.size());
+		for(double value : *values) {
+			sum += value * flat[p++];
+		}
+	}
+	return sum;
+}
+
+/* unnamed namespace */ }
+
+HBRS_THETA_UTILS_API
+void
+execute(project_cmd cmd) {
+	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(project_cmd):begin";
+	BOOST_ASSERT(mpi::initialized());
+	
+	boost::optional<int> const domain_num = mpi::comm_size() > 1
+		? boost::optional<int>{mpi::comm_rank()}
+		: boost::optional<int>{boost::none};
+	
+	auto paths = filter_theta_fields_by_domain_num(
+		find_theta_fields(cmd.i_opts.path, cmd.i_opts.pval_prefix),
+		domain_num
+	);
+	
+	if (paths.empty()) { 
+		BOOST_THROW_EXCEPTION((
+			fs::filesystem_error{
+				(boost::format("no theta field files (*.pval.*) with prefix %s found in folder %s") % cmd.i_opts.pval_prefix % cmd.i_opts.path).str(),
+				boost::system::errc::make_error_code(boost::system::errc::no_such_file_or_directory)
+			}
+		));
+	}
+	
+	fs::path const model_path = make_theta_modes_path({ cmd.p_opts.model_path }, cmd.p_opts.model_prefix, domain_num);
+	if (!fs::exists(model_path)) {
+		BOOST_THROW_EXCEPTION((
+			fs::filesystem_error{
+				(boost::format("no model file %s found in folder %s, use pca with option --modes to create it")
+					% model_path.filename().string() % cmd.p_opts.model_path).str(),
+				boost::system::errc::make_error_code(boost::system::errc::no_such_file_or_directory)
+			}
+		));
+	}
+	
+	fs::path const output_path = make_theta_modes_path({ cmd.o_opts.path }, cmd.o_opts.prefix, domain_num);
+	if (fs::exists(output_path) && !cmd.o_opts.overwrite) {
+		BOOST_THROW_EXCEPTION((
+			fs::filesystem_error{
+				(boost::format("output file %s already exists in folder %s") 
+					% output_path.filename().string()
+					% output_path.parent_path().string()).str(),
+				make_error_code(boost::system::errc::file_exists)
+			}
+		));
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(project_cmd):read_theta_modes";
+	theta_modes model = read_theta_modes(model_path.string());
+	if (model.ndomains() != mpi::comm_size()) {
+		BOOST_THROW_EXCEPTION(incompatible_model_exception{} << boost::errinfo_file_name(model_path.string()));
+	}
+	
+	// we need global_id field if distributed, because points of new time steps must be ordered like the model's points
+	if (mpi::comm_size() > 1) {
+		HBRS_MPL_LOG_TRIVIAL(debug) << "execute(project_cmd):read_theta_field:global_id";
+		shared_global_id global_id = read_theta_field(paths[0].full_path().string(), {"global_id"}).global_id();
+		if (!global_id || *global_id != model.global_id()) {
+			BOOST_THROW_EXCEPTION((
+				incompatible_model_exception{}
+				<< boost::errinfo_file_name(paths[0].full_path().string())
+			));
+		}
+	}
+	
+	std::vector<double> const mean = velocities(model.mean());
+	std::vector<double> const scale = velocities(model.scale());
+	std::size_t const k = model.modes().size();
+	std::size_t const n = paths.size();
+	
+	// all processes must project the same number of time steps, else the reduction of coefficients would mix them up
+	std::size_t min_n, max_n;
+	mpi::allreduce(&n, &min_n, 1, MPI_MIN, MPI_COMM_WORLD);
+	mpi::allreduce(&n, &max_n, 1, MPI_MAX, MPI_COMM_WORLD);
+	if (min_n != max_n) {
+		BOOST_THROW_EXCEPTION(incompatible_model_exception{} << boost::errinfo_file_name(model_path.string()));
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(project_cmd):project";
+	// Modes are principal components scaled by standard deviations s, hence the coefficient of mode u*s for time step x
+	// is u^T*((x-mean)/s) = (u*s)^T*((x-mean)/s^2). Each file is read once and then dropped, so memory is bound by the
+	// model and a single time step.
+	std::vector<double> lcl_coefficients(k * n, 0.);
+	for(std::size_t j = 0; j < n; ++j) {
+		std::vector<double> x = velocities(read_theta_field(paths[j].full_path().string(), {".*_velocity"}));
+		if (x.size() != mean.size()) {
+			BOOST_THROW_EXCEPTION((
+				incompatible_model_exception{}
+				<< boost::errinfo_file_name(paths[j].full_path().string())
+			));
+		}
+		
+		for(std::size_t p = 0; p < x.size(); ++p) {
+			x[p] = (x[p] - mean[p]) / (scale[p] * scale[p]);
+		}
+		
+		for(std::size_t i = 0; i < k; ++i) {
+			lcl_coefficients[i*n + j] = dot(model.modes()[i], x);
+		}
+	}
+	
+	std::vector<std::vector<double>> coefficients;
+	if (k > 0) {
+		std::vector<double> gbl_coefficients(k * n);
+		mpi::allreduce(lcl_coefficients.data(), gbl_coefficients.data(), k*n, MPI_SUM, MPI_COMM_WORLD);
+		
+		for(std::size_t i = 0; i < k; ++i) {
+			coefficients.emplace_back(gbl_coefficients.begin() + i*n, gbl_coefficients.begin() + (i+1)*n);
+		}
+	}
+	
+	std::vector<std::string> snapshots;
+	for(auto const& path : paths) {
+		snapshots.push_back(path.filename().string());
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(project_cmd):write_theta_modes";
+	// written like the output of pca --modes, so command reconstruct can be applied to the projected time steps, too
+	write_theta_modes(
+		{
+			std::move(model.modes()),
+			std::move(model.mean()),
+			std::move(model.scale()),
+			std::move(coefficients),
+			std::move(model.latent()),
+			std::move(snapshots),
+			cmd.i_opts.pval_prefix,
+			std::move(model.global_id()),
+			model.ndomains()
+		},
+		output_path.string(),
+		cmd.o_opts.overwrite
+	);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(project_cmd):end";
+}
+
+HBRS_THETA_UTILS_NAMESPACE_END
@@ -0,0 +1,196 @@
+/* Copyright (c) 2020 Jakob Meng, <jakobmeng@web.de>
+ * 
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * 
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ * 
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "../impl.hpp"
+
+#include <hbrs/theta_utils/dt/command.hpp>
+#include <hbrs/theta_utils/dt/command_option.hpp>
+#include <hbrs/theta_utils/dt/theta_field.hpp>
+#include <hbrs/theta_utils/dt/theta_modes.hpp>
+#include <hbrs/theta_utils/dt/exception.hpp>
+#include <hbrs/theta_utils/detail/int_ranges.hpp>
+
+#include <hbrs/mpl/fn/contains.hpp>
+#include <hbrs/mpl/detail/mpi.hpp>
+#include <hbrs/mpl/detail/log.hpp>
+
+#include <boost/numeric/conversion/cast.hpp>
+#include <boost/throw_exception.hpp>
+#include <boost/format.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/assert.hpp>
+#include <boost/optional.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/exception/errinfo_file_name.hpp>
+
+#include <vector>
+#include <string>
+#include <memory>
+#include <algorithm>
+
+HBRS_THETA_UTILS_NAMESPACE_BEGIN
+namespace mpl = hbrs::mpl;
+namespace mpi = hbrs::mpl::detail::mpi;
+
+namespace {
+
+/* Computes the pca-filtered theta field of time step j, i.e. the linear combination of the selected modes */
+theta_field
+reconstruct(
+	theta_modes const& modes,
+	shared_global_id const& global_id,
+	detail::int_ranges<std::size_t> const& includes,
+	std::size_t j,
+	bool keep_centered
+) {
+	theta_field field = modes.mean();
+	if (keep_centered) {
+		for(auto * values : { &field.x_velocity(), &field.y_velocity(), &field.z_velocity() }) {
+			std::fill(values->begin(), values->end(), 0.);
+		}
+	}
+	
+	for(std::size_t i = 0; i < modes.modes().size(); ++i) {
+		if (!detail::in_int_ranges(includes, i)) {
+			continue;
+		}
+		
+		double const coefficient = modes.coefficients()[i][j];
+		theta_field const& mode = modes.modes()[i];
+		
+		#define __axpy(__name)                                                                                         \
+			{                                                                                                          \
+				auto const& x = mode.__name();                                                                         \
+				auto & y = field.__name();                                                                             \
+				BOOST_ASSERT(x.size() == y.size());                                                                    \
+				for(std::size_t p = 0; p < y.size(); ++p) {                                                            \
+					y[p] += coefficient * x[p];                                                                        \
+				}                                                                                                      \
+			}
+		
+		__axpy(x_velocity)
+		__axpy(y_velocity)
+		__axpy(z_velocity)
+		
+		#undef __axpy
+	}
+	
+	field.global_id() = global_id;
+	field.ndomains() = modes.ndomains();
+	return field;
+}
+
+/* unnamed namespace */ }
+
+HBRS_THETA_UTILS_API
+void
+execute(reconstruct_cmd cmd) {
+	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(reconstruct_cmd):begin";
+	BOOST_ASSERT(mpi::initialized());
+	
+	boost::optional<int> const domain_num = mpi::comm_size() > 1
+		? boost::optional<int>{mpi::comm_rank()}
+		: boost::optional<int>{boost::none};
+	
+	fs::path const modes_path = make_theta_modes_path({ cmd.i_opts.path }, cmd.i_opts.pval_prefix, domain_num);
+	if (!fs::exists(modes_path)) {
+		BOOST_THROW_EXCEPTION((
+			fs::filesystem_error{
+				(boost::format("no modes file %s found in folder %s, use pca with option --modes to create it")
+					% modes_path.filename().string() % cmd.i_opts.path).str(),
+				boost::system::errc::make_error_code(boost::system::errc::no_such_file_or_directory)
+			}
+		));
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(reconstruct_cmd):read_theta_modes";
+	theta_modes const modes = read_theta_modes(modes_path.string());
+	BOOST_ASSERT(modes.ndomains() == mpi::comm_size()); //TODO: Turn assertion into exception?
+	
+	auto includes_seqs = detail::parse_int_ranges_sequence<std::size_t>(cmd.r_opts.pc_nr_seqs);
+	auto tags = cmd.r_opts.pc_nr_seqs.empty() == false ? cmd.r_opts.pc_nr_seqs : std::vector<std::string>{"all"};
+	BOOST_ASSERT(includes_seqs.size() == tags.size());
+	
+	auto steps_seqs = detail::parse_int_ranges_sequence<std::size_t>(cmd.r_opts.step_nr_seqs);
+	BOOST_ASSERT(steps_seqs.size() == 1);
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(reconstruct_cmd):select_steps";
+	// columns of the coefficient matrix and paths of the selected time steps
+	std::vector<std::size_t> columns;
+	std::vector<theta_field_path> paths;
+	for(std::size_t j = 0; j < modes.snapshots().size(); ++j) {
+		auto path = parse_theta_field_path(modes.snapshots()[j], modes.prefix());
+		if (!path) {
+			BOOST_THROW_EXCEPTION(unsupported_format_exception{} << boost::errinfo_file_name(modes_path.string()));
+		}
+		
+		if (detail::in_int_ranges(steps_seqs[0], boost::numeric_cast<std::size_t>(path->step()))) {
+			columns.push_back(j);
+			paths.push_back(*path);
+		}
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(reconstruct_cmd):list_output_folder";
+	// Listing folders might be slow for remote storage, hence we list the output folder just once, see execute(pca_cmd)
+	std::vector<std::string> output_folder_contents;
+	for (auto && x : fs::directory_iterator{{ cmd.o_opts.path }}){
+		output_folder_contents.push_back(x.path().filename().string());
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(reconstruct_cmd):generate_output_paths";
+	std::vector<std::vector<theta_field_path>> output_paths_set;
+	for(auto && tag : tags) {
+		std::vector<theta_field_path> output_paths = paths;
+		for(auto & path : output_paths) {
+			// transform input paths to output paths
+			path.folder() = { cmd.o_opts.path };
+			path.prefix() = cmd.o_opts.prefix + '_' + tag;
+			
+			if (mpl::contains(output_folder_contents, path.filename().string()) && !cmd.o_opts.overwrite) {
+				BOOST_THROW_EXCEPTION((
+					fs::filesystem_error{
+						(boost::format("output file %s already exists in folder %s") 
+							% path.filename().string()
+							% path.folder().string()).str(),
+						make_error_code(boost::system::errc::file_exists)
+					}
+				));
+			}
+			output_folder_contents.push_back(path.filename().string());
+		}
+		output_paths_set.push_back(std::move(output_paths));
+	}
+	
+	// all reconstructed time steps share the global ids of the modes
+	shared_global_id const global_id = modes.global_id().empty()
+		? shared_global_id{}
+		: std::make_shared<std::vector<int>>(modes.global_id());
+	
+	for(std::size_t t = 0; t < includes_seqs.size(); ++t) {
+		HBRS_MPL_LOG_TRIVIAL(debug) << "execute(reconstruct_cmd):reconstruct:tag=" << tags[t];
+		for(std::size_t c = 0; c < columns.size(); ++c) {
+			write_theta_field(
+				reconstruct(modes, global_id, includes_seqs[t], columns[c], cmd.r_opts.keep_centered),
+				output_paths_set[t][c].full_path().string(),
+				cmd.o_opts.overwrite
+			);
+		}
+	}
+	
+	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(reconstruct_cmd):end";
+}
+
+HBRS_THETA_UTILS_NAMESPACE_END
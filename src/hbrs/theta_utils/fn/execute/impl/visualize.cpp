@@ -28,6 +28,7 @@
 #include <boost/throw_exception.hpp>
 #include <boost/format.hpp>
 #include <boost/system/error_code.hpp>
+#include <iostream>
 
 HBRS_THETA_UTILS_NAMESPACE_BEGIN
 namespace fs = boost::filesystem;
@@ -88,6 +89,20 @@ execute(visualize_cmd cmd) {
 		}
 	}
 	
+	if (cmd.v_opts.benchmark) {
+		HBRS_MPL_LOG_TRIVIAL(debug) << "execute(visualize_cmd):benchmark_vtk_xml_encodings";
+		benchmark_vtk_xml_encodings(
+			*grid_path,
+			field_paths.front(),
+			cmd.o_opts.path,
+			cmd.v_opts.includes,
+			cmd.v_opts.excludes,
+			cmd.v_opts.selection,
+			std::cout);
+		HBRS_MPL_LOG_TRIVIAL(debug) << "execute(visualize_cmd):end";
+		return;
+	}
+	
 	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(visualize_cmd):convert_to_vtk";
 	convert_to_vtk(
 		*grid_path,
@@ -98,7 +113,10 @@ execute(visualize_cmd cmd) {
 		cmd.v_opts.excludes,
 		cmd.v_opts.simple_numbering,
 		cmd.v_opts.format,
-		cmd.o_opts.overwrite);
+		cmd.o_opts.overwrite,
+		cmd.v_opts.pipeline_depth,
+		cmd.v_opts.encoding,
+		cmd.v_opts.selection);
 	HBRS_MPL_LOG_TRIVIAL(debug) << "execute(visualize_cmd):end";
 }
 
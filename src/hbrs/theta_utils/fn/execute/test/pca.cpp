@@ -115,7 +115,9 @@ BOOST_AUTO_TEST_CASE(write_read,
 		hana::make_tuple(theta_field_path::naming_scheme::theta, theta_field_path::naming_scheme::tau_unsteady),
 		hana::make_tuple(hana::true_c, hana::false_c) /* center */,
 		hana::make_tuple(hana::true_c, hana::false_c) /* normalize */,
-		hana::make_tuple(hana::true_c, hana::false_c) /* keep_centered */
+		hana::make_tuple(hana::true_c, hana::false_c) /* keep_centered */,
+		hana::make_tuple(hana::int_c<0>, hana::int_c<1>, hana::int_c<2>, hana::int_c<3>, hana::int_c<4>)
+			/* 0: in-memory, 1: streaming, 2: update, 3: modes and reconstruct, 4: modes, project and reconstruct */
 	);
 	
 	static constexpr auto factories = hana::drop_back(hana::make_tuple(
@@ -159,6 +161,7 @@ BOOST_AUTO_TEST_CASE(write_read,
 		auto const& center = hana::at_c<2>(cfg);
 		auto const& normalize = hana::at_c<3>(cfg);
 		auto const& keep_centered = hana::at_c<4>(cfg);
+		auto const& mode = hana::at_c<5>(cfg);
 		
 		BOOST_TEST_MESSAGE("dataset_nr=" << dataset_nr);
 		BOOST_TEST_MESSAGE(
@@ -168,6 +171,7 @@ BOOST_AUTO_TEST_CASE(write_read,
 		BOOST_TEST_MESSAGE("center=" << (center ? "true" : "false"));
 		BOOST_TEST_MESSAGE("normalize=" << (normalize ? "true" : "false"));
 		BOOST_TEST_MESSAGE("keep_centered=" << (keep_centered ? "true" : "false"));
+		BOOST_TEST_MESSAGE("mode=" << static_cast<int>(mode));
 		
 		auto const& dataset = hana::at(datasets, dataset_nr);
 		
@@ -226,9 +230,10 @@ BOOST_AUTO_TEST_CASE(write_read,
 						: boost::optional<int>{boost::none};
 					
 					theta_field_matrix local_series = hbrs::theta_utils::make_theta_field_matrix(local_dataset);
+					auto const global_id = std::make_shared<std::vector<int>>(local_series.size().m()/3, 0);
 					for(theta_field & field : local_series.data()) {
 						if (mpi::comm_size() > 1) {
-							field.global_id() = std::vector<int>(local_series.size().m()/3, 0);
+							field.global_id() = global_id;
 						}
 						field.ndomains() = mpi::comm_size();
 					}
@@ -242,8 +247,15 @@ BOOST_AUTO_TEST_CASE(write_read,
 						path.domain_num() = domain_num;
 					}
 					
+					/* incremental pca is run twice, first with the leading and then with all time steps */
+					std::size_t const no_of_steps = n_;
+					std::size_t const no_of_leading = (mode == 2 && no_of_steps >= 4) ? no_of_steps/2 : no_of_steps;
+					
 					write_theta_fields(
-						mpl::detail::zip_impl_std_tuple_vector{}(local_series.data(), pca_input_paths),
+						mpl::detail::zip_impl_std_tuple_vector{}(
+							std::vector<theta_field>(local_series.data().begin(), local_series.data().begin() + no_of_leading),
+							std::vector<theta_field_path>(pca_input_paths.begin(), pca_input_paths.begin() + no_of_leading)
+						),
 						false
 					);
 					
@@ -257,8 +269,51 @@ BOOST_AUTO_TEST_CASE(write_read,
 					cmd.pca_opts.backend = pca_backend::elemental_mpi;
 					cmd.pca_opts.center = center;
 					cmd.pca_opts.normalize = normalize;
-					cmd.pca_opts.keep_centered = keep_centered;
+					// incremental pca centers time steps with the mean of all time steps processed so far, so the
+					// centered outputs of a run differ from those of later runs and are not compared
+					cmd.pca_opts.keep_centered = keep_centered && mode != 2;
+					cmd.pca_opts.streaming = (mode == 1);
+					cmd.pca_opts.update = (mode == 2);
+					cmd.pca_opts.modes = (mode == 3 || mode == 4);
+					cmd.pca_opts.block_size = 2; // multiple blocks per file
 					execute(cmd);
+					
+					if (mode == 4) {
+						// projecting the decomposed time steps onto their own modes must yield the same coefficients
+						project_cmd p_cmd;
+						p_cmd.i_opts.path = fxi.wd().path().string();
+						p_cmd.i_opts.pval_prefix = fxi.prefix();
+						p_cmd.o_opts.path = fxo.wd().path().string();
+						p_cmd.o_opts.prefix = fxo.prefix() + "_projected";
+						p_cmd.o_opts.overwrite = false;
+						p_cmd.p_opts.model_path = fxo.wd().path().string();
+						p_cmd.p_opts.model_prefix = fxo.prefix();
+						execute(p_cmd);
+					}
+					
+					if (mode == 3 || mode == 4) {
+						reconstruct_cmd r_cmd;
+						r_cmd.i_opts.path = fxo.wd().path().string();
+						r_cmd.i_opts.pval_prefix = (mode == 4) ? fxo.prefix() + "_projected" : fxo.prefix();
+						r_cmd.o_opts.path = fxo.wd().path().string();
+						r_cmd.o_opts.prefix = fxo.prefix();
+						r_cmd.o_opts.overwrite = false;
+						r_cmd.r_opts.pc_nr_seqs = {/* all */};
+						r_cmd.r_opts.step_nr_seqs = {/* all */};
+						r_cmd.r_opts.keep_centered = keep_centered;
+						execute(r_cmd);
+					}
+					
+					if (no_of_leading < no_of_steps) {
+						write_theta_fields(
+							mpl::detail::zip_impl_std_tuple_vector{}(
+								std::vector<theta_field>(local_series.data().begin() + no_of_leading, local_series.data().end()),
+								std::vector<theta_field_path>(pca_input_paths.begin() + no_of_leading, pca_input_paths.end())
+							),
+							false
+						);
+						execute(cmd);
+					}
 				}
 				
 				auto all_paths = find_theta_fields(fxo.wd().path(), fxo.prefix() + "_all");
@@ -302,7 +357,7 @@ BOOST_AUTO_TEST_CASE(write_read,
 				
 				BOOST_TEST_MESSAGE("Comparing original data and reconstructed data computed by impl nr " << impl_idx);
 				
-				if (center && keep_centered) {
+				if (center && keep_centered && mode != 2) {
 					// if matrix was centered and mean was not readded after pca,
 					// then we have to add mean now to be able to do a comparison
 					auto testcase = hana::at(testcases, impl_idx);
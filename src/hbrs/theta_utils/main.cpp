@@ -30,6 +30,8 @@
 #include <boost/throw_exception.hpp>
 #include <boost/format.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/numeric/conversion/cast.hpp>
 
 #include <boost/variant/variant.hpp>
 #include <boost/variant/get.hpp>
@@ -45,7 +47,9 @@ boost::variant<
 	help_cmd,
 	version_cmd,
 	visualize_cmd,
-	pca_cmd
+	pca_cmd,
+	reconstruct_cmd,
+	project_cmd
 >
 parse_options(int argc, char *argv[]) {
 	namespace bpo = boost::program_options;
@@ -85,7 +89,7 @@ parse_options(int argc, char *argv[]) {
 		(
 			"command",
 			bpo::value<std::string>(),
-			"command to execute, one of: visualize, pca"
+			"command to execute, one of: visualize, pca, reconstruct, project"
 		)
 		(
 			"command-options",
@@ -272,12 +276,53 @@ parse_options(int argc, char *argv[]) {
 			(
 				"output-format",
 				bpo::value<std::string>()->value_name("FORMAT"),
-				"output format to use, currently only VTK_LEGACY_ASCII and VTK_XML_BINARY are supported"
+				"output format to use, currently only VTK_LEGACY_ASCII, VTK_XML_BINARY, VTK_XML_STREAMED and VTK_HDF "
+				"are supported, VTK_XML_STREAMED writes uncompressed VTU files without building VTK data structures"
 			)
 			(
 				"simple-numbering",
 				"drop timestamps from filenames and use ascending numbers (1, 2, 3...) instead, e.g. to animate time series in ParaView"
 			)
+			(
+				"pipeline-depth",
+				bpo::value<std::size_t>()->value_name("STEPS"),
+				"number of time steps which are read ahead and written in the background while a time step is converted, "
+				"limits memory usage, 0 converts time steps one after another, defaults to 1"
+			)
+			(
+				"vtk-compressor",
+				bpo::value<std::string>()->value_name("COMPRESSOR"),
+				"compressor of VTK_XML_BINARY output, one of none, zlib, lz4 and lzma, defaults to zlib"
+			)
+			(
+				"vtk-compression-level",
+				bpo::value<int>()->value_name("LEVEL"),
+				"compression level of VTK_XML_BINARY output from 1 (fastest) to 9 (smallest), "
+				"defaults to the compressor's default"
+			)
+			(
+				"vtk-raw-appended",
+				"write data arrays of VTK_XML_BINARY output raw into an appended section "
+				"instead of base64-encoding them"
+			)
+			(
+				"cells",
+				bpo::value<std::string>()->value_name("KIND"),
+				"cells to export, one of surface, volume and all, only points of these cells are written, "
+				"defaults to all"
+			)
+			(
+				"boundary-markers",
+				bpo::value< std::vector<std::string> >()->multitoken()->composing()->value_name("LIST"),
+				"export only surface cells with boundary markers in LIST, e.g. \"1\" or \"1,4,7\", "
+				"multiple listings are possible"
+			)
+			(
+				"benchmark",
+				"write the first time step with each compressor, compression level and encoding of VTK_XML_BINARY "
+				"output to temporary folders in the output folder and print bytes written and seconds per step "
+				"instead of converting"
+			)
 		;
 		
 		bpo::parsed_options unreg_parsed = bpo::command_line_parser(unreg_opts).options(cmd_options).run();
@@ -322,6 +367,10 @@ parse_options(int argc, char *argv[]) {
 				cmd.v_opts.format = vtk_file_format::legacy_ascii;
 			} else if (boost::iequals(frmt, "VTK_XML_BINARY")) {
 				cmd.v_opts.format = vtk_file_format::xml_binary;
+			} else if (boost::iequals(frmt, "VTK_XML_STREAMED")) {
+				cmd.v_opts.format = vtk_file_format::xml_streamed;
+			} else if (boost::iequals(frmt, "VTK_HDF")) {
+				cmd.v_opts.format = vtk_file_format::hdf;
 			} else {
 				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{
 					(boost::format("output format %s is unknown / not supported") % frmt).str()
@@ -333,6 +382,73 @@ parse_options(int argc, char *argv[]) {
 		
 		cmd.v_opts.simple_numbering = (vm.count("simple-numbering") > 0);
 		
+		if (vm.count("pipeline-depth")) {
+			cmd.v_opts.pipeline_depth = vm["pipeline-depth"].as<std::size_t>();
+		}
+		
+		if (vm.count("vtk-compressor")) {
+			std::string compressor = vm["vtk-compressor"].as<std::string>();
+			
+			if (boost::iequals(compressor, "none")) {
+				cmd.v_opts.encoding.compressor = vtk_compressor::none;
+			} else if (boost::iequals(compressor, "zlib")) {
+				cmd.v_opts.encoding.compressor = vtk_compressor::zlib;
+			} else if (boost::iequals(compressor, "lz4")) {
+				cmd.v_opts.encoding.compressor = vtk_compressor::lz4;
+			} else if (boost::iequals(compressor, "lzma")) {
+				cmd.v_opts.encoding.compressor = vtk_compressor::lzma;
+			} else {
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{
+					(boost::format("vtk compressor %s is unknown / not supported") % compressor).str()
+				});
+			}
+		}
+		
+		if (vm.count("vtk-compression-level")) {
+			cmd.v_opts.encoding.level = vm["vtk-compression-level"].as<int>();
+			
+			if (cmd.v_opts.encoding.level < 1 || cmd.v_opts.encoding.level > 9) {
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{"vtk compression level must be between 1 and 9"});
+			}
+		}
+		
+		cmd.v_opts.encoding.raw_appended = (vm.count("vtk-raw-appended") > 0);
+		
+		if (vm.count("cells")) {
+			std::string kind = vm["cells"].as<std::string>();
+			
+			if (boost::iequals(kind, "all")) {
+				cmd.v_opts.selection.kind = vtk_cell_kind::all;
+			} else if (boost::iequals(kind, "volume")) {
+				cmd.v_opts.selection.kind = vtk_cell_kind::volume;
+			} else if (boost::iequals(kind, "surface")) {
+				cmd.v_opts.selection.kind = vtk_cell_kind::surface;
+			} else {
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{
+					(boost::format("cells %s are unknown / not supported") % kind).str()
+				});
+			}
+		}
+		
+		if (vm.count("boundary-markers")) {
+			for(auto const& list : vm["boundary-markers"].as< std::vector<std::string> >()) {
+				std::vector<std::string> markers;
+				boost::split(markers, list, boost::is_any_of(","));
+				for(auto const& marker : markers) {
+					try {
+						cmd.v_opts.selection.boundary_markers.push_back(
+							boost::lexical_cast<int>(boost::trim_copy(marker)));
+					} catch (boost::bad_lexical_cast const&) {
+						BOOST_THROW_EXCEPTION(bpo::invalid_option_value{
+							(boost::format("boundary marker %s is not an integer") % marker).str()
+						});
+					}
+				}
+			}
+		}
+		
+		cmd.v_opts.benchmark = (vm.count("benchmark") > 0);
+		
 		return cmd;
 	} else if (cmd == "pca") {
 		bpo::options_description cmd_options("pca options");
@@ -340,7 +456,7 @@ parse_options(int argc, char *argv[]) {
 			(
 				"backend",
 				bpo::value<std::string>()->value_name("NAME"),
-				"pca implementation to use, currently MATLAB_LAPACK, ELEMENTAL_OPENMP and ELEMENTAL_MPI are supported"
+				"pca implementation to use, currently MATLAB_LAPACK, ELEMENTAL_OPENMP, ELEMENTAL_MPI and RANDOMIZED are supported"
 			)
 			(
 				"pcs",
@@ -359,6 +475,62 @@ parse_options(int argc, char *argv[]) {
 				"keep-centered",
 				"do not re-add variable means to pca-filtered data matrix"
 			)
+			(
+				"rank",
+				bpo::value<std::size_t>()->value_name("K"),
+				"number of leading principal components computed by RANDOMIZED backend or kept in the svd state by "
+				"--update, principal components with higher numbers are not available for selection with --pcs"
+			)
+			(
+				"oversampling",
+				bpo::value<std::size_t>()->value_name("P"),
+				"number of additional random samples used by RANDOMIZED backend, defaults to 10"
+			)
+			(
+				"power-iterations",
+				bpo::value<std::size_t>()->value_name("Q"),
+				"number of power iterations done by RANDOMIZED backend to improve accuracy, defaults to 2"
+			)
+			(
+				"process-grid",
+				bpo::value<std::string>()->value_name("RxC"),
+				"shape of the 2d process grid which data is scattered to for the svd of pca backend ELEMENTAL_MPI, "
+				"e.g. \"4x8\" for 4 process rows and 8 process columns, R*C has to equal the number of processes. "
+				"Defaults to a nearly square grid"
+			)
+			(
+				"streaming",
+				"read blocks of points instead of whole files and compute pca from gram matrix (method of snapshots), "
+				"so memory scales with the number of time steps instead of the size of the data matrix, requires Elemental"
+			)
+			(
+				"update",
+				"fold time steps which have not been processed before into the svd state stored in the output folder "
+				"(Brand's incremental svd) and write pca-filtered files of the new time steps and stats, so only new "
+				"files are read and written. Starts from scratch if no state exists, requires Elemental"
+			)
+			(
+				"block-size",
+				bpo::value<std::size_t>()->value_name("POINTS"),
+				"number of points read from each file at once if --streaming is given, overrides --block-memory"
+			)
+			(
+				"block-memory",
+				bpo::value<std::size_t>()->value_name("MIB"),
+				"memory in MiB available for a block of points of all time steps and its pca-filtered copies if "
+				"--streaming is given, the number of points per block is derived from it. Defaults to 256"
+			)
+			(
+				"modes",
+				"write spatial modes, means, scales and temporal coefficients of the principal components within --pcs "
+				"to PREFIX.modes.* files instead of pca-filtered *.pval.* files, see commands reconstruct and project. "
+				"Requires pca backend ELEMENTAL_MPI or RANDOMIZED"
+			)
+			(
+				"topology-file",
+				"if distributed, write global ids of points once per domain to OUTPUT-PREFIX.topology.* files which are "
+				"referenced by all pca-filtered *.pval.* files instead of storing them in each file"
+			)
 			;
 		
 		bpo::parsed_options unreg_parsed = bpo::command_line_parser(unreg_opts).options(cmd_options).run();
@@ -414,13 +586,24 @@ parse_options(int argc, char *argv[]) {
 						(boost::format("pca backend %s was not enabled during build") % backend).str()
 					});
 				#endif
+			} else if (boost::iequals(backend, "RANDOMIZED")) {
+				#ifdef HBRS_MPL_ENABLE_ELEMENTAL
+					cmd.pca_opts.backend = pca_backend::randomized;
+				#else
+					BOOST_THROW_EXCEPTION(bpo::invalid_option_value{
+						(boost::format("pca backend %s was not enabled during build") % backend).str()
+					});
+				#endif
 			} else {
 				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{
 					(boost::format("pca backend %s is unknown / not supported") % backend).str()
 				});
 			}
 			
-			if (mpi::comm_size() > 1 && cmd.pca_opts.backend != pca_backend::elemental_mpi) {
+			if (mpi::comm_size() > 1 &&
+				cmd.pca_opts.backend != pca_backend::elemental_mpi &&
+				cmd.pca_opts.backend != pca_backend::randomized
+			) {
 				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{
 					(boost::format("Running with %d processes, but pca backend %s is single process only. Use ELEMENTAL_MPI instead!") % mpi::comm_size() % backend).str()
 				});
@@ -433,9 +616,240 @@ parse_options(int argc, char *argv[]) {
 			cmd.pca_opts.pc_nr_seqs = vm["pcs"].as< std::vector<std::string> >();
 		}
 		
+		if (cmd.pca_opts.backend == pca_backend::randomized) {
+			if (!vm.count("rank")) {
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{"pca backend RANDOMIZED requires --rank"});
+			}
+			
+			cmd.pca_opts.rank = vm["rank"].as<std::size_t>();
+			if (cmd.pca_opts.rank == 0) {
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{"rank must be greater than zero"});
+			}
+			
+			if (vm.count("oversampling")) {
+				cmd.pca_opts.oversampling = vm["oversampling"].as<std::size_t>();
+			}
+			
+			if (vm.count("power-iterations")) {
+				cmd.pca_opts.power_iterations = vm["power-iterations"].as<std::size_t>();
+			}
+		} else if (vm.count("oversampling") || vm.count("power-iterations")) {
+			BOOST_THROW_EXCEPTION(bpo::invalid_option_value{
+				"--oversampling and --power-iterations require pca backend RANDOMIZED"
+			});
+		} else if (vm.count("rank")) {
+			if (!vm.count("update")) {
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{"--rank requires pca backend RANDOMIZED or --update"});
+			}
+			
+			cmd.pca_opts.rank = vm["rank"].as<std::size_t>();
+			if (cmd.pca_opts.rank == 0) {
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{"rank must be greater than zero"});
+			}
+		}
+		
+		if (vm.count("process-grid")) {
+			if (cmd.pca_opts.backend != pca_backend::elemental_mpi) {
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{"--process-grid requires pca backend ELEMENTAL_MPI"});
+			}
+			
+			std::string grid = vm["process-grid"].as<std::string>();
+			std::vector<std::string> dims;
+			boost::split(dims, grid, boost::is_any_of("xX"));
+			
+			std::size_t height = 0, width = 0;
+			if (dims.size() != 2 ||
+				!boost::conversion::try_lexical_convert(dims[0], height) ||
+				!boost::conversion::try_lexical_convert(dims[1], width) ||
+				height == 0 || width == 0
+			) {
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{
+					(boost::format("process grid %s is not of form RxC") % grid).str()
+				});
+			}
+			
+			if (height * width != boost::numeric_cast<std::size_t>(mpi::comm_size())) {
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{
+					(boost::format("process grid %s does not match the number of processes %d") % grid % mpi::comm_size()).str()
+				});
+			}
+			
+			cmd.pca_opts.grid_height = height;
+		}
+		
 		cmd.pca_opts.center = (vm.count("center") > 0);
 		cmd.pca_opts.normalize = (vm.count("normalize") > 0);
 		cmd.pca_opts.keep_centered = (vm.count("keep-centered") > 0);
+		cmd.pca_opts.streaming = (vm.count("streaming") > 0);
+		
+		if (cmd.pca_opts.streaming) {
+			#ifndef HBRS_MPL_ENABLE_ELEMENTAL
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{
+					"streaming pca requires Elemental which was not enabled during build"
+				});
+			#endif
+		}
+		
+		cmd.pca_opts.update = (vm.count("update") > 0);
+		
+		if (cmd.pca_opts.update) {
+			#ifndef HBRS_MPL_ENABLE_ELEMENTAL
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{
+					"incremental pca requires Elemental which was not enabled during build"
+				});
+			#endif
+			
+			if (cmd.pca_opts.streaming) {
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{"--update and --streaming are mutually exclusive"});
+			}
+		}
+		
+		if (vm.count("block-size")) {
+			cmd.pca_opts.block_size = vm["block-size"].as<std::size_t>();
+			
+			if (cmd.pca_opts.block_size == 0) {
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{"block size must be greater than zero"});
+			}
+		}
+		
+		if (vm.count("block-memory")) {
+			std::size_t const mib = vm["block-memory"].as<std::size_t>();
+			
+			if (mib == 0) {
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{"block memory must be greater than zero"});
+			}
+			cmd.pca_opts.block_memory = mib << 20;
+		}
+		
+		if (cmd.pca_opts.grid_height > 0 && (cmd.pca_opts.streaming || cmd.pca_opts.update)) {
+			BOOST_THROW_EXCEPTION(bpo::invalid_option_value{"--process-grid cannot be combined with --streaming or --update"});
+		}
+		
+		cmd.pca_opts.modes = (vm.count("modes") > 0);
+		
+		if (cmd.pca_opts.modes) {
+			if (cmd.pca_opts.streaming || cmd.pca_opts.update) {
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{"--modes cannot be combined with --streaming or --update"});
+			}
+			
+			if (cmd.pca_opts.backend != pca_backend::elemental_mpi && cmd.pca_opts.backend != pca_backend::randomized) {
+				BOOST_THROW_EXCEPTION(bpo::invalid_option_value{"--modes requires pca backend ELEMENTAL_MPI or RANDOMIZED"});
+			}
+		}
+		
+		cmd.pca_opts.topology_file = (vm.count("topology-file") > 0);
+		
+		if (cmd.pca_opts.topology_file && cmd.pca_opts.modes) {
+			BOOST_THROW_EXCEPTION(bpo::invalid_option_value{"--topology-file cannot be combined with --modes"});
+		}
+		
+		return cmd;
+	} else if (cmd == "reconstruct") {
+		bpo::options_description cmd_options("reconstruct options");
+		cmd_options.add(make_theta_input_options()).add(make_theta_output_options()).add_options()
+			(
+				"pcs",
+				bpo::value< std::vector<std::string> >()->multitoken()->value_name("SELECTIONS"),
+				"include only principal components within SELECTIONS, e.g. \"0\", \"0,1,2\", \"0-2,6-8\", \"first\" (equal to \"0\"), \"last\" or \"none\". "
+				"Only principal components stored in PREFIX.modes.* files are available. Multiple listings are possible."
+			)
+			(
+				"steps",
+				bpo::value< std::string >()->value_name("SELECTION"),
+				"write only time steps within SELECTION, e.g. \"100\", \"100-200,400\" or \"100-last\", defaults to all time steps"
+			)
+			(
+				"keep-centered",
+				"do not re-add variable means to pca-filtered data"
+			)
+			;
+		
+		bpo::parsed_options unreg_parsed = bpo::command_line_parser(unreg_opts).options(cmd_options).run();
+		bpo::store(unreg_parsed, vm);
+		
+		unreg_opts = bpo::collect_unrecognized(unreg_parsed.options, bpo::include_positional);
+		if (!unreg_opts.empty()) {
+			BOOST_THROW_EXCEPTION(bpo::unknown_option{unreg_opts.front()});
+		}
+		
+		if (vm.count("help")) {
+			bpo::options_description visible;
+			visible.add(generic).add(misc).add(cmd_options);
+			
+			std::stringstream help;
+			help
+				<< "Usage: " << exe.filename().string() << " [generic/misc-options] reconstruct [reconstruct-options]" << std::endl
+				<< visible;
+			return help_cmd{g_opts, help.str()};
+		}
+		
+		reconstruct_cmd cmd;
+		cmd.g_opts = g_opts;
+		cmd.i_opts = parse_theta_input_options(vm);
+		cmd.o_opts = parse_theta_output_options(cmd.i_opts, vm);
+		
+		if (vm.count("pcs")) {
+			cmd.r_opts.pc_nr_seqs = vm["pcs"].as< std::vector<std::string> >();
+		}
+		
+		if (vm.count("steps")) {
+			cmd.r_opts.step_nr_seqs = { vm["steps"].as<std::string>() };
+		}
+		
+		cmd.r_opts.keep_centered = (vm.count("keep-centered") > 0);
+		
+		return cmd;
+	} else if (cmd == "project") {
+		bpo::options_description cmd_options("project options");
+		cmd_options.add(make_theta_input_options()).add(make_theta_output_options()).add_options()
+			(
+				"model-path",
+				bpo::value< std::string >()->value_name("PATH"),
+				"directory path to PREFIX.modes.* files written by pca with option --modes, defaults to value of --path"
+			)
+			(
+				"model-prefix",
+				bpo::value< std::string >()->value_name("PREFIX"),
+				"project time steps onto the principal components stored in PREFIX.modes.* files. The temporal "
+				"coefficients are written to OUTPUT-PREFIX.modes.* files which can be passed to command reconstruct"
+			)
+			;
+		
+		bpo::parsed_options unreg_parsed = bpo::command_line_parser(unreg_opts).options(cmd_options).run();
+		bpo::store(unreg_parsed, vm);
+		
+		unreg_opts = bpo::collect_unrecognized(unreg_parsed.options, bpo::include_positional);
+		if (!unreg_opts.empty()) {
+			BOOST_THROW_EXCEPTION(bpo::unknown_option{unreg_opts.front()});
+		}
+		
+		if (vm.count("help")) {
+			bpo::options_description visible;
+			visible.add(generic).add(misc).add(cmd_options);
+			
+			std::stringstream help;
+			help
+				<< "Usage: " << exe.filename().string() << " [generic/misc-options] project [project-options]" << std::endl
+				<< visible;
+			return help_cmd{g_opts, help.str()};
+		}
+		
+		project_cmd cmd;
+		cmd.g_opts = g_opts;
+		cmd.i_opts = parse_theta_input_options(vm);
+		cmd.o_opts = parse_theta_output_options(cmd.i_opts, vm);
+		
+		if (vm.count("model-path")) {
+			cmd.p_opts.model_path = vm["model-path"].as<std::string>();
+		} else {
+			cmd.p_opts.model_path = cmd.i_opts.path;
+		}
+		
+		if (vm.count("model-prefix")) {
+			cmd.p_opts.model_prefix = vm["model-prefix"].as<std::string>();
+		} else {
+			BOOST_THROW_EXCEPTION(bpo::required_option{"model-prefix"});
+		}
 		
 		return cmd;
 	}